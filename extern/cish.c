@@ -1,4 +1,5 @@
 #include <stdlib.h>
+#include <string.h>
 #include "cish.h"
 
 #define PANIC(OBJ, ERROR){ OBJ->last_err = ERROR; return 0; }
@@ -15,40 +16,83 @@ int ffi_include_func(ffi_t* ffi_table, foreign_func func) {
 	return 1;
 }
 
-heap_alloc_t* machine_alloc(machine_t* machine, uint16_t req_size, int child_is_reftype) {
-#define CHECK_HEAP_COUNT if(machine->heap_count == UINT16_MAX) \
+//must lay objects out exactly like the interpreter's machine_alloc, since it frees and recycles them
+static size_t heap_alloc_size(uint32_t capacity, int trace_bits) {
+	return sizeof(heap_alloc_t) + (size_t)capacity * sizeof(machine_reg_t) + HEAP_BIT_WORDS(capacity) * (trace_bits ? 2 : 1) * sizeof(uint64_t);
+}
+
+heap_alloc_t* machine_alloc(machine_t* machine, uint64_t req_size, gc_trace_mode_t trace_mode) {
+#define CHECK_HEAP_COUNT if(machine->heap_count == UINT32_MAX) \
 							PANIC(machine, ERROR_MEMORY); \
 						if (machine->heap_count == machine->alloced_heap_allocs) { \
-							heap_alloc_t** new_heap_allocs = realloc(machine->heap_allocs, (machine->alloced_heap_allocs += 100) * sizeof(heap_alloc_t*)); \
+							heap_alloc_t** new_heap_allocs = realloc(machine->heap_allocs, (machine->alloced_heap_allocs = machine->alloced_heap_allocs > UINT32_MAX / 2 ? UINT32_MAX : machine->alloced_heap_allocs * 2) * sizeof(heap_alloc_t*)); \
 							PANIC_ON_FAIL(new_heap_allocs, machine, ERROR_MEMORY); \
 							machine->heap_allocs = new_heap_allocs; \
 						}
 
-	heap_alloc_t* heap_alloc;
+	if (req_size > UINT32_MAX)
+		PANIC(machine, ERROR_MEMORY);
+
+	int trace_bits = trace_mode == GC_TRACE_MODE_SOME;
+	uint8_t room_flags = (trace_bits ? HEAP_ALLOC_TRACE_BITS : 0) | HEAP_ALLOC_INIT_BITS;
+	heap_alloc_t* heap_alloc = NULL;
 	if (machine->freed_heap_count) {
-		heap_alloc = machine->freed_heap_allocs[--machine->freed_heap_count];
-		if (!heap_alloc->reg_with_table) {
+		heap_alloc = machine->freed_heap_allocs[machine->freed_heap_count - 1];
+		int fits = heap_alloc->capacity >= req_size && (heap_alloc->flags & room_flags) == room_flags;
+		if (heap_alloc->flags & HEAP_ALLOC_REG_WITH_TABLE) {
+			if (fits)
+				machine->freed_heap_count--;
+			else
+				heap_alloc = NULL;
+		}
+		else {
+			machine->freed_heap_count--;
+			if (!fits || heap_alloc->capacity / 2 > req_size + 8) {
+				heap_alloc_t* resized = realloc(heap_alloc, heap_alloc_size(req_size, trace_bits));
+				if (!resized) {
+					free(heap_alloc);
+					PANIC(machine, ERROR_MEMORY);
+				}
+				heap_alloc = resized;
+				heap_alloc->capacity = req_size;
+				heap_alloc->flags = room_flags;
+			}
 			CHECK_HEAP_COUNT;
 			machine->heap_allocs[machine->heap_count++] = heap_alloc;
-			heap_alloc->reg_with_table = 1;
 		}
 	}
-	else {
-		heap_alloc = malloc(sizeof(heap_alloc_t));
+	int fresh = !heap_alloc;
+	if (!heap_alloc) {
+		heap_alloc = malloc(heap_alloc_size(req_size, trace_bits));
 		PANIC_ON_FAIL(heap_alloc, machine, ERROR_MEMORY);
 		CHECK_HEAP_COUNT;
 		machine->heap_allocs[machine->heap_count++] = heap_alloc;
-		heap_alloc->reg_with_table = 1;
+		heap_alloc->size_class = 0; //blocks from malloc, the interpreter's slab blocks never reach the freed list
+		heap_alloc->capacity = req_size;
+		heap_alloc->flags = room_flags;
 	}
-	heap_alloc->pre_freed = 0;
+
+	heap_alloc->flags = (heap_alloc->flags & (HEAP_ALLOC_TRACE_BITS | HEAP_ALLOC_INIT_BITS)) | HEAP_ALLOC_REG_WITH_TABLE;
 	heap_alloc->limit = req_size;
-	heap_alloc->gc_flag = 0;
-	heap_alloc->trace_mode = child_is_reftype ? GC_TRACE_MODE_ALL : GC_TRACE_MODE_NONE;
+	heap_alloc->trace_mode = trace_mode;
 	heap_alloc->type_sig = NULL;
-	PANIC_ON_FAIL(heap_alloc, machine, ERROR_MEMORY);
-	if (req_size) {
-		PANIC_ON_FAIL(heap_alloc->registers = malloc(req_size * sizeof(machine_reg_t)), machine, ERROR_MEMORY);
-		PANIC_ON_FAIL(heap_alloc->init_stat = calloc(req_size, sizeof(int)), machine, ERROR_MEMORY);
+	heap_alloc->registers = (machine_reg_t*)(heap_alloc + 1);
+	//trace bits, if the block has room for them, come before the init bits
+	uint64_t* bits = (uint64_t*)(heap_alloc->registers + heap_alloc->capacity);
+	if (trace_bits)
+		memset(bits, 0, HEAP_BIT_WORDS(req_size) * sizeof(uint64_t));
+	heap_alloc->init_stat = bits + (heap_alloc->flags & HEAP_ALLOC_TRACE_BITS ? HEAP_BIT_WORDS(heap_alloc->capacity) : 0);
+	memset(heap_alloc->init_stat, 0, HEAP_BIT_WORDS(req_size) * sizeof(uint64_t));
+
+	if (machine->gc_stats) {
+		uint_fast8_t bucket = 0;
+		while (bucket < GC_STATS_SIZE_BUCKETS - 1 && req_size >> bucket)
+			bucket++;
+		machine->gc_stats->allocs_by_size[bucket]++;
+		if (fresh)
+			machine->gc_stats->fresh_blocks++;
+		else
+			machine->gc_stats->recycled_blocks++;
 	}
 	return heap_alloc;
 #undef CHECK_HEAP_COUNT
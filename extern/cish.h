@@ -26,17 +26,30 @@ typedef enum gc_trace_mode {
 	GC_TRACE_MODE_SOME
 } gc_trace_mode_t;
 
+#define HEAP_ALLOC_GC_FLAG 1
+#define HEAP_ALLOC_REG_WITH_TABLE 2
+#define HEAP_ALLOC_PRE_FREED 4
+#define HEAP_ALLOC_RESIZED 8
+#define HEAP_ALLOC_TRACE_BITS 16
+#define HEAP_ALLOC_INIT_BITS 32
+#define HEAP_ALLOC_INC_MARK 64
+
+//registers and init bits live in the same block as the header, use the HEAP_BIT macros to read and set init bits
+//records the compiler proves are fully initialized have no init bits, and a NULL init_stat
 typedef struct machine_heap_alloc {
 	machine_reg_t* registers;
-	int* init_stat, * trace_stat;
-	uint16_t limit;
-
-	int gc_flag, reg_with_table, pre_freed;
-	gc_trace_mode_t trace_mode;
-
+	uint64_t* init_stat;
 	void* type_sig;
+
+	uint32_t limit, capacity;
+	uint8_t flags, trace_mode, size_class;
 } heap_alloc_t;
 
+#define HEAP_BIT_WORDS(COUNT) (((uint64_t)(COUNT) + 63) / 64)
+#define HEAP_BIT(BITS, INDEX) (((BITS)[(INDEX) / 64] >> ((INDEX) % 64)) & 1)
+#define HEAP_SET_BIT(BITS, INDEX) ((BITS)[(INDEX) / 64] |= UINT64_C(1) << ((INDEX) % 64))
+#define HEAP_IS_INIT(ALLOC, INDEX) (!(ALLOC)->init_stat || HEAP_BIT((ALLOC)->init_stat, INDEX))
+
 typedef union machine_register {
 	heap_alloc_t* heap_alloc;
 	int64_t long_int;
@@ -89,16 +102,31 @@ typedef enum error {
 	ERROR_CANNOT_OPEN_FILE
 } error_t;
 
+#define GC_STATS_SIZE_BUCKETS 16
+#define GC_STATS_DEPTH_BUCKETS 16
+
+//gathered by the interpreter when ran with -gcstats, see machine.h
+typedef struct machine_gc_stats {
+	uint64_t allocs_by_size[GC_STATS_SIZE_BUCKETS];
+	uint64_t recycled_blocks, fresh_blocks;
+
+	uint64_t cleans_by_depth[GC_STATS_DEPTH_BUCKETS];
+	uint64_t traced, swept, freed, survived;
+	uint32_t reset_high_water;
+
+	uint64_t collections, total_collection_ns, max_collection_ns;
+} machine_gc_stats_t;
+
 typedef struct machine {
 	machine_reg_t* stack;
 
 	void** positions;
 
 	heap_alloc_t** heap_allocs;
-	uint16_t* heap_frame_bounds;
+	uint32_t* heap_frame_bounds;
 
 	heap_alloc_t** heap_traces;
-	uint16_t* trace_frame_bounds;
+	uint32_t* trace_frame_bounds;
 	heap_alloc_t** reset_stack;
 
 	heap_alloc_t** freed_heap_allocs;
@@ -106,8 +134,8 @@ typedef struct machine {
 	uint64_t last_err_ip;
 	error_t last_err;
 
-	uint16_t global_offset, position_count, heap_frame, frame_limit,
-		heap_count, alloced_heap_allocs,
+	uint32_t global_offset, position_count, heap_frame, frame_limit, max_frame_limit;
+	uint32_t heap_count, alloced_heap_allocs,
 		trace_count, alloced_trace_allocs,
 		freed_heap_count, alloc_freed_heaps,
 		reset_count, alloced_reset;
@@ -119,9 +147,11 @@ typedef struct machine {
 
 	void* defined_signatures;
 	uint16_t defined_sig_count, alloced_sig_defs;
+
+	machine_gc_stats_t* gc_stats;
 } machine_t;
 
 int ffi_include_func(ffi_t* ffi_table, foreign_func func);
-heap_alloc_t* machine_alloc(machine_t* machine, uint16_t req_size, int child_is_reftype);
+heap_alloc_t* machine_alloc(machine_t* machine, uint64_t req_size, gc_trace_mode_t trace_mode);
 
 #endif // !CISH_H
\ No newline at end of file
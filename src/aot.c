@@ -0,0 +1,512 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "error.h"
+#include "type.h"
+#include "aot.h"
+
+#define NATIVE_FRAME_SIZE 256 //native stack set aside per Cish call, about twice the largest frame gcc -Ofast gives a procedure
+
+#define DECLOP(OPCODE) "MACHINE_OP_CODE_" #OPCODE,
+static const char* op_code_names[] = {
+	MACHINE_OP_CODES(DECLOP)
+};
+#undef DECLOP
+
+static const char* prelude =
+	"#include <stdlib.h>\n"
+	"#include <stdio.h>\n"
+	"#include <string.h>\n"
+	"#include <math.h>\n"
+	"#include <inttypes.h>\n"
+	"#include \"machine.h\"\n"
+	"#include \"stdlibf.h\"\n"
+	"#include \"debug.h\"\n"
+	"#include \"type.h\"\n"
+	"\n"
+	"#define PANIC_AT(ERR, IP) { machine->last_err = ERR; machine->last_err_ip = IP; return 0; }\n"
+	"#define FALLBACK(IP) if (!fallback(machine, IP)) return 0;\n"
+	"#define FINISH { finished = 1; return 0; }\n"
+	"#define RETURN { machine->position_count--; return 1; }\n"
+	"#define CALL_PROC(PROC, OFFSET, IP) { \\\n"
+	"\tif (machine->position_count == machine->frame_limit && !machine_grow_frames(machine)) PANIC_AT(machine->last_err, IP); \\\n"
+	"\tchar native_top; \\\n"
+	"\tif (&native_top < native_stack_limit) PANIC_AT(ERROR_STACK_OVERFLOW, IP); \\\n"
+	"\tmachine->positions[machine->position_count++] = &instructions[IP]; \\\n"
+	"\tmachine->global_offset += OFFSET; \\\n"
+	"\tif (!PROC(machine)) return 0; \\\n"
+	"\tframe = stack + machine->global_offset; }\n"
+	"#define CALL(TARGET, OFFSET, IP) { machine_ins_t* target = (TARGET).ip; CALL_PROC(procs[target - instructions], OFFSET, IP) }\n"
+	"#define CALL_DIRECT(TARGET, OFFSET, IP) CALL_PROC(proc##TARGET, OFFSET, IP)\n"
+	"#define TAIL_CALL(OFFSET, COUNT) memmove(&frame[1], &frame[(OFFSET) + 1], (COUNT) * sizeof(machine_reg_t));\n"
+	"#define LOAD_ALLOC(ARRAY, INDEX, DEST, BOUNDED, IP) { \\\n"
+	"\theap_alloc_t* array = ARRAY; \\\n"
+	"\tint64_t index = INDEX; \\\n"
+	"\tif (BOUNDED && (index < 0 || index >= array->limit)) PANIC_AT(ERROR_INDEX_OUT_OF_RANGE, IP); \\\n"
+	"\tif (!HEAP_BIT(array->init_stat, index)) PANIC_AT(ERROR_READ_UNINIT, IP); \\\n"
+	"\tDEST = array->registers[index]; }\n"
+	"#define STORE_ALLOC(ARRAY, INDEX, VALUE, BOUNDED, IP) { \\\n"
+	"\theap_alloc_t* array = ARRAY; \\\n"
+	"\tint64_t index = INDEX; \\\n"
+	"\tmachine_reg_t value = VALUE; \\\n"
+	"\tif (BOUNDED && (index < 0 || index >= array->limit)) PANIC_AT(ERROR_INDEX_OUT_OF_RANGE, IP); \\\n"
+	"\tarray->registers[index] = value; \\\n"
+	"\tHEAP_SET_BIT(array->init_stat, index); }\n"
+	"\n"
+	"static int finished = 0;\n"
+	"static char* native_stack_limit; //calls deeper than the frames the native stack was sized for overflow here rather than past its end\n"
+	"\n"
+	"static int64_t longpow(int64_t base, int64_t exp) {\n"
+	"\tint64_t result = 1;\n"
+	"\tfor (;;) {\n"
+	"\t\tif (exp & 1)\n"
+	"\t\t\tresult *= base;\n"
+	"\t\texp >>= 1;\n"
+	"\t\tif (!exp)\n"
+	"\t\t\tbreak;\n"
+	"\t\tbase *= base;\n"
+	"\t}\n"
+	"\treturn result;\n"
+	"}\n"
+	"\n";
+
+#define TEMPLATE1(OPCODE, TEMPLATE) case MACHINE_OP_CODE_##OPCODE##_L ... MACHINE_OP_CODE_##OPCODE##_G: *variant = op_code - MACHINE_OP_CODE_##OPCODE##_L; return TEMPLATE;
+#define TEMPLATE2(OPCODE, TEMPLATE) case MACHINE_OP_CODE_##OPCODE##_LL ... MACHINE_OP_CODE_##OPCODE##_GG: *variant = op_code - MACHINE_OP_CODE_##OPCODE##_LL; return TEMPLATE;
+#define TEMPLATE3(OPCODE, TEMPLATE) case MACHINE_OP_CODE_##OPCODE##_LLL ... MACHINE_OP_CODE_##OPCODE##_GGG: *variant = op_code - MACHINE_OP_CODE_##OPCODE##_LLL; return TEMPLATE;
+
+//%A, %B and %C expand to an operand's register, %a, %b and %c to the raw operand, %i to the instruction's index. Instructions without a template run through machine_execute
+static const char* get_template(machine_op_code_t op_code, int* variant) {
+	*variant = 0;
+	switch (op_code) {
+	case MACHINE_OP_CODE_JUMP:
+		return "goto ins%a;";
+	TEMPLATE1(JUMP_CHECK, "if (!%A.bool_flag) goto ins%b;")
+	TEMPLATE1(CALL, "CALL(%A, %b, %i);")
+	case MACHINE_OP_CODE_CALL_DIRECT:
+		return "CALL_DIRECT(%a, %b, %i);";
+	case MACHINE_OP_CODE_TAIL_CALL: //the callee's body is emitted into the caller, so self recursion becomes a loop
+		return "TAIL_CALL(%b, %c); goto ins%a;";
+	case MACHINE_OP_CODE_RETURN:
+		return "RETURN;";
+	case MACHINE_OP_CODE_STACK_VALIDATE:
+		return "if ((uint64_t)machine->global_offset + %a >= machine->stack_size && !machine_grow_stack(machine, (uint64_t)machine->global_offset + %a + 1)) PANIC_AT(machine->last_err, %i);";
+	TEMPLATE1(LABEL, "%A.ip = &instructions[%b];")
+	case MACHINE_OP_CODE_STACK_OFFSET:
+		return "frame = stack + (machine->global_offset += %a);";
+	case MACHINE_OP_CODE_STACK_DEOFFSET:
+		return "frame = stack + (machine->global_offset -= %a);";
+
+	TEMPLATE2(MOVE, "%A = %B;")
+	TEMPLATE3(LOAD_ALLOC, "LOAD_ALLOC(%A.heap_alloc, %B.long_int, %C, 1, %i);")
+	TEMPLATE2(LOAD_ALLOC_I, "LOAD_ALLOC(%A.heap_alloc, %c, %B, 0, %i);")
+	TEMPLATE2(LOAD_ALLOC_I_BOUND, "LOAD_ALLOC(%A.heap_alloc, %c, %B, 1, %i);")
+	TEMPLATE3(STORE_ALLOC, "STORE_ALLOC(%A.heap_alloc, %B.long_int, %C, 1, %i);")
+	TEMPLATE2(STORE_ALLOC_I, "STORE_ALLOC(%A.heap_alloc, %c, %B, 0, %i);")
+	TEMPLATE2(STORE_ALLOC_I_BOUND, "STORE_ALLOC(%A.heap_alloc, %c, %B, 1, %i);")
+	TEMPLATE3(LOAD_ALLOC_UNCHECKED, "LOAD_ALLOC(%A.heap_alloc, %B.long_int, %C, 0, %i);")
+	TEMPLATE3(STORE_ALLOC_UNCHECKED, "STORE_ALLOC(%A.heap_alloc, %B.long_int, %C, 0, %i);")
+	TEMPLATE2(LOAD_ALLOC_I_INIT, "%B = %A.heap_alloc->registers[%c];")
+	TEMPLATE2(STORE_ALLOC_I_INIT, "%A.heap_alloc->registers[%c] = %B;")
+	TEMPLATE1(ALLOC_I_INIT, "if (!(%A.heap_alloc = machine_alloc_initialized(machine, %b, %c))) PANIC_AT(machine->last_err, %i);")
+	TEMPLATE1(CONF_INIT_ALL, "{ uint64_t* init_stat = %A.heap_alloc->init_stat; memset(init_stat, 0xFF, (%b / 64) * sizeof(uint64_t)); if (%b %% 64) init_stat[%b / 64] |= (UINT64_C(1) << (%b %% 64)) - 1; }")
+
+	TEMPLATE3(AND, "%C.bool_flag = %A.bool_flag && %B.bool_flag;")
+	TEMPLATE3(OR, "%C.bool_flag = %A.bool_flag || %B.bool_flag;")
+	TEMPLATE2(NOT, "%A.bool_flag = !%B.bool_flag;")
+	TEMPLATE2(LENGTH, "%A.long_int = %B.heap_alloc->limit;")
+
+	TEMPLATE3(PTR_EQUAL, "%C.bool_flag = %A.ip == %B.ip;")
+	TEMPLATE3(BOOL_EQUAL, "%C.bool_flag = %A.bool_flag == %B.bool_flag;")
+	TEMPLATE3(CHAR_EQUAL, "%C.bool_flag = %A.char_int == %B.char_int;")
+	TEMPLATE3(LONG_EQUAL, "%C.bool_flag = %A.long_int == %B.long_int;")
+	TEMPLATE3(FLOAT_EQUAL, "%C.bool_flag = %A.float_int == %B.float_int;")
+
+	TEMPLATE3(LONG_MORE, "%C.bool_flag = %A.long_int > %B.long_int;")
+	TEMPLATE3(LONG_LESS, "%C.bool_flag = %A.long_int < %B.long_int;")
+	TEMPLATE3(LONG_MORE_EQUAL, "%C.bool_flag = %A.long_int >= %B.long_int;")
+	TEMPLATE3(LONG_LESS_EQUAL, "%C.bool_flag = %A.long_int <= %B.long_int;")
+	TEMPLATE3(LONG_ADD, "%C.long_int = %A.long_int + %B.long_int;")
+	TEMPLATE3(LONG_SUBTRACT, "%C.long_int = %A.long_int - %B.long_int;")
+	TEMPLATE3(LONG_MULTIPLY, "%C.long_int = %A.long_int * %B.long_int;")
+	TEMPLATE3(LONG_DIVIDE, "{ uint64_t d = %B.long_int; if (!d) PANIC_AT(ERROR_DIVIDE_BY_ZERO, %i); %C.long_int = %A.long_int / d; }")
+	TEMPLATE3(LONG_MODULO, "%C.long_int = %A.long_int %% %B.long_int;")
+	TEMPLATE3(LONG_EXPONENTIATE, "%C.long_int = longpow(%A.long_int, %B.long_int);")
+
+	TEMPLATE3(FLOAT_MORE, "%C.bool_flag = %A.float_int > %B.float_int;")
+	TEMPLATE3(FLOAT_LESS, "%C.bool_flag = %A.float_int < %B.float_int;")
+	TEMPLATE3(FLOAT_MORE_EQUAL, "%C.bool_flag = %A.float_int >= %B.float_int;")
+	TEMPLATE3(FLOAT_LESS_EQUAL, "%C.bool_flag = %A.float_int <= %B.float_int;")
+	TEMPLATE3(FLOAT_ADD, "%C.float_int = %A.float_int + %B.float_int;")
+	TEMPLATE3(FLOAT_SUBTRACT, "%C.float_int = %A.float_int - %B.float_int;")
+	TEMPLATE3(FLOAT_MULTIPLY, "%C.float_int = %A.float_int * %B.float_int;")
+	TEMPLATE3(FLOAT_DIVIDE, "%C.float_int = %A.float_int / %B.float_int;")
+	TEMPLATE3(FLOAT_MODULO, "%C.float_int = fmod(%A.float_int, %B.float_int);")
+	TEMPLATE3(FLOAT_EXPONENTIATE, "%C.float_int = pow(%A.float_int, %B.float_int);")
+
+	TEMPLATE2(LONG_NEGATE, "%A.long_int = -%B.long_int;")
+	TEMPLATE2(FLOAT_NEGATE, "%A.float_int = -%B.float_int;")
+	TEMPLATE1(LONG_INCREMENT, "++%A.long_int;")
+	TEMPLATE1(LONG_DECREMENT, "--%A.long_int;")
+	TEMPLATE1(FLOAT_INCREMENT, "++%A.float_int;")
+	TEMPLATE1(FLOAT_DECREMENT, "--%A.float_int;")
+
+	TEMPLATE2(LONG_EQUAL_JUMP_CHECK, "if (!(%A.long_int == %B.long_int)) goto ins%c;")
+	TEMPLATE2(FLOAT_EQUAL_JUMP_CHECK, "if (!(%A.float_int == %B.float_int)) goto ins%c;")
+	TEMPLATE2(LONG_MORE_JUMP_CHECK, "if (!(%A.long_int > %B.long_int)) goto ins%c;")
+	TEMPLATE2(LONG_LESS_JUMP_CHECK, "if (!(%A.long_int < %B.long_int)) goto ins%c;")
+	TEMPLATE2(LONG_MORE_EQUAL_JUMP_CHECK, "if (!(%A.long_int >= %B.long_int)) goto ins%c;")
+	TEMPLATE2(LONG_LESS_EQUAL_JUMP_CHECK, "if (!(%A.long_int <= %B.long_int)) goto ins%c;")
+	TEMPLATE2(FLOAT_MORE_JUMP_CHECK, "if (!(%A.float_int > %B.float_int)) goto ins%c;")
+	TEMPLATE2(FLOAT_LESS_JUMP_CHECK, "if (!(%A.float_int < %B.float_int)) goto ins%c;")
+	TEMPLATE2(FLOAT_MORE_EQUAL_JUMP_CHECK, "if (!(%A.float_int >= %B.float_int)) goto ins%c;")
+	TEMPLATE2(FLOAT_LESS_EQUAL_JUMP_CHECK, "if (!(%A.float_int <= %B.float_int)) goto ins%c;")
+	TEMPLATE2(LONG_INCREMENT_LESS_JUMP, "if (++%A.long_int < %B.long_int) goto ins%c;")
+	TEMPLATE2(LONG_INCREMENT_LESS_EQUAL_JUMP, "if (++%A.long_int <= %B.long_int) goto ins%c;")
+	TEMPLATE2(LONG_DECREMENT_MORE_JUMP, "if (--%A.long_int > %B.long_int) goto ins%c;")
+	TEMPLATE2(LONG_DECREMENT_MORE_EQUAL_JUMP, "if (--%A.long_int >= %B.long_int) goto ins%c;")
+	TEMPLATE3(LOAD_ALLOC_LONG_ADD, "{ machine_reg_t element; LOAD_ALLOC(%A.heap_alloc, %B.long_int, element, 1, %i); %C.long_int += element.long_int; }")
+	TEMPLATE3(LOAD_ALLOC_FLOAT_ADD, "{ machine_reg_t element; LOAD_ALLOC(%A.heap_alloc, %B.long_int, element, 1, %i); %C.float_int += element.float_int; }")
+	default:
+		return NULL;
+	}
+}
+#undef TEMPLATE1
+#undef TEMPLATE2
+#undef TEMPLATE3
+
+//returns the number of instructions control may continue to, the first is the fallthrough if there is one
+static int get_successors(machine_ins_t* instructions, uint16_t ip, uint16_t* successors) {
+	machine_ins_t ins = instructions[ip];
+	switch (ins.op_code) {
+	case MACHINE_OP_CODE_ABORT:
+	case MACHINE_OP_CODE_RETURN:
+		return 0;
+	case MACHINE_OP_CODE_JUMP:
+	case MACHINE_OP_CODE_TAIL_CALL:
+		successors[0] = ins.a;
+		return 1;
+	case MACHINE_OP_CODE_JUMP_CHECK_L:
+	case MACHINE_OP_CODE_JUMP_CHECK_G:
+		successors[0] = ip + 1;
+		successors[1] = ins.b;
+		return 2;
+	case MACHINE_OP_CODE_LONG_EQUAL_JUMP_CHECK_LL ... MACHINE_OP_CODE_LONG_DECREMENT_MORE_EQUAL_JUMP_GG:
+		successors[0] = ip + 2;
+		successors[1] = ins.c;
+		return 2;
+	case MACHINE_OP_CODE_LOAD_ALLOC_LONG_ADD_LLL ... MACHINE_OP_CODE_LOAD_ALLOC_FLOAT_ADD_GGG:
+		successors[0] = ip + 2;
+		return 1;
+	default:
+		successors[0] = ip + 1;
+		return 1;
+	}
+}
+
+static int has_fallthrough(machine_op_code_t op_code) {
+	return op_code != MACHINE_OP_CODE_ABORT && op_code != MACHINE_OP_CODE_RETURN && op_code != MACHINE_OP_CODE_JUMP && op_code != MACHINE_OP_CODE_TAIL_CALL;
+}
+
+static void emit_operand(FILE* outfile, uint16_t reg, int global) {
+	fprintf(outfile, global ? "stack[%" PRIu16 "]" : "frame[%" PRIu16 "]", reg);
+}
+
+static void emit_template(FILE* outfile, const char* template, machine_ins_t ins, int variant, uint16_t ip) {
+	//the variant bits are stored with the last operand in bit 0
+	int operand_count = 0;
+	for (const char* current = template; *current; current++)
+		if (current[0] == '%' && current[1] >= 'A' && current[1] <= 'C' && current[1] - 'A' + 1 > operand_count)
+			operand_count = current[1] - 'A' + 1;
+
+	for (const char* current = template; *current; current++) {
+		if (*current != '%') {
+			fputc(*current, outfile);
+			continue;
+		}
+		current++;
+		switch (*current) {
+		case 'A':
+		case 'B':
+		case 'C': {
+			int operand = *current - 'A';
+			emit_operand(outfile, operand == 0 ? ins.a : (operand == 1 ? ins.b : ins.c), variant & (1 << (operand_count - 1 - operand)));
+			break;
+		}
+		case 'a':
+			fprintf(outfile, "%" PRIu16, ins.a);
+			break;
+		case 'b':
+			fprintf(outfile, "%" PRIu16, ins.b);
+			break;
+		case 'c':
+			fprintf(outfile, "%" PRIu16, ins.c);
+			break;
+		case 'i':
+			fprintf(outfile, "%" PRIu16, ip);
+			break;
+		default:
+			fputc(*current, outfile);
+			break;
+		}
+	}
+}
+
+static void emit_ins(FILE* outfile, machine_ins_t ins, uint16_t ip) {
+	int variant;
+	const char* template = get_template(ins.op_code, &variant);
+
+	if (ins.op_code == MACHINE_OP_CODE_ABORT) {
+		if (ins.a == ERROR_NONE)
+			fputs("FINISH;", outfile);
+		else
+			fprintf(outfile, "PANIC_AT(%" PRIu16 ", %" PRIu16 ");", ins.a, ip);
+	}
+	else if (ins.op_code == MACHINE_OP_CODE_SET_L && !ins.c)
+		fprintf(outfile, "frame[%" PRIu16 "].long_int = %" PRIu16 ";", ins.a, ins.b);
+	else if (template)
+		emit_template(outfile, template, ins, variant, ip);
+	else
+		fprintf(outfile, "FALLBACK(%" PRIu16 ");", ip);
+}
+
+//emits the code reachable from entry without following calls
+static int emit_proc(FILE* outfile, machine_ins_t* instructions, uint16_t instruction_count, uint16_t entry, uint8_t* reachable, uint8_t* labeled, uint16_t* worklist) {
+	memset(reachable, 0, instruction_count + 1);
+	memset(labeled, 0, instruction_count + 1);
+
+	uint32_t work_count = 0;
+	worklist[work_count++] = entry;
+	reachable[entry] = 1;
+	labeled[entry] = 1;
+	while (work_count) {
+		uint16_t ip = worklist[--work_count];
+		if (ip == instruction_count)
+			continue;
+
+		uint16_t successors[2];
+		int successor_count = get_successors(instructions, ip, successors);
+		for (int i = 0; i < successor_count; i++) {
+			ESCAPE_ON_FAIL(successors[i] <= instruction_count);
+			if (i > 0 || !has_fallthrough(instructions[ip].op_code))
+				labeled[successors[i]] = 1;
+			if (!reachable[successors[i]]) {
+				reachable[successors[i]] = 1;
+				worklist[work_count++] = successors[i];
+			}
+		}
+	}
+
+	//a fallthrough into code that isn't emitted right after needs a label and an explicit goto
+	uint16_t last = UINT16_MAX;
+	for (uint_fast32_t ip = 0; ip <= instruction_count; ip++) {
+		if (!reachable[ip])
+			continue;
+		if (last != UINT16_MAX && has_fallthrough(instructions[last].op_code)) {
+			uint16_t successors[2];
+			get_successors(instructions, last, successors);
+			if (successors[0] != ip)
+				labeled[successors[0]] = 1;
+		}
+		last = ip == instruction_count ? UINT16_MAX : ip;
+	}
+
+	fprintf(outfile, "static int proc%" PRIu16 "(machine_t* machine) {\n", entry);
+	fputs("\tmachine_reg_t* stack = machine->stack;\n\tmachine_reg_t* frame = stack + machine->global_offset;\n\tgoto ins", outfile);
+	fprintf(outfile, "%" PRIu16 ";\n", entry);
+
+	last = UINT16_MAX;
+	for (uint_fast32_t ip = 0; ip <= instruction_count; ip++) {
+		if (!reachable[ip])
+			continue;
+		if (last != UINT16_MAX && has_fallthrough(instructions[last].op_code)) {
+			uint16_t successors[2];
+			get_successors(instructions, last, successors);
+			if (successors[0] != ip)
+				fprintf(outfile, "\tgoto ins%" PRIu16 ";\n", successors[0]);
+		}
+		if (labeled[ip])
+			fprintf(outfile, "ins%" PRIuFAST32 ":\n", ip);
+		fputc('\t', outfile);
+		if (ip == instruction_count)
+			fputs("FINISH;", outfile);
+		else
+			emit_ins(outfile, instructions[ip], ip);
+		fputc('\n', outfile);
+		last = ip == instruction_count ? UINT16_MAX : ip;
+	}
+	if (last != UINT16_MAX && has_fallthrough(instructions[last].op_code)) {
+		uint16_t successors[2];
+		get_successors(instructions, last, successors);
+		fprintf(outfile, "\tgoto ins%" PRIu16 ";\n", successors[0]);
+	}
+	fputs("}\n\n", outfile);
+	return 1;
+}
+
+//emits an array of signatures after the arrays of their sub-types, and returns its id
+static uint32_t emit_type_sigs(FILE* outfile, machine_type_sig_t* type_sigs, uint16_t count, uint32_t* sig_arrays) {
+	uint32_t* sub_ids = malloc(count * sizeof(uint32_t));
+	if (!sub_ids)
+		return UINT32_MAX;
+	for (uint_fast16_t i = 0; i < count; i++)
+		if (type_sigs[i].super_signature != TYPE_TYPEARG && type_sigs[i].sub_type_count)
+			sub_ids[i] = emit_type_sigs(outfile, type_sigs[i].sub_types, type_sigs[i].sub_type_count, sig_arrays);
+
+	uint32_t id = (*sig_arrays)++;
+	fprintf(outfile, "static const machine_type_sig_t sigs%" PRIu32 "[] = {", id);
+	for (uint_fast16_t i = 0; i < count; i++) {
+		if (type_sigs[i].super_signature != TYPE_TYPEARG && type_sigs[i].sub_type_count)
+			fprintf(outfile, " { %" PRIu16 ", (machine_type_sig_t*)sigs%" PRIu32 ", %" PRIu8 " },", type_sigs[i].super_signature, sub_ids[i], type_sigs[i].sub_type_count);
+		else
+			fprintf(outfile, " { %" PRIu16 ", NULL, %" PRIu8 " },", type_sigs[i].super_signature, type_sigs[i].sub_type_count);
+	}
+	fputs(" };\n", outfile);
+	free(sub_ids);
+	return id;
+}
+
+static void emit_string(FILE* outfile, const char* str) {
+	fputc('"', outfile);
+	for (; *str; str++) {
+		if (*str == '"' || *str == '\\')
+			fputc('\\', outfile);
+		fputc(*str, outfile);
+	}
+	fputc('"', outfile);
+}
+
+int aot_save_c(const char* path, ast_t* ast, machine_t* machine, dbg_table_t* dbg_table, machine_ins_t* instructions, uint16_t instruction_count) {
+	uint8_t* reachable = malloc(instruction_count + 1);
+	uint8_t* labeled = malloc(instruction_count + 1);
+	uint8_t* is_entry = calloc(instruction_count + 1, sizeof(uint8_t));
+	uint16_t* worklist = malloc((instruction_count + 1) * 2 * sizeof(uint16_t));
+	FILE* outfile = fopen(path, "w");
+	if (!reachable || !labeled || !is_entry || !worklist || !outfile) {
+		free(reachable);
+		free(labeled);
+		free(is_entry);
+		free(worklist);
+		if (outfile)
+			fclose(outfile);
+		return 0;
+	}
+
+	//every label target is a procedure, along with the program's entry
+	is_entry[0] = 1;
+	for (uint_fast16_t i = 0; i < instruction_count; i++) {
+		if ((instructions[i].op_code == MACHINE_OP_CODE_LABEL_L || instructions[i].op_code == MACHINE_OP_CODE_LABEL_G) && instructions[i].b < instruction_count)
+			is_entry[instructions[i].b] = 1;
+		else if ((instructions[i].op_code == MACHINE_OP_CODE_CALL_DIRECT || instructions[i].op_code == MACHINE_OP_CODE_TAIL_CALL) && instructions[i].a < instruction_count)
+			is_entry[instructions[i].a] = 1;
+	}
+
+	fputs(prelude, outfile);
+
+	fprintf(outfile, "static machine_ins_t instructions[%" PRIu16 "] = {\n", instruction_count);
+	for (uint_fast16_t i = 0; i < instruction_count; i++)
+		fprintf(outfile, "\t{ %s, %" PRIu16 ", %" PRIu16 ", %" PRIu16 " },\n", op_code_names[instructions[i].op_code], instructions[i].a, instructions[i].b, instructions[i].c);
+	fputs("};\n\n", outfile);
+
+	uint32_t sig_arrays = 0;
+	uint32_t defined_sigs = UINT32_MAX;
+	if (machine->defined_sig_count) {
+		defined_sigs = emit_type_sigs(outfile, machine->defined_signatures, machine->defined_sig_count, &sig_arrays);
+		fputc('\n', outfile);
+	}
+
+	fputs("static dbg_src_loc_t src_locations[] = {\n", outfile);
+	for (uint_fast64_t i = 0; i < dbg_table->src_loc_count; i++) {
+		fprintf(outfile, "\t{ %i, %i, ", dbg_table->src_locations[i].row, dbg_table->src_locations[i].col);
+		emit_string(outfile, dbg_table->src_locations[i].file_name);
+		fprintf(outfile, ", UINT64_C(%" PRIu64 "), UINT64_C(%" PRIu64 "), %" PRIu32 " },\n", dbg_table->src_locations[i].min_ip, dbg_table->src_locations[i].max_ip, dbg_table->src_locations[i].inline_call);
+	}
+	fputs("\t{ 0, 0, NULL, 0, 0 }\n};\n\n", outfile);
+
+	for (uint_fast16_t i = 0; i < instruction_count; i++)
+		if (is_entry[i])
+			fprintf(outfile, "static int proc%" PRIuFAST16 "(machine_t* machine);\n", i);
+	fprintf(outfile, "\nstatic int (*procs[%" PRIu16 "])(machine_t* machine) = {\n", instruction_count);
+	for (uint_fast16_t i = 0; i < instruction_count; i++)
+		if (is_entry[i])
+			fprintf(outfile, "\t[%" PRIuFAST16 "] = proc%" PRIuFAST16 ",\n", i, i);
+	fputs("};\n\n", outfile);
+
+	fputs("static int fallback(machine_t* machine, uint16_t ip) {\n"
+		"\tmachine_ins_t ins[2] = { instructions[ip], { MACHINE_OP_CODE_ABORT, ERROR_NONE, 0, 0 } };\n"
+		"\tif (machine_execute(machine, ins, ins, 0))\n"
+		"\t\treturn 1;\n"
+		"\tmachine->last_err_ip = ip;\n"
+		"\treturn 0;\n"
+		"}\n\n", outfile);
+
+	for (uint_fast16_t i = 0; i < instruction_count; i++)
+		if (is_entry[i] && !emit_proc(outfile, instructions, instruction_count, i, reachable, labeled, worklist)) {
+			free(reachable);
+			free(labeled);
+			free(is_entry);
+			free(worklist);
+			fclose(outfile);
+			return 0;
+		}
+
+	fprintf(outfile, "#define NATIVE_FRAME_SIZE %i\n\n"
+		"static int run(machine_t* machine, void* arg) {\n"
+		"\tchar native_top;\n"
+		"\tnative_stack_limit = &native_top - (uint64_t)machine->max_frame_limit * NATIVE_FRAME_SIZE;\n"
+		"\treturn proc0(machine);\n"
+		"}\n\n", NATIVE_FRAME_SIZE);
+
+	fputs("int main(int argc, char* argv[]) {\n"
+		"\tmachine_t machine;\n", outfile);
+	fprintf(outfile, "\tdbg_table_t dbg_table = { .src_locations = src_locations, .src_loc_count = %" PRIu64 " };\n", dbg_table->src_loc_count);
+	fprintf(outfile, "\tif (!init_machine(&machine, %" PRIu32 ", %" PRIu32 ", %" PRIu8 ")) {\n"
+		"\t\tprintf(\"Failed to initialize the Cish runtime.\\n\");\n"
+		"\t\texit(EXIT_FAILURE);\n"
+		"\t}\n", machine->max_stack_size, machine->max_frame_limit, ast->record_count);
+	for (uint_fast16_t i = 0; i < ast->constant_count; i++)
+		fprintf(outfile, "\tmachine.stack[%" PRIuFAST16 "].long_int = (int64_t)UINT64_C(0x%016" PRIx64 ");\n", i, (uint64_t)machine->stack[i].long_int);
+	if (machine->defined_sig_count) {
+		fprintf(outfile, "\tfor (uint_fast16_t i = 0; i < %" PRIu16 "; i++) {\n"
+			"\t\tif (!machine_get_typesig(&machine, &sigs%" PRIu32 "[i], 0)) {\n"
+			"\t\t\tprintf(\"Failed to initialize the Cish runtime.\\n\");\n"
+			"\t\t\texit(EXIT_FAILURE);\n"
+			"\t\t}\n"
+			"\t}\n", machine->defined_sig_count, defined_sigs);
+	}
+	if (ast->record_count) {
+		fputs("\tstatic const uint16_t type_table[] = {", outfile);
+		for (uint_fast16_t i = 0; i < ast->record_count; i++)
+			fprintf(outfile, " %" PRIu16 ",", machine->type_table[i]);
+		fprintf(outfile, " };\n\tmemcpy(machine.type_table, type_table, sizeof(type_table));\n");
+	}
+	fputs("\tif (!install_stdlib(&machine)) {\n"
+		"\t\tprintf(\"Failed to install Cish standard native libraries.\\n\");\n"
+		"\t\texit(EXIT_FAILURE);\n"
+		"\t}\n"
+		"\tif (machine.alloced_sig_defs < machine.defined_sig_count + (machine.frame_limit / 4)) {\n"
+		"\t\tmachine_type_sig_t* new_sigs = realloc(machine.defined_signatures, sizeof(machine_type_sig_t) * (machine.alloced_sig_defs = machine.defined_sig_count + (machine.frame_limit / 4)));\n"
+		"\t\tif (!new_sigs) {\n"
+		"\t\t\tprintf(\"Runtime error(%s).\\n\", get_err_msg(ERROR_MEMORY));\n"
+		"\t\t\texit(EXIT_FAILURE);\n"
+		"\t\t}\n"
+		"\t\tmachine.defined_signatures = new_sigs;\n"
+		"\t}\n"
+		"\tmachine.last_err = ERROR_NONE;\n"
+		"\tif (!machine_run_native(&machine, NATIVE_FRAME_SIZE, run, NULL) && !finished) {\n"
+		"\t\tprint_back_trace(&machine, &dbg_table, instructions);\n"
+		"\t\tprintf(\"Last IP: %\" PRIu64 \"\\n\", machine.last_err_ip);\n"
+		"\t\tprintf(\"Runtime error(%s).\\n\", get_err_msg(machine.last_err));\n"
+		"\t\texit(EXIT_FAILURE);\n"
+		"\t}\n"
+		"\tfree_machine(&machine);\n"
+		"\texit(EXIT_SUCCESS);\n"
+		"}\n", outfile);
+
+	free(reachable);
+	free(labeled);
+	free(is_entry);
+	free(worklist);
+	fclose(outfile);
+	return 1;
+}
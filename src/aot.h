@@ -0,0 +1,13 @@
+#pragma once
+
+#ifndef AOT_H
+#define AOT_H
+
+#include "machine.h"
+#include "ast.h"
+#include "debug.h"
+
+//emits a C translation unit, with one function per procedure, that links against every runtime object but source.c
+int aot_save_c(const char* path, ast_t* ast, machine_t* machine, dbg_table_t* dbg_table, machine_ins_t* instructions, uint16_t instruction_count);
+
+#endif // !AOT_H
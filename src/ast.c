@@ -1,5 +1,6 @@
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include "hash.h"
 #include "error.h"
 #include "postproc.h"
@@ -93,6 +94,7 @@ static int ast_parser_decl_var(ast_parser_t* ast_parser, uint64_t id, ast_var_in
 	if (ast_parser_find_var(ast_parser, id))
 		PANIC(ast_parser, ERROR_REDECLARATION);
 	var_info->is_used = 0;
+	var_info->is_scalar_replaced = 0;
 	if (var_info->is_global) {
 		if (ast_parser->global_count == ast_parser->allocated_globals) {
 			ast_var_cache_entry_t* new_globals = safe_realloc(ast_parser->safe_gc, ast_parser->globals, (ast_parser->allocated_globals += 64) * sizeof(ast_var_cache_entry_t));
@@ -185,6 +187,7 @@ static ast_record_proto_t* ast_parser_decl_record(ast_parser_t* ast_parser, uint
 	new_rec->index_offset = 0;
 	new_rec->child_record_count = 0;
 	new_rec->linked = 0;
+	new_rec->do_gc = 0;
 	ast_parser->ast->record_protos[ast_parser->ast->record_count++] = new_rec;
 	return new_rec;
 }
@@ -321,6 +324,7 @@ static ast_record_prop_t* ast_record_decl_prop(ast_parser_t* ast_parser, ast_rec
 	ast_record_prop_t* next_prop = &record->properties[record->property_count];
 	next_prop->hash_id = id;
 	next_prop->id = record->property_count++;
+	next_prop->maybe_uninit = 0;
 	return next_prop;
 }
 
@@ -495,8 +499,8 @@ static int prim_value_comp(ast_primitive_t a, ast_primitive_t b) {
 		return a.data.character == b.data.character;
 	case AST_PRIMITIVE_LONG:
 		return a.data.long_int == b.data.long_int;
-	case AST_PRIMITIVE_FLOAT:
-		return a.data.float_int == b.data.float_int;
+	case AST_PRIMITIVE_FLOAT: //compared bitwise so folded -0f and nan constants are kept distinct
+		return !memcmp(&a.data.float_int, &b.data.float_int, sizeof(double));
 	}
 }
 
@@ -746,7 +750,9 @@ static int parse_if_else(ast_parser_t* ast_parser, ast_cond_t* conditional, int
 			ESCAPE_ON_FAIL(parse_if_else(ast_parser, conditional->next_if_false, in_loop))
 		else {
 			conditional->next_if_false->condition = NULL;
+			conditional->next_if_false->next_if_true = NULL; //folding a constant false head promotes this link to the head of the chain
 			conditional->next_if_false->next_if_false = NULL;
+			conditional->next_if_false->invariant_count = 0;
 			ESCAPE_ON_FAIL(ast_parser_new_frame(ast_parser, NULL, 1));
 			ESCAPE_ON_FAIL(parse_code_block(ast_parser, &conditional->next_if_false->exec_block, 1, in_loop));
 			conditional->next_if_false->scope_size = CURRENT_FRAME.scoped_locals;
@@ -756,6 +762,7 @@ static int parse_if_else(ast_parser_t* ast_parser, ast_cond_t* conditional, int
 	else
 		conditional->next_if_false = NULL;
 	conditional->next_if_true = NULL;
+	conditional->invariant_count = 0;
 	return 1;
 }
 
@@ -795,6 +802,7 @@ static int parse_statment(ast_parser_t* ast_parser, ast_statement_t* statement,
 		ESCAPE_ON_FAIL(ast_parser_close_frame(ast_parser));
 		statement->data.conditional->next_if_true = statement->data.conditional;
 		statement->data.conditional->next_if_false = NULL;
+		statement->data.conditional->invariant_count = 0;
 		goto no_check_semicolon;
 	case TOK_FOR: {
 		PANIC_ON_FAIL(code_block, ast_parser, ERROR_UNEXPECTED_TOK);
@@ -828,6 +836,7 @@ static int parse_statment(ast_parser_t* ast_parser, ast_statement_t* statement,
 
 		statement->data.conditional->next_if_true = statement->data.conditional;
 		statement->data.conditional->next_if_false = NULL;
+		statement->data.conditional->invariant_count = 0;
 		goto no_check_semicolon;
 	}
 	case TOK_FOREIGN:
@@ -1253,6 +1262,8 @@ static int parse_value(ast_parser_t* ast_parser, ast_value_t* value, typecheck_t
 				for (uint_fast8_t i = 0; i < current_proto->property_count; i++) {
 					if (!current_proto->properties[i].defer_init)
 						PANIC_ON_FAIL(overriden_defaults[current_proto->properties[i].id], ast_parser, ERROR_READ_UNINIT);
+					if (!overriden_defaults[current_proto->properties[i].id])
+						current_proto->properties[i].maybe_uninit = 1;
 				}
 				if (current_proto->base_record) {
 					typecheck_type_t next;
@@ -1316,8 +1327,11 @@ static int parse_value(ast_parser_t* ast_parser, ast_value_t* value, typecheck_t
 			(value->data.unary_op->operator == TOK_HASHTAG && !TYPE_COMP(type, typecheck_int)) ||
 			(value->data.unary_op->operator == TOK_NOT && !TYPE_COMP(type, typecheck_bool)))
 			PANIC(ast_parser, ERROR_UNEXPECTED_TYPE);
-		if (value->data.unary_op->operator == TOK_INCREMENT || value->data.unary_op->operator == TOK_DECREMENT)
+		if (value->data.unary_op->operator == TOK_INCREMENT || value->data.unary_op->operator == TOK_DECREMENT) {
 			PANIC_ON_FAIL(value->data.unary_op->operand.value_type == AST_VALUE_VAR || value->data.unary_op->operand.value_type == AST_VALUE_SET_VAR, ast_parser, ERROR_UNEXPECTED_TOK);
+			if (value->data.unary_op->operand.value_type == AST_VALUE_VAR && value->data.unary_op->operand.data.variable->is_readonly)
+				PANIC(ast_parser, ERROR_READONLY);
+		}
 
 		free_typecheck_type(ast_parser->safe_gc, &array_typecheck);
 		break;
@@ -1523,6 +1537,8 @@ static int parse_value(ast_parser_t* ast_parser, ast_value_t* value, typecheck_t
 			PANIC_ON_FAIL(TYPE_COMP(&operand.type, typecheck_int) || TYPE_COMP(&operand.type, typecheck_float), ast_parser, ERROR_UNEXPECTED_TYPE);
 			if (!(operand.value_type == AST_VALUE_VAR || operand.value_type == AST_VALUE_SET_VAR))
 				PANIC(ast_parser, ERROR_UNEXPECTED_TOK);
+			if (operand.value_type == AST_VALUE_VAR && operand.data.variable->is_readonly)
+				PANIC(ast_parser, ERROR_READONLY);
 
 			value->value_type = AST_VALUE_UNARY_OP;
 			PANIC_ON_FAIL(value->data.unary_op = safe_malloc(ast_parser->safe_gc, sizeof(ast_unary_op_t)), ast_parser, ERROR_MEMORY);
@@ -1605,6 +1621,319 @@ static int parse_expression(ast_parser_t* ast_parser, ast_value_t* value, typech
 	return 1;
 }
 
+static int fold_binary_op(ast_binary_op_t* binary_op, ast_primitive_t* out) {
+	ast_primitive_t lhs = *binary_op->lhs.data.primitive;
+	ast_primitive_t rhs = *binary_op->rhs.data.primitive;
+	out->type = AST_PRIMITIVE_BOOL;
+
+	switch (binary_op->operator)
+	{
+	case TOK_EQUALS:
+	case TOK_NOT_EQUAL:
+		switch (lhs.type)
+		{
+		case AST_PRIMITIVE_BOOL:
+			out->data.bool_flag = lhs.data.bool_flag == rhs.data.bool_flag;
+			break;
+		case AST_PRIMITIVE_CHAR:
+			out->data.bool_flag = lhs.data.character == rhs.data.character;
+			break;
+		case AST_PRIMITIVE_LONG:
+			out->data.bool_flag = lhs.data.long_int == rhs.data.long_int;
+			break;
+		case AST_PRIMITIVE_FLOAT:
+			out->data.bool_flag = lhs.data.float_int == rhs.data.float_int;
+			break;
+		}
+		if (binary_op->operator == TOK_NOT_EQUAL)
+			out->data.bool_flag = !out->data.bool_flag;
+		return 1;
+	case TOK_AND:
+		out->data.bool_flag = lhs.data.bool_flag && rhs.data.bool_flag;
+		return 1;
+	case TOK_OR:
+		out->data.bool_flag = lhs.data.bool_flag || rhs.data.bool_flag;
+		return 1;
+	default: //everything else depends on the operands' type
+		break;
+	}
+
+	if (lhs.type == AST_PRIMITIVE_LONG) {
+		//arithmetic is done unsigned so overflow wraps the same way it does at runtime
+		uint64_t a = lhs.data.long_int, b = rhs.data.long_int;
+		switch (binary_op->operator)
+		{
+		case TOK_MORE:
+			out->data.bool_flag = lhs.data.long_int > rhs.data.long_int;
+			return 1;
+		case TOK_LESS:
+			out->data.bool_flag = lhs.data.long_int < rhs.data.long_int;
+			return 1;
+		case TOK_MORE_EQUAL:
+			out->data.bool_flag = lhs.data.long_int >= rhs.data.long_int;
+			return 1;
+		case TOK_LESS_EQUAL:
+			out->data.bool_flag = lhs.data.long_int <= rhs.data.long_int;
+			return 1;
+		default:
+			break;
+		}
+		out->type = AST_PRIMITIVE_LONG;
+		switch (binary_op->operator)
+		{
+		case TOK_ADD:
+			out->data.long_int = a + b;
+			return 1;
+		case TOK_SUBTRACT:
+			out->data.long_int = a - b;
+			return 1;
+		case TOK_MULTIPLY:
+			out->data.long_int = a * b;
+			return 1;
+		case TOK_DIVIDE: //the machine divides by an unsigned divisor, and traps on zero
+			if (!b)
+				return 0;
+			out->data.long_int = lhs.data.long_int / b;
+			return 1;
+		case TOK_MODULO:
+			if (!rhs.data.long_int || rhs.data.long_int == -1)
+				return 0;
+			out->data.long_int = lhs.data.long_int % rhs.data.long_int;
+			return 1;
+		case TOK_POWER:
+			if (rhs.data.long_int < 0)
+				return 0;
+			uint64_t result = 1;
+			for (; b; b >>= 1) {
+				if (b & 1)
+					result *= a;
+				a *= a;
+			}
+			out->data.long_int = result;
+			return 1;
+		default:
+			return 0;
+		}
+	}
+	else if (lhs.type == AST_PRIMITIVE_FLOAT) {
+		double a = lhs.data.float_int, b = rhs.data.float_int;
+		switch (binary_op->operator)
+		{
+		case TOK_MORE:
+			out->data.bool_flag = a > b;
+			return 1;
+		case TOK_LESS:
+			out->data.bool_flag = a < b;
+			return 1;
+		case TOK_MORE_EQUAL:
+			out->data.bool_flag = a >= b;
+			return 1;
+		case TOK_LESS_EQUAL:
+			out->data.bool_flag = a <= b;
+			return 1;
+		default:
+			break;
+		}
+		out->type = AST_PRIMITIVE_FLOAT;
+		switch (binary_op->operator)
+		{
+		case TOK_ADD:
+			out->data.float_int = a + b;
+			return 1;
+		case TOK_SUBTRACT:
+			out->data.float_int = a - b;
+			return 1;
+		case TOK_MULTIPLY:
+			out->data.float_int = a * b;
+			return 1;
+		case TOK_DIVIDE:
+			out->data.float_int = a / b;
+			return 1;
+		case TOK_MODULO:
+			out->data.float_int = fmod(a, b);
+			return 1;
+		case TOK_POWER:
+			out->data.float_int = pow(a, b);
+			return 1;
+		default:
+			return 0;
+		}
+	}
+	return 0;
+}
+
+static int fold_to_primitive(ast_parser_t* ast_parser, ast_value_t* value, ast_primitive_t primitive) {
+	ESCAPE_ON_FAIL(value->data.primitive = ast_add_prim_value(ast_parser, primitive));
+	value->value_type = AST_VALUE_PRIMITIVE;
+	value->is_truey = primitive.type == AST_PRIMITIVE_BOOL && primitive.data.bool_flag;
+	value->is_falsey = primitive.type == AST_PRIMITIVE_BOOL && !primitive.data.bool_flag;
+	ast_parser->ast->folded_values++;
+	return 1;
+}
+
+static int fold_code_block(ast_parser_t* ast_parser, ast_code_block_t* code_block, ast_primitive_t** const_vars);
+
+static int fold_value(ast_parser_t* ast_parser, ast_value_t* value, ast_primitive_t** const_vars) {
+	switch (value->value_type)
+	{
+	case AST_VALUE_ALLOC_ARRAY:
+		ESCAPE_ON_FAIL(fold_value(ast_parser, &value->data.alloc_array->size, const_vars));
+		break;
+	case AST_VALUE_ALLOC_RECORD:
+		for (uint_fast8_t i = 0; i < value->data.alloc_record.init_value_count; i++)
+			ESCAPE_ON_FAIL(fold_value(ast_parser, &value->data.alloc_record.init_values[i].value, const_vars));
+		break;
+	case AST_VALUE_ARRAY_LITERAL:
+		for (uint_fast16_t i = 0; i < value->data.array_literal.element_count; i++)
+			ESCAPE_ON_FAIL(fold_value(ast_parser, &value->data.array_literal.elements[i], const_vars));
+		break;
+	case AST_VALUE_PROC:
+		ESCAPE_ON_FAIL(fold_code_block(ast_parser, &value->data.procedure->exec_block, const_vars));
+		break;
+	case AST_VALUE_VAR:
+		if (const_vars[value->data.variable->id])
+			ESCAPE_ON_FAIL(fold_to_primitive(ast_parser, value, *const_vars[value->data.variable->id]));
+		break;
+	case AST_VALUE_SET_VAR:
+		ESCAPE_ON_FAIL(fold_value(ast_parser, &value->data.set_var->set_value, const_vars));
+		break;
+	case AST_VALUE_SET_INDEX:
+		ESCAPE_ON_FAIL(fold_value(ast_parser, &value->data.set_index->array, const_vars));
+		ESCAPE_ON_FAIL(fold_value(ast_parser, &value->data.set_index->index, const_vars));
+		ESCAPE_ON_FAIL(fold_value(ast_parser, &value->data.set_index->value, const_vars));
+		break;
+	case AST_VALUE_SET_PROP:
+		ESCAPE_ON_FAIL(fold_value(ast_parser, &value->data.set_prop->record, const_vars));
+		ESCAPE_ON_FAIL(fold_value(ast_parser, &value->data.set_prop->value, const_vars));
+		break;
+	case AST_VALUE_GET_INDEX:
+		ESCAPE_ON_FAIL(fold_value(ast_parser, &value->data.get_index->array, const_vars));
+		ESCAPE_ON_FAIL(fold_value(ast_parser, &value->data.get_index->index, const_vars));
+		break;
+	case AST_VALUE_GET_PROP:
+		ESCAPE_ON_FAIL(fold_value(ast_parser, &value->data.get_prop->record, const_vars));
+		break;
+	case AST_VALUE_BINARY_OP: {
+		ESCAPE_ON_FAIL(fold_value(ast_parser, &value->data.binary_op->lhs, const_vars));
+		ESCAPE_ON_FAIL(fold_value(ast_parser, &value->data.binary_op->rhs, const_vars));
+		ast_primitive_t result;
+		if (value->data.binary_op->lhs.value_type == AST_VALUE_PRIMITIVE && value->data.binary_op->rhs.value_type == AST_VALUE_PRIMITIVE && fold_binary_op(value->data.binary_op, &result))
+			ESCAPE_ON_FAIL(fold_to_primitive(ast_parser, value, result));
+		break;
+	}
+	case AST_VALUE_UNARY_OP: {
+		if (value->data.unary_op->operator == TOK_INCREMENT || value->data.unary_op->operator == TOK_DECREMENT)
+			break;
+		ESCAPE_ON_FAIL(fold_value(ast_parser, &value->data.unary_op->operand, const_vars));
+		if (value->data.unary_op->operand.value_type != AST_VALUE_PRIMITIVE)
+			break;
+		ast_primitive_t result = *value->data.unary_op->operand.data.primitive;
+		if (value->data.unary_op->operator == TOK_NOT)
+			result.data.bool_flag = !result.data.bool_flag;
+		else if (value->data.unary_op->operator == TOK_SUBTRACT && result.type == AST_PRIMITIVE_LONG)
+			result.data.long_int = 0 - (uint64_t)result.data.long_int;
+		else if (value->data.unary_op->operator == TOK_SUBTRACT && result.type == AST_PRIMITIVE_FLOAT)
+			result.data.float_int = -result.data.float_int;
+		else
+			break;
+		ESCAPE_ON_FAIL(fold_to_primitive(ast_parser, value, result));
+		break;
+	}
+	case AST_VALUE_TYPE_OP:
+		ESCAPE_ON_FAIL(fold_value(ast_parser, &value->data.type_op->operand, const_vars));
+		break;
+	case AST_VALUE_PROC_CALL:
+		ESCAPE_ON_FAIL(fold_value(ast_parser, &value->data.proc_call->procedure, const_vars));
+		for (uint_fast8_t i = 0; i < value->data.proc_call->argument_count; i++)
+			ESCAPE_ON_FAIL(fold_value(ast_parser, &value->data.proc_call->arguments[i], const_vars));
+		break;
+	case AST_VALUE_FOREIGN:
+		ESCAPE_ON_FAIL(fold_value(ast_parser, &value->data.foreign->op_id, const_vars));
+		if (value->data.foreign->input)
+			ESCAPE_ON_FAIL(fold_value(ast_parser, value->data.foreign->input, const_vars));
+		break;
+	default: //primitives are already folded
+		break;
+	}
+	return 1;
+}
+
+//folds every condition in a chain, dropping links that can never run and turning the first always-taken link into the chain's final else
+static int fold_conditional(ast_parser_t* ast_parser, ast_cond_t** conditional, ast_primitive_t** const_vars) {
+	if ((*conditional)->next_if_true) {
+		ESCAPE_ON_FAIL(fold_value(ast_parser, (*conditional)->condition, const_vars));
+		ESCAPE_ON_FAIL(fold_code_block(ast_parser, &(*conditional)->exec_block, const_vars));
+		if ((*conditional)->condition->value_type == AST_VALUE_PRIMITIVE && (*conditional)->condition->is_falsey) {
+			*conditional = NULL;
+			ast_parser->ast->pruned_branches++;
+		}
+		return 1;
+	}
+
+	while (*conditional) {
+		ast_cond_t* current = *conditional;
+		if (current->condition) {
+			ESCAPE_ON_FAIL(fold_value(ast_parser, current->condition, const_vars));
+			if (current->condition->value_type == AST_VALUE_PRIMITIVE && current->condition->is_falsey) {
+				*conditional = current->next_if_false;
+				ast_parser->ast->pruned_branches++;
+				continue;
+			}
+			if (current->condition->value_type == AST_VALUE_PRIMITIVE && current->condition->is_truey) {
+				current->condition = NULL;
+				for (ast_cond_t* dead = current->next_if_false; dead; dead = dead->next_if_false)
+					ast_parser->ast->pruned_branches++;
+				current->next_if_false = NULL;
+			}
+		}
+		ESCAPE_ON_FAIL(fold_code_block(ast_parser, &current->exec_block, const_vars));
+		conditional = &current->next_if_false;
+	}
+	return 1;
+}
+
+static int fold_code_block(ast_parser_t* ast_parser, ast_code_block_t* code_block, ast_primitive_t** const_vars) {
+	uint32_t kept_statements = 0;
+	for (uint_fast32_t i = 0; i < code_block->instruction_count; i++) {
+		ast_statement_t* statement = &code_block->instructions[i];
+		switch (statement->type)
+		{
+		case AST_STATEMENT_DECL_VAR:
+			ESCAPE_ON_FAIL(fold_value(ast_parser, &statement->data.var_decl.set_value, const_vars));
+			if (statement->data.var_decl.var_info->is_readonly && statement->data.var_decl.set_value.value_type == AST_VALUE_PRIMITIVE)
+				const_vars[statement->data.var_decl.var_info->id] = statement->data.var_decl.set_value.data.primitive;
+			break;
+		case AST_STATEMENT_RECORD_PROTO:
+			for (uint_fast16_t j = 0; j < statement->data.record_proto->default_value_count; j++)
+				ESCAPE_ON_FAIL(fold_value(ast_parser, &statement->data.record_proto->default_values[j].value, const_vars));
+			break;
+		case AST_STATEMENT_COND:
+			ESCAPE_ON_FAIL(fold_conditional(ast_parser, &statement->data.conditional, const_vars));
+			if (!statement->data.conditional)
+				continue;
+			break;
+		case AST_STATEMENT_VALUE:
+		case AST_STATEMENT_RETURN_VALUE:
+			ESCAPE_ON_FAIL(fold_value(ast_parser, &statement->data.value, const_vars));
+			break;
+		default:
+			break;
+		}
+		code_block->instructions[kept_statements++] = *statement;
+	}
+	code_block->instruction_count = kept_statements;
+	return 1;
+}
+
+//evaluates operations on primitives, and readonly variables with primitive initializers, ahead of time
+static int ast_fold_constants(ast_parser_t* ast_parser) {
+	ast_primitive_t** const_vars = safe_calloc(ast_parser->safe_gc, ast_parser->ast->var_decl_count, sizeof(ast_primitive_t*));
+	PANIC_ON_FAIL(const_vars, ast_parser, ERROR_MEMORY);
+	ESCAPE_ON_FAIL(fold_code_block(ast_parser, &ast_parser->ast->exec_block, const_vars));
+	safe_free(ast_parser->safe_gc, const_vars);
+	return 1;
+}
+
 int init_ast(ast_t* ast, ast_parser_t* ast_parser, dbg_table_t* dbg_table) {
 	ast_parser->ast = ast;
 	ast->dbg_table = dbg_table;
@@ -1615,6 +1944,8 @@ int init_ast(ast_t* ast, ast_parser_t* ast_parser, dbg_table_t* dbg_table) {
 	ast->proc_count = 0;
 	ast->constant_count = 0;
 	ast->record_count = 0;
+	ast->folded_values = 0;
+	ast->pruned_branches = 0;
 
 	PANIC_ON_FAIL(ast->record_protos = safe_malloc(ast_parser->safe_gc, (ast->allocated_records = 4) * sizeof(ast_record_proto_t*)), ast_parser, ERROR_MEMORY);
 	PANIC_ON_FAIL(ast->primitives = safe_malloc(ast_parser->safe_gc, (ast->allocated_constants = 10) * sizeof(ast_primitive_t*)), ast_parser, ERROR_MEMORY);
@@ -1630,6 +1961,7 @@ int init_ast(ast_t* ast, ast_parser_t* ast_parser, dbg_table_t* dbg_table) {
 	ESCAPE_ON_FAIL(parse_code_block(ast_parser, &ast->exec_block, 0, 0));
 	ast_parser->top_level_local_count = CURRENT_FRAME.max_scoped_locals;
 	ESCAPE_ON_FAIL(ast_parser_close_frame(ast_parser));
+	ESCAPE_ON_FAIL(ast_fold_constants(ast_parser));
 	ESCAPE_ON_FAIL(ast_postproc(ast_parser));
 	return 1;
 }
\ No newline at end of file
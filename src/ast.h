@@ -33,6 +33,7 @@ typedef struct ast_var_info {
 	uint32_t id;
 	uint16_t scope_id;
 	int is_global, is_readonly, has_mutated, is_used;
+	int is_scalar_replaced; //a record that never escapes its procedure, kept in a register per property rather than allocated
 	typecheck_type_t type;
 } ast_var_info_t;
 
@@ -215,6 +216,8 @@ typedef struct ast_code_block {
 	int affects_state;
 } ast_code_block_t;
 
+#define AST_MAX_LOOP_INVARIANTS 16
+
 typedef struct ast_cond {
 	uint16_t scope_size;
 	ast_value_t* condition;
@@ -223,6 +226,9 @@ typedef struct ast_cond {
 
 	ast_cond_t* next_if_true;
 	ast_cond_t* next_if_false;
+
+	ast_value_t* invariants[AST_MAX_LOOP_INVARIANTS]; //values in a loop that are evaluated once in front of it
+	uint8_t invariant_count;
 } ast_cond_t;
 
 typedef struct ast_proc {
@@ -245,6 +251,7 @@ typedef struct ast_record_prop {
 	typecheck_type_t type;
 
 	int defer_init, is_readonly, do_typeguard, do_sub_typeguard;
+	int maybe_uninit; //some allocation leaves it unset, so loads have to check it
 } ast_record_prop_t;
 
 typedef struct ast_alloc_record_init_value {
@@ -311,6 +318,7 @@ typedef struct ast {
 	dbg_table_t* dbg_table;
 
 	uint32_t value_count, var_decl_count, proc_call_count;
+	uint32_t folded_values, pruned_branches;
 } ast_t;
 
 typedef struct ast_parser_frame ast_parser_frame_t;
@@ -1,6 +1,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include "compiler.h"
+#include "peephole.h"
+#include "typesig.h"
 
 #define LOC_REG(INDEX) (compiler_reg_t){.reg = (INDEX), .offset = 1}
 #define GLOB_REG(INDEX) (compiler_reg_t){.reg = (INDEX), .offset = 0}
@@ -31,9 +33,93 @@ int ins_builder_append_ins(ins_builder_t* ins_builder, compiler_ins_t ins) {
 
 static void allocate_code_block_regs(compiler_t* compiler, ast_code_block_t code_block, uint16_t current_reg, ast_proc_t* proc);
 
+//constant indices that fit in an operand are encoded in the instruction itself
+static int is_immediate_index(ast_value_t index) {
+	return index.value_type == AST_VALUE_PRIMITIVE && index.data.primitive->data.long_int >= 0 && index.data.primitive->data.long_int <= UINT16_MAX;
+}
+
+//whether every allocation of the record sets all of its properties, so it never needs an init bitset
+static int is_born_initialized(compiler_t* compiler, ast_record_proto_t* proto) {
+	for (;;) {
+		for (uint_fast8_t i = 0; i < proto->property_count; i++)
+			if (proto->properties[i].maybe_uninit)
+				return 0;
+		if (!proto->base_record)
+			return 1;
+		proto = compiler->ast->record_protos[proto->base_record->type_id];
+	}
+}
+
+//a property of a record that postproc found never escapes, which lives in a register of its own
+static int is_scalar_prop(ast_value_t record) {
+	return record.value_type == AST_VALUE_VAR && record.data.variable->is_scalar_replaced;
+}
+#define SCALAR_PROP_REG(RECORD, PROPERTY) LOC_REG(compiler->var_regs[(RECORD).data.variable->id].reg + (PROPERTY)->id)
+
+#define INLINE_MAX_COST 16
+
+//the number of values an expression compiles, or more than INLINE_MAX_COST if it can't be compiled twice
+static uint32_t inline_cost(ast_value_t value) {
+	uint32_t cost = 1;
+	switch (value.value_type) {
+	case AST_VALUE_ALLOC_ARRAY:
+		return cost + inline_cost(value.data.alloc_array->size);
+	case AST_VALUE_ARRAY_LITERAL:
+		for (uint_fast16_t i = 0; i < value.data.array_literal.element_count; i++)
+			cost += inline_cost(value.data.array_literal.elements[i]);
+		return cost;
+	case AST_VALUE_ALLOC_RECORD:
+		for (uint_fast16_t i = 0; i < value.data.alloc_record.init_value_count; i++)
+			cost += inline_cost(value.data.alloc_record.init_values[i].value);
+		return cost;
+	case AST_VALUE_PROC: //a procedure literal's body would be emitted again
+		return INLINE_MAX_COST + 1;
+	case AST_VALUE_SET_VAR:
+		return cost + inline_cost(value.data.set_var->set_value);
+	case AST_VALUE_SET_INDEX:
+		return cost + inline_cost(value.data.set_index->array) + inline_cost(value.data.set_index->index) + inline_cost(value.data.set_index->value);
+	case AST_VALUE_SET_PROP:
+		return cost + inline_cost(value.data.set_prop->record) + inline_cost(value.data.set_prop->value);
+	case AST_VALUE_GET_INDEX:
+		return cost + inline_cost(value.data.get_index->array) + inline_cost(value.data.get_index->index);
+	case AST_VALUE_GET_PROP:
+		return cost + inline_cost(value.data.get_prop->record);
+	case AST_VALUE_BINARY_OP:
+		return cost + inline_cost(value.data.binary_op->lhs) + inline_cost(value.data.binary_op->rhs);
+	case AST_VALUE_UNARY_OP:
+		return cost + inline_cost(value.data.unary_op->operand);
+	case AST_VALUE_TYPE_OP:
+		return cost + inline_cost(value.data.type_op->operand);
+	case AST_VALUE_PROC_CALL:
+		for (uint_fast8_t i = 0; i < value.data.proc_call->argument_count; i++)
+			cost += inline_cost(value.data.proc_call->arguments[i]);
+		return cost + inline_cost(value.data.proc_call->procedure);
+	case AST_VALUE_FOREIGN:
+		return cost + inline_cost(value.data.foreign->op_id) + (value.data.foreign->input ? inline_cost(*value.data.foreign->input) : 0);
+	default:
+		return cost;
+	}
+}
+
+//small single expression procedures without a gc frame of their own are compiled in place of direct calls to them
+static ast_proc_t* inline_target(compiler_t* compiler, ast_call_proc_t* proc_call) {
+	if (!compiler->inline_procs || proc_call->procedure.value_type != AST_VALUE_VAR)
+		return NULL;
+	ast_proc_t* callee = compiler->var_procs[proc_call->procedure.data.variable->id];
+	if (!callee || callee->do_gc)
+		return NULL;
+
+	ast_code_block_t body = callee->exec_block;
+	if (body.instruction_count == 1 && body.instructions[0].type == AST_STATEMENT_RETURN_VALUE)
+		return inline_cost(body.instructions[0].data.value) <= INLINE_MAX_COST ? callee : NULL;
+	else if (body.instruction_count == 2 && body.instructions[0].type == AST_STATEMENT_VALUE && body.instructions[1].type == AST_STATEMENT_RETURN)
+		return inline_cost(body.instructions[0].data.value) <= INLINE_MAX_COST ? callee : NULL;
+	return NULL;
+}
+
 #define ALLOC_LOC(REG) LOC_REG((proc && (REG) > compiler->proc_call_max_locals[proc->id]) ? (compiler->proc_call_max_locals[proc->id] = (REG)) : (REG))
 static uint16_t allocate_value_regs(compiler_t* compiler, ast_value_t value, uint16_t current_reg, compiler_reg_t* target_reg, ast_proc_t* proc) {
-	if (!value.affects_state)
+	if (!value.affects_state || compiler->hoisted[value.id])
 		return current_reg;
 	uint16_t extra_regs = current_reg;
 	switch (value.value_type)
@@ -86,7 +172,7 @@ static uint16_t allocate_value_regs(compiler_t* compiler, ast_value_t value, uin
 	case AST_VALUE_SET_INDEX:
 		if (value.data.set_index->array.affects_state) {
 			extra_regs = allocate_value_regs(compiler, value.data.set_index->array, extra_regs, NULL, proc);
-			if (value.data.set_index->index.value_type != AST_VALUE_PRIMITIVE)
+			if (!is_immediate_index(value.data.set_index->index))
 				extra_regs = allocate_value_regs(compiler, value.data.set_index->index, extra_regs, NULL, proc);
 			allocate_value_regs(compiler, value.data.set_index->value, extra_regs, NULL, proc);
 		}
@@ -97,6 +183,12 @@ static uint16_t allocate_value_regs(compiler_t* compiler, ast_value_t value, uin
 		compiler->eval_regs[value.id] = compiler->eval_regs[value.data.set_index->value.id];
 		return current_reg;
 	case AST_VALUE_SET_PROP:
+		if (is_scalar_prop(value.data.set_prop->record)) {
+			allocate_value_regs(compiler, value.data.set_prop->value, current_reg, NULL, proc);
+			compiler->eval_regs[value.id] = SCALAR_PROP_REG(value.data.set_prop->record, value.data.set_prop->property);
+			compiler->move_eval[value.id] = 1;
+			return current_reg;
+		}
 		if (value.data.set_prop->record.affects_state) {
 			extra_regs = allocate_value_regs(compiler, value.data.set_prop->record, extra_regs, NULL, proc);
 			allocate_value_regs(compiler, value.data.set_prop->value, extra_regs, NULL, proc);
@@ -108,10 +200,15 @@ static uint16_t allocate_value_regs(compiler_t* compiler, ast_value_t value, uin
 		return current_reg;
 	case AST_VALUE_GET_INDEX:
 		extra_regs = allocate_value_regs(compiler, value.data.get_index->array, extra_regs, NULL, proc);
-		if (value.data.set_index->index.value_type != AST_VALUE_PRIMITIVE)
+		if (!is_immediate_index(value.data.set_index->index))
 			allocate_value_regs(compiler, value.data.get_index->index, extra_regs, NULL, proc);
 		break;
 	case AST_VALUE_GET_PROP:
+		if (is_scalar_prop(value.data.get_prop->record)) {
+			compiler->eval_regs[value.id] = SCALAR_PROP_REG(value.data.get_prop->record, value.data.get_prop->property);
+			compiler->move_eval[value.id] = 1;
+			return current_reg;
+		}
 		allocate_value_regs(compiler, value.data.get_prop->record, extra_regs, NULL, proc);
 		break;
 	case AST_VALUE_BINARY_OP:
@@ -144,6 +241,14 @@ static uint16_t allocate_value_regs(compiler_t* compiler, ast_value_t value, uin
 		}
 		allocate_value_regs(compiler, value.data.proc_call->procedure, extra_regs, NULL, proc);
 
+		//an inlined callee's frame starts at the call's offset, and must fit in the caller's
+		if ((compiler->inlined_calls[value.data.proc_call->id] = inline_target(compiler, value.data.proc_call))) {
+			uint16_t inline_locals = compiler->proc_call_offsets[value.data.proc_call->id] + compiler->proc_call_max_locals[compiler->inlined_calls[value.data.proc_call->id]->id];
+			uint16_t* max_locals = proc ? &compiler->proc_call_max_locals[proc->id] : &compiler->top_level_inline_locals;
+			if (inline_locals > *max_locals)
+				*max_locals = inline_locals;
+		}
+
 		return current_reg + 1;
 	}
 	case AST_VALUE_FOREIGN:
@@ -164,24 +269,422 @@ static uint16_t allocate_value_regs(compiler_t* compiler, ast_value_t value, uin
 	return current_reg;
 }
 
-static void allocate_code_block_regs(compiler_t* compiler, ast_code_block_t code_block, uint16_t current_reg, ast_proc_t* proc) {
+//what a loop's condition and body may change, gathered before looking for values that stay the same across iterations
+typedef struct loop_scan {
+	ast_cond_t* loop;
+
+	uint8_t* assigned_vars; //how many places assign a variable, counting up to two
+	uint8_t written_props[UINT8_MAX + 1]; //indexed by property id modulo 256, so collisions only hoist less
+	int has_calls, hoisting, in_condition;
+
+	//once the effects are known, indexing this array with this counter needs no bounds check anywhere in the loop
+	ast_var_info_t* counter;
+	ast_value_t* counted_array;
+} loop_scan_t;
+
+static int is_loop_invariant(ast_value_t value, loop_scan_t* scan) {
+	switch (value.value_type) {
+	case AST_VALUE_VAR:
+		return !scan->assigned_vars[value.data.variable->id] && !(value.data.variable->is_global && value.data.variable->has_mutated && scan->has_calls);
+	case AST_VALUE_GET_PROP: //a call may write any property a record shares with the rest of the program, unless it's readonly
+		return !scan->written_props[value.data.get_prop->property->id & UINT8_MAX] && (!scan->has_calls || value.data.get_prop->property->is_readonly) && is_loop_invariant(value.data.get_prop->record, scan);
+	case AST_VALUE_UNARY_OP: //realloc<T> resizes an array in place through a foreign call, so a length only holds while the loop makes no calls
+		return value.data.unary_op->operator == TOK_HASHTAG && !scan->has_calls && is_loop_invariant(value.data.unary_op->operand, scan);
+	case AST_VALUE_TYPE_OP:
+		return is_loop_invariant(value.data.type_op->operand, scan);
+	default:
+		return 0;
+	}
+}
+
+//records and arrays that are always initialized, so loading from them before the loop can't fault
+static int is_initialized_ref(ast_value_t value) {
+	if (value.value_type == AST_VALUE_GET_PROP)
+		return !value.data.get_prop->property->defer_init && is_initialized_ref(value.data.get_prop->record);
+	return value.value_type == AST_VALUE_VAR;
+}
+
+static int may_hoist(ast_value_t value, loop_scan_t* scan) {
+	if (value.value_type == AST_VALUE_VAR || !value.affects_state || value.free_status != POSTPROC_FREE_NONE || !is_loop_invariant(value, scan))
+		return 0;
+	if (scan->in_condition) //the condition runs at least once anyway
+		return 1;
+
+	//the body may never run, so only loads that can't fail are evaluated ahead of it
+	switch (value.value_type) {
+	case AST_VALUE_GET_PROP:
+		return is_initialized_ref(value.data.get_prop->record);
+	case AST_VALUE_UNARY_OP:
+		return is_initialized_ref(value.data.unary_op->operand);
+	default:
+		return 0;
+	}
+}
+
+//whether two references to arrays the loop doesn't change name the same array
+static int is_same_ref(ast_value_t a, ast_value_t b) {
+	if (a.value_type != b.value_type)
+		return 0;
+	switch (a.value_type) {
+	case AST_VALUE_VAR:
+		return a.data.variable->id == b.data.variable->id;
+	case AST_VALUE_GET_PROP:
+		return a.data.get_prop->property->id == b.data.get_prop->property->id && is_same_ref(a.data.get_prop->record, b.data.get_prop->record);
+	default:
+		return 0;
+	}
+}
+
+static int is_counted_index(ast_value_t array, ast_value_t index, loop_scan_t* scan) {
+	return scan->counter && index.value_type == AST_VALUE_VAR && index.data.variable->id == scan->counter->id && is_same_ref(array, *scan->counted_array);
+}
+
+static void mark_assigned(loop_scan_t* scan, ast_var_info_t* var_info) {
+	if (scan->assigned_vars[var_info->id] < 2)
+		scan->assigned_vars[var_info->id]++;
+}
+
+static void scan_loop_block(compiler_t* compiler, ast_code_block_t code_block, loop_scan_t* scan);
+
+//records a loop's effects, or once they're known, collects the values to hoist and the accesses that need no bounds check
+static void scan_loop_value(compiler_t* compiler, ast_value_t* value, loop_scan_t* scan) {
+	if (scan->hoisting) {
+		if (compiler->hoisted[value->id]) //already evaluated in front of an enclosing loop
+			return;
+		if (may_hoist(*value, scan) && scan->loop->invariant_count < AST_MAX_LOOP_INVARIANTS) {
+			scan->loop->invariants[scan->loop->invariant_count++] = value;
+			return;
+		}
+	}
+
+	switch (value->value_type) {
+	case AST_VALUE_ALLOC_ARRAY:
+		scan_loop_value(compiler, &value->data.alloc_array->size, scan);
+		break;
+	case AST_VALUE_ARRAY_LITERAL:
+		for (uint_fast16_t i = 0; i < value->data.array_literal.element_count; i++)
+			scan_loop_value(compiler, &value->data.array_literal.elements[i], scan);
+		break;
+	case AST_VALUE_ALLOC_RECORD:
+		for (uint_fast16_t i = 0; i < value->data.alloc_record.init_value_count; i++)
+			scan_loop_value(compiler, &value->data.alloc_record.init_values[i].value, scan);
+		break;
+	case AST_VALUE_SET_VAR:
+		if (!scan->hoisting)
+			mark_assigned(scan, value->data.set_var->var_info);
+		scan_loop_value(compiler, &value->data.set_var->set_value, scan);
+		break;
+	case AST_VALUE_SET_INDEX:
+		if (scan->hoisting && is_counted_index(value->data.set_index->array, value->data.set_index->index, scan))
+			compiler->unchecked_indices[value->id] = 1;
+		scan_loop_value(compiler, &value->data.set_index->array, scan);
+		scan_loop_value(compiler, &value->data.set_index->index, scan);
+		scan_loop_value(compiler, &value->data.set_index->value, scan);
+		break;
+	case AST_VALUE_SET_PROP:
+		if (!scan->hoisting)
+			scan->written_props[value->data.set_prop->property->id & UINT8_MAX] = 1;
+		scan_loop_value(compiler, &value->data.set_prop->record, scan);
+		scan_loop_value(compiler, &value->data.set_prop->value, scan);
+		break;
+	case AST_VALUE_GET_INDEX:
+		if (scan->hoisting && is_counted_index(value->data.get_index->array, value->data.get_index->index, scan))
+			compiler->unchecked_indices[value->id] = 1;
+		scan_loop_value(compiler, &value->data.get_index->array, scan);
+		scan_loop_value(compiler, &value->data.get_index->index, scan);
+		break;
+	case AST_VALUE_GET_PROP:
+		scan_loop_value(compiler, &value->data.get_prop->record, scan);
+		break;
+	case AST_VALUE_BINARY_OP:
+		scan_loop_value(compiler, &value->data.binary_op->lhs, scan);
+		scan_loop_value(compiler, &value->data.binary_op->rhs, scan);
+		break;
+	case AST_VALUE_UNARY_OP:
+		if (!scan->hoisting && (value->data.unary_op->operator == TOK_INCREMENT || value->data.unary_op->operator == TOK_DECREMENT) && value->data.unary_op->operand.value_type == AST_VALUE_VAR)
+			mark_assigned(scan, value->data.unary_op->operand.data.variable);
+		scan_loop_value(compiler, &value->data.unary_op->operand, scan);
+		break;
+	case AST_VALUE_TYPE_OP:
+		scan_loop_value(compiler, &value->data.type_op->operand, scan);
+		break;
+	case AST_VALUE_PROC_CALL:
+		scan->has_calls = 1;
+		for (uint_fast8_t i = 0; i < value->data.proc_call->argument_count; i++)
+			scan_loop_value(compiler, &value->data.proc_call->arguments[i], scan);
+		scan_loop_value(compiler, &value->data.proc_call->procedure, scan);
+		break;
+	case AST_VALUE_FOREIGN:
+		scan->has_calls = 1;
+		scan_loop_value(compiler, &value->data.foreign->op_id, scan);
+		if (value->data.foreign->input)
+			scan_loop_value(compiler, value->data.foreign->input, scan);
+		break;
+	default: //procedure literals don't run where they appear
+		break;
+	}
+}
+
+static void scan_loop_block(compiler_t* compiler, ast_code_block_t code_block, loop_scan_t* scan) {
 	for (uint_fast32_t i = 0; i < code_block.instruction_count; i++)
+		switch (code_block.instructions[i].type) {
+		case AST_STATEMENT_DECL_VAR:
+			if (!scan->hoisting)
+				mark_assigned(scan, code_block.instructions[i].data.var_decl.var_info);
+			scan_loop_value(compiler, &code_block.instructions[i].data.var_decl.set_value, scan);
+			break;
+		case AST_STATEMENT_COND:
+			for (ast_cond_t* conditional = code_block.instructions[i].data.conditional; conditional; conditional = conditional->next_if_false) {
+				if (conditional->condition)
+					scan_loop_value(compiler, conditional->condition, scan);
+				scan_loop_block(compiler, conditional->exec_block, scan);
+			}
+			break;
+		case AST_STATEMENT_VALUE:
+		case AST_STATEMENT_RETURN_VALUE:
+			scan_loop_value(compiler, &code_block.instructions[i].data.value, scan);
+			break;
+		default:
+			break;
+		}
+}
+
+static int is_long_constant(ast_value_t value, int64_t min) {
+	return value.value_type == AST_VALUE_PRIMITIVE && value.data.primitive->type == AST_PRIMITIVE_LONG && value.data.primitive->data.long_int >= min;
+}
+
+//finds a counter that stays within [0, #array) for the whole loop, for an array the loop doesn't change. It's either
+//i < #a, starting at zero or more, or i >= 0, starting at #a minus one or more. The counter can't be assigned anywhere but its step, i++ or i-- respectively, which must be the body's last statement
+static int find_counted_array(ast_code_block_t code_block, uint32_t loop_index, loop_scan_t* scan) {
+	ast_cond_t* loop = code_block.instructions[loop_index].data.conditional;
+	if (!loop_index || !loop->exec_block.instruction_count || loop->condition->value_type != AST_VALUE_BINARY_OP)
+		return 0;
+
+	ast_statement_t step = loop->exec_block.instructions[loop->exec_block.instruction_count - 1];
+	if (step.type != AST_STATEMENT_VALUE || step.data.value.value_type != AST_VALUE_UNARY_OP || step.data.value.data.unary_op->operand.value_type != AST_VALUE_VAR)
+		return 0;
+	ast_var_info_t* counter = step.data.value.data.unary_op->operand.data.variable;
+	if (scan->assigned_vars[counter->id] != 1 || (counter->is_global && scan->has_calls))
+		return 0;
+
+	ast_value_t* init;
+	ast_statement_t before = code_block.instructions[loop_index - 1];
+	if (before.type == AST_STATEMENT_DECL_VAR && before.data.var_decl.var_info == counter)
+		init = &code_block.instructions[loop_index - 1].data.var_decl.set_value;
+	else if (before.type == AST_STATEMENT_VALUE && before.data.value.value_type == AST_VALUE_SET_VAR && before.data.value.data.set_var->var_info == counter)
+		init = &before.data.value.data.set_var->set_value;
+	else
+		return 0;
+
+	ast_binary_op_t* compare = loop->condition->data.binary_op;
+	if (compare->lhs.value_type != AST_VALUE_VAR || compare->lhs.data.variable != counter)
+		return 0;
+
+	ast_value_t* length;
+	if (step.data.value.data.unary_op->operator == TOK_INCREMENT && compare->operator == TOK_LESS) {
+		if (!is_long_constant(*init, 0) && !(init->value_type == AST_VALUE_UNARY_OP && init->data.unary_op->operator == TOK_HASHTAG))
+			return 0;
+		length = &compare->rhs;
+	}
+	else if (step.data.value.data.unary_op->operator == TOK_DECREMENT && compare->operator == TOK_MORE_EQUAL && is_long_constant(compare->rhs, 0)) {
+		if (init->value_type != AST_VALUE_BINARY_OP || init->data.binary_op->operator != TOK_SUBTRACT || !is_long_constant(init->data.binary_op->rhs, 1))
+			return 0;
+		length = &init->data.binary_op->lhs;
+	}
+	else
+		return 0;
+
+	if (length->value_type != AST_VALUE_UNARY_OP || length->data.unary_op->operator != TOK_HASHTAG || !is_loop_invariant(*length, scan))
+		return 0;
+	scan->counter = counter;
+	scan->counted_array = &length->data.unary_op->operand;
+	return 1;
+}
+
+//array lengths, property loads and casts that can't change while a loop runs get registers below the loop's own, and are compiled once in front of it
+//accesses through the loop's counter are marked to skip their bounds checks
+static uint16_t optimize_loop(compiler_t* compiler, ast_code_block_t code_block, uint32_t loop_index, uint16_t current_reg, ast_proc_t* proc) {
+	ast_cond_t* loop = code_block.instructions[loop_index].data.conditional;
+	loop_scan_t scan = { .loop = loop };
+	loop->invariant_count = 0;
+	scan.assigned_vars = safe_calloc(compiler->safe_gc, compiler->ast->var_decl_count, sizeof(uint8_t));
+	if (!scan.assigned_vars) //these are only optimizations
+		return current_reg;
+
+	scan_loop_value(compiler, loop->condition, &scan);
+	scan_loop_block(compiler, loop->exec_block, &scan);
+	find_counted_array(code_block, loop_index, &scan);
+
+	scan.hoisting = 1;
+	scan.in_condition = 1;
+	scan_loop_value(compiler, loop->condition, &scan);
+	scan.in_condition = 0;
+	scan_loop_block(compiler, loop->exec_block, &scan);
+	safe_free(compiler->safe_gc, scan.assigned_vars);
+
+	for (uint_fast8_t i = 0; i < loop->invariant_count; i++) {
+		current_reg = allocate_value_regs(compiler, *loop->invariants[i], current_reg, NULL, proc);
+		compiler->move_eval[loop->invariants[i]->id] = 1; //whatever consumes it gets a copy, rather than a target register to write to
+		compiler->hoisted[loop->invariants[i]->id] = 1;
+	}
+	return current_reg;
+}
+
+//a variable that's never reassigned shares the register of a constant, procedure or other such variable it's initialized to
+static int is_alias_decl(ast_decl_var_t var_decl) {
+	return !var_decl.var_info->has_mutated &&
+		(var_decl.set_value.value_type == AST_VALUE_PRIMITIVE ||
+			var_decl.set_value.value_type == AST_VALUE_PROC ||
+
+		(var_decl.set_value.value_type == AST_VALUE_VAR && !var_decl.set_value.data.variable->has_mutated) &&
+			!(var_decl.var_info->is_global && !var_decl.set_value.data.variable->is_global));
+}
+
+static void record_block_uses(compiler_t* compiler, ast_code_block_t code_block, uint32_t block, uint32_t statement);
+
+//a read or write of a variable, or of one aliasing it, keeps it live through the statement of its declaring block that contains it
+static void record_var_use(compiler_t* compiler, ast_var_info_t* var_info, uint32_t block, uint32_t statement) {
+	for (; var_info; var_info = compiler->locals[var_info->id].alias_of)
+		if (compiler->locals[var_info->id].block == block)
+			compiler->locals[var_info->id].last_use = statement;
+}
+
+static void record_value_uses(compiler_t* compiler, ast_value_t value, uint32_t block, uint32_t statement) {
+	switch (value.value_type) {
+	case AST_VALUE_ALLOC_ARRAY:
+		record_value_uses(compiler, value.data.alloc_array->size, block, statement);
+		break;
+	case AST_VALUE_ARRAY_LITERAL:
+		for (uint_fast16_t i = 0; i < value.data.array_literal.element_count; i++)
+			record_value_uses(compiler, value.data.array_literal.elements[i], block, statement);
+		break;
+	case AST_VALUE_ALLOC_RECORD:
+		for (uint_fast16_t i = 0; i < value.data.alloc_record.init_value_count; i++)
+			record_value_uses(compiler, value.data.alloc_record.init_values[i].value, block, statement);
+		break;
+	case AST_VALUE_VAR:
+		record_var_use(compiler, value.data.variable, block, statement);
+		break;
+	case AST_VALUE_SET_VAR:
+		record_var_use(compiler, value.data.set_var->var_info, block, statement);
+		record_value_uses(compiler, value.data.set_var->set_value, block, statement);
+		break;
+	case AST_VALUE_SET_INDEX:
+		record_value_uses(compiler, value.data.set_index->array, block, statement);
+		record_value_uses(compiler, value.data.set_index->index, block, statement);
+		record_value_uses(compiler, value.data.set_index->value, block, statement);
+		break;
+	case AST_VALUE_SET_PROP:
+		record_value_uses(compiler, value.data.set_prop->record, block, statement);
+		record_value_uses(compiler, value.data.set_prop->value, block, statement);
+		break;
+	case AST_VALUE_GET_INDEX:
+		record_value_uses(compiler, value.data.get_index->array, block, statement);
+		record_value_uses(compiler, value.data.get_index->index, block, statement);
+		break;
+	case AST_VALUE_GET_PROP:
+		record_value_uses(compiler, value.data.get_prop->record, block, statement);
+		break;
+	case AST_VALUE_BINARY_OP:
+		record_value_uses(compiler, value.data.binary_op->lhs, block, statement);
+		record_value_uses(compiler, value.data.binary_op->rhs, block, statement);
+		break;
+	case AST_VALUE_UNARY_OP:
+		record_value_uses(compiler, value.data.unary_op->operand, block, statement);
+		break;
+	case AST_VALUE_TYPE_OP:
+		record_value_uses(compiler, value.data.type_op->operand, block, statement);
+		break;
+	case AST_VALUE_PROC_CALL:
+		for (uint_fast8_t i = 0; i < value.data.proc_call->argument_count; i++)
+			record_value_uses(compiler, value.data.proc_call->arguments[i], block, statement);
+		record_value_uses(compiler, value.data.proc_call->procedure, block, statement);
+		break;
+	case AST_VALUE_FOREIGN:
+		record_value_uses(compiler, value.data.foreign->op_id, block, statement);
+		if (value.data.foreign->input)
+			record_value_uses(compiler, *value.data.foreign->input, block, statement);
+		break;
+	default: //procedures have frames of their own
+		break;
+	}
+}
+
+static void record_block_uses(compiler_t* compiler, ast_code_block_t code_block, uint32_t block, uint32_t statement) {
+	for (uint_fast32_t i = 0; i < code_block.instruction_count; i++)
+		switch (code_block.instructions[i].type) {
+		case AST_STATEMENT_DECL_VAR: {
+			ast_decl_var_t var_decl = code_block.instructions[i].data.var_decl;
+			if (is_alias_decl(var_decl) && var_decl.set_value.value_type == AST_VALUE_VAR)
+				compiler->locals[var_decl.var_info->id].alias_of = var_decl.set_value.data.variable;
+			record_value_uses(compiler, var_decl.set_value, block, statement);
+			break;
+		}
+		case AST_STATEMENT_COND:
+			for (ast_cond_t* conditional = code_block.instructions[i].data.conditional; conditional; conditional = conditional->next_if_false) {
+				if (conditional->condition)
+					record_value_uses(compiler, *conditional->condition, block, statement);
+				record_block_uses(compiler, conditional->exec_block, block, statement);
+			}
+			break;
+		case AST_STATEMENT_VALUE:
+		case AST_STATEMENT_RETURN_VALUE:
+			record_value_uses(compiler, code_block.instructions[i].data.value, block, statement);
+			break;
+		default:
+			break;
+		}
+}
+
+#define MAX_FREE_LOCALS 32
+
+//slots of locals that are dead for the rest of a block, which later declarations in it or its nested blocks reuse
+typedef struct free_locals {
+	uint16_t slots[MAX_FREE_LOCALS];
+	uint8_t count;
+} free_locals_t;
+
+//a freed slot at the top of the block's registers lowers it instead, along with any free slots beneath it
+static void release_local(free_locals_t* free_locals, uint16_t slot, uint16_t* current_reg) {
+	if (slot + 1 != *current_reg) {
+		if (free_locals->count < MAX_FREE_LOCALS)
+			free_locals->slots[free_locals->count++] = slot;
+		return;
+	}
+	(*current_reg)--;
+	for (uint_fast8_t i = 0; i < free_locals->count;)
+		if (free_locals->slots[i] + 1 == *current_reg) {
+			free_locals->slots[i] = free_locals->slots[--free_locals->count];
+			(*current_reg)--;
+			i = 0;
+		}
+		else
+			i++;
+}
+
+static void allocate_block_regs(compiler_t* compiler, ast_code_block_t code_block, uint16_t current_reg, ast_proc_t* proc, free_locals_t free_locals) {
+	uint32_t block = ++compiler->block_count;
+	for (uint_fast32_t i = 0; i < code_block.instruction_count; i++)
+		if (code_block.instructions[i].type == AST_STATEMENT_DECL_VAR)
+			compiler->locals[code_block.instructions[i].data.var_decl.var_info->id] = (compiler_local_t){ .block = block, .last_use = i };
+	for (uint_fast32_t i = 0; i < code_block.instruction_count; i++) {
+		ast_code_block_t statement = { .instructions = &code_block.instructions[i], .instruction_count = 1 };
+		record_block_uses(compiler, statement, block, i);
+	}
+
+	for (uint_fast32_t i = 0; i < code_block.instruction_count; i++) {
 		switch (code_block.instructions[i].type)
 		{
 		case AST_STATEMENT_DECL_VAR: {
 			ast_decl_var_t var_decl = code_block.instructions[i].data.var_decl;
-			if (!var_decl.var_info->has_mutated &&
-				(var_decl.set_value.value_type == AST_VALUE_PRIMITIVE ||
-					var_decl.set_value.value_type == AST_VALUE_PROC ||
-
-				(var_decl.set_value.value_type == AST_VALUE_VAR && !var_decl.set_value.data.variable->has_mutated) &&
-					!(var_decl.var_info->is_global && !var_decl.set_value.data.variable->is_global))
-			) {
+			if (is_alias_decl(var_decl)) {
 				current_reg = allocate_value_regs(compiler, var_decl.set_value, current_reg, NULL, proc);
 				if (var_decl.var_info->is_used) {
 					compiler->var_regs[var_decl.var_info->id] = compiler->eval_regs[var_decl.set_value.id];
 					compiler->move_eval[var_decl.set_value.id] = 0;
 				}
+				if (var_decl.set_value.value_type == AST_VALUE_PROC)
+					compiler->var_procs[var_decl.var_info->id] = var_decl.set_value.data.procedure;
 			}
 			else {
 				if (var_decl.var_info->is_global) {
@@ -192,10 +695,26 @@ static void allocate_code_block_regs(compiler_t* compiler, ast_code_block_t code
 					else if (var_decl.set_value.affects_state)
 						allocate_value_regs(compiler, var_decl.set_value, current_reg, NULL, proc);
 				}
+				else if (var_decl.var_info->is_scalar_replaced) {
+					//each property gets a register, which its initial value is evaluated straight into
+					compiler->var_regs[var_decl.var_info->id] = LOC_REG(current_reg);
+					for (uint_fast16_t j = 0; j < var_decl.set_value.data.alloc_record.init_value_count; j++) {
+						compiler_reg_t prop_reg = ALLOC_LOC(current_reg + var_decl.set_value.data.alloc_record.init_values[j].property->id);
+						allocate_value_regs(compiler, var_decl.set_value.data.alloc_record.init_values[j].value, current_reg + var_decl.set_value.data.alloc_record.proto->index_offset + var_decl.set_value.data.alloc_record.proto->property_count, &prop_reg, proc);
+					}
+					current_reg += var_decl.set_value.data.alloc_record.proto->index_offset + var_decl.set_value.data.alloc_record.proto->property_count;
+				}
 				else {
-					if (var_decl.var_info->is_used) {
+					//a call's result already lands on top of the block's registers, so it keeps that slot rather than taking a dead one
+					if (var_decl.var_info->is_used && free_locals.count && var_decl.set_value.value_type != AST_VALUE_PROC_CALL) {
+						compiler->var_regs[var_decl.var_info->id] = LOC_REG(free_locals.slots[--free_locals.count]);
+						allocate_value_regs(compiler, var_decl.set_value, current_reg, &compiler->var_regs[var_decl.var_info->id], proc);
+						compiler->locals[var_decl.var_info->id].owns_slot = 1;
+					}
+					else if (var_decl.var_info->is_used) {
 						compiler->var_regs[var_decl.var_info->id] = ALLOC_LOC(current_reg);
 						allocate_value_regs(compiler, var_decl.set_value, current_reg, &compiler->var_regs[var_decl.var_info->id], proc);
+						compiler->locals[var_decl.var_info->id].owns_slot = 1;
 						current_reg++;
 					}
 					else if (var_decl.set_value.affects_state)
@@ -206,11 +725,12 @@ static void allocate_code_block_regs(compiler_t* compiler, ast_code_block_t code
 		}
 		case AST_STATEMENT_COND: {
 			ast_cond_t* conditional = code_block.instructions[i].data.conditional;
+			uint16_t cond_reg = conditional->next_if_true ? optimize_loop(compiler, code_block, i, current_reg, proc) : current_reg;
 			while (conditional)
 			{
 				if (conditional->condition)
-					allocate_value_regs(compiler, *conditional->condition, current_reg, NULL, proc);
-				allocate_code_block_regs(compiler, conditional->exec_block, current_reg, proc);
+					allocate_value_regs(compiler, *conditional->condition, cond_reg, NULL, proc);
+				allocate_block_regs(compiler, conditional->exec_block, cond_reg, proc, free_locals);
 				conditional = conditional->next_if_false;
 			}
 			break;
@@ -226,10 +746,42 @@ static void allocate_code_block_regs(compiler_t* compiler, ast_code_block_t code
 			break;
 		}
 		}
+
+		for (uint_fast32_t j = 0; j <= i; j++)
+			if (code_block.instructions[j].type == AST_STATEMENT_DECL_VAR) {
+				compiler_local_t* local = &compiler->locals[code_block.instructions[j].data.var_decl.var_info->id];
+				if (local->owns_slot && local->last_use == i) {
+					local->owns_slot = 0;
+					release_local(&free_locals, compiler->var_regs[code_block.instructions[j].data.var_decl.var_info->id].reg, &current_reg);
+				}
+			}
+	}
+}
+
+//locals share a slot once the ones before them are dead, and a proc's frame only has to fit the most that are live at once
+static void allocate_code_block_regs(compiler_t* compiler, ast_code_block_t code_block, uint16_t current_reg, ast_proc_t* proc) {
+	allocate_block_regs(compiler, code_block, current_reg, proc, (free_locals_t) { .count = 0 });
 }
 #undef ALLOC_LOC
 
 #define TYPEARG_INFO_REG(TYPE) LOC_REG(proc->param_count + 1 + ((TYPE).type_id)) // compiler->proc_generic_regs[proc->id][(TYPE).type_id]
+#define LAST_INS compiler->ins_builder.instructions[compiler->ins_builder.instruction_count - 1]
+
+//operands and conditions are allocated without a target register, so these values get a fresh register that only their consumer reads
+//hoisted values are the exception, since every iteration reads them
+static int eval_reg_is_temp(compiler_t* compiler, ast_value_t value) {
+	if (compiler->hoisted[value.id])
+		return 0;
+	switch (value.value_type) {
+	case AST_VALUE_GET_PROP:
+		return value.affects_state && !is_scalar_prop(value.data.get_prop->record);
+	case AST_VALUE_GET_INDEX:
+	case AST_VALUE_BINARY_OP:
+		return value.affects_state;
+	default:
+		return 0;
+	}
+}
 
 static int compile_code_block(compiler_t* compiler, ast_code_block_t code_block, ast_proc_t* proc, uint16_t continue_ip, uint16_t* break_jumps, uint8_t* break_jump_top);
 static machine_type_sig_t* compiler_define_typesig(compiler_t* compiler, ast_proc_t* proc, typecheck_type_t type);
@@ -246,11 +798,170 @@ static int compile_value_free(compiler_t* compiler, ast_value_t value, ast_proc_
 	return compile_force_free(compiler, compiler->eval_regs[value.id], value.type, proc, value.free_status);
 }
 
+//the entry point of a call's target, or 0 if it's only known at runtime
+static uint16_t proc_call_direct_ip(compiler_t* compiler, ast_call_proc_t* proc_call) {
+	if (proc_call->procedure.value_type == AST_VALUE_VAR)
+		return compiler->proc_ips[proc_call->procedure.data.variable->id];
+	else if (proc_call->procedure.value_type == AST_VALUE_PROC)
+		return compiler->proc_ips[proc_call->procedure.data.procedure->thisproc->id];
+	return 0;
+}
+
+//a call in tail position can reuse its caller's frame if its target is known, it pushes no atom type signatures, and every argument allocated in the caller's gc frame can be traced out of it
+static int is_tail_call(compiler_t* compiler, ast_value_t value, ast_proc_t* proc) {
+	if (!proc || value.value_type != AST_VALUE_PROC_CALL || !proc_call_direct_ip(compiler, value.data.proc_call))
+		return 0;
+	if (compiler->inlined_calls[value.data.proc_call->id]) //an inlined body falls through rather than returning, so it's compiled as an ordinary call
+		return 0;
+	if (typecheck_has_type(value.type, TYPE_TYPEARG))
+		for (uint_fast8_t i = 0; i < value.data.proc_call->procedure.type.type_id; i++)
+			if (value.data.proc_call->typeargs[i].type != TYPE_TYPEARG)
+				return 0;
+	for (uint_fast8_t i = 0; i < value.data.proc_call->argument_count; i++)
+		if (value.data.proc_call->arguments[i].gc_status == POSTPROC_GC_UNKOWN_ALLOC)
+			return 0;
+	return 1;
+}
+
+static int compile_value(compiler_t* compiler, ast_value_t value, ast_proc_t* proc);
+
+static int compile_return_value(compiler_t* compiler, ast_value_t value, ast_proc_t* proc) {
+	ESCAPE_ON_FAIL(compile_value(compiler, value, proc));
+	compiler_reg_t src_reg = compiler->eval_regs[value.id];
+	if (compiler->move_eval[value.id] && !(!src_reg.reg && src_reg.offset)) {
+		EMIT_INS(INS2(COMPILER_OP_CODE_MOVE, LOC_REG(0), src_reg));
+		LAST_INS.dead_regs = eval_reg_is_temp(compiler, value) << 1;
+	}
+	if (value.gc_status == POSTPROC_GC_LOCAL_ALLOC)
+		EMIT_INS(INS1(COMPILER_OP_CODE_GC_TRACE, LOC_REG(0)))
+	else if (value.gc_status == POSTPROC_GC_LOCAL_DYNAMIC)
+		EMIT_INS(INS2(COMPILER_OP_CODE_DYNAMIC_TRACE, LOC_REG(0), TYPEARG_INFO_REG(value.type)));
+	return 1;
+}
+
+//moves the frame registers of the instructions emitted since start_ip up by offset, along with the frame offsets of any calls they make
+static void shift_frame_regs(compiler_t* compiler, uint16_t start_ip, uint16_t offset) {
+	for (uint_fast16_t i = start_ip; i < compiler->ins_builder.instruction_count; i++) {
+		compiler_ins_t* ins = &compiler->ins_builder.instructions[i];
+		for (uint_fast8_t j = 0; j < 3; j++)
+			if (ins->regs[j].offset)
+				ins->regs[j].reg += offset;
+
+		if (ins->op_code == COMPILER_OP_CODE_CALL || ins->op_code == COMPILER_OP_CODE_CALL_DIRECT)
+			ins->regs[1].reg += offset;
+		else if (ins->op_code == COMPILER_OP_CODE_STACK_DEOFFSET)
+			ins->regs[0].reg += offset;
+	}
+}
+
+//inlined instructions keep the callee's source locations, copied once per expansion so that each copy's range only covers its own call site
+static int inline_src_loc(compiler_t* compiler, uint32_t* src_loc_id) {
+	if (!compiler->inline_stamp)
+		return 1;
+	if (compiler->inline_loc_stamps[*src_loc_id] != compiler->inline_stamp) {
+		PANIC_ON_FAIL(debug_table_inline_loc(compiler->ast->dbg_table, *src_loc_id, compiler->inline_call_loc, &compiler->inline_locs[*src_loc_id]), compiler, ERROR_MEMORY);
+		compiler->inline_loc_stamps[*src_loc_id] = compiler->inline_stamp;
+	}
+	*src_loc_id = compiler->inline_locs[*src_loc_id];
+	return 1;
+}
+
+//compiles the callee's body as if it were called with a frame at offset, then moves its registers onto that frame
+static int compile_inlined_call(compiler_t* compiler, ast_proc_t* callee, uint16_t offset, uint32_t call_loc_id) {
+	uint16_t start_ip = compiler->ins_builder.instruction_count;
+	ast_statement_t* body = callee->exec_block.instructions;
+
+	uint32_t outer_stamp = compiler->inline_stamp, outer_call_loc = compiler->inline_call_loc;
+	ESCAPE_ON_FAIL(inline_src_loc(compiler, &call_loc_id));
+	compiler->inline_stamp = ++compiler->inline_expansions;
+	compiler->inline_call_loc = call_loc_id;
+
+	compiler->inline_depth++;
+	compiler->inline_offset += offset;
+	if (body->type == AST_STATEMENT_RETURN_VALUE)
+		ESCAPE_ON_FAIL(compile_return_value(compiler, body->data.value, callee))
+	else {
+		ESCAPE_ON_FAIL(compile_value(compiler, body->data.value, callee));
+		ESCAPE_ON_FAIL(compile_value_free(compiler, body->data.value, callee));
+	}
+	compiler->inline_offset -= offset;
+	compiler->inline_depth--;
+	compiler->inline_stamp = outer_stamp;
+	compiler->inline_call_loc = outer_call_loc;
+
+	shift_frame_regs(compiler, start_ip, offset);
+	return 1;
+}
+
+static int compile_proc_call(compiler_t* compiler, ast_value_t value, ast_proc_t* proc, int is_tail) {
+	for (uint_fast8_t i = 0; i < value.data.proc_call->argument_count; i++) {
+		ESCAPE_ON_FAIL(compile_value(compiler, value.data.proc_call->arguments[i], proc));
+		if (compiler->move_eval[value.data.proc_call->arguments[i].id])
+			EMIT_INS(INS2(COMPILER_OP_CODE_MOVE, LOC_REG(compiler->proc_call_offsets[value.data.proc_call->id] + i + 1), compiler->eval_regs[value.data.proc_call->arguments[i].id]));
+	}
+	ESCAPE_ON_FAIL(compile_value(compiler, value.data.proc_call->procedure, proc));
+
+	uint16_t type_sigs_to_pop = 0;
+	if (value.data.proc_call->procedure.type.type_id) {
+		uint16_t gen_arg_reg = value.data.proc_call->argument_count + 1 + compiler->proc_call_offsets[value.data.proc_call->id];
+		for (uint_fast8_t i = 0; i < value.data.proc_call->procedure.type.type_id; i++) {
+			//if (value.data.proc_call->procedure.type.sub_types[i].type == TYPE_ANY) {
+			if (value.data.proc_call->typeargs[i].type == TYPE_TYPEARG)
+				EMIT_INS(INS2(COMPILER_OP_CODE_MOVE, LOC_REG(gen_arg_reg++), TYPEARG_INFO_REG(value.data.proc_call->typeargs[i])))
+			else {
+				machine_type_sig_t* sig;
+				ESCAPE_ON_FAIL(sig = compiler_define_typesig(compiler, proc, value.data.proc_call->typeargs[i]))
+				if (typecheck_has_type(value.type, TYPE_TYPEARG)) {
+					EMIT_INS(INS3(COMPILER_OP_CODE_SET, LOC_REG(gen_arg_reg++), GLOB_REG(sig - compiler->target_machine->defined_signatures), GLOB_REG(1)));
+					type_sigs_to_pop++;
+				}
+				else
+					EMIT_INS(INS3(COMPILER_OP_CODE_SET, LOC_REG(gen_arg_reg++), GLOB_REG(sig - compiler->target_machine->defined_signatures), GLOB_REG(0)));
+			}
+			//}
+		}
+	}
+
+	uint16_t direct_ip = proc_call_direct_ip(compiler, value.data.proc_call);
+	if (compiler->inlined_calls[value.data.proc_call->id]) {
+		ESCAPE_ON_FAIL(compile_inlined_call(compiler, compiler->inlined_calls[value.data.proc_call->id], compiler->proc_call_offsets[value.data.proc_call->id], value.src_loc_id));
+		if (type_sigs_to_pop)
+			EMIT_INS(INS1(COMPILER_OP_CODE_POP_ATOM_TYPESIGS, GLOB_REG(type_sigs_to_pop)));
+		return 1;
+	}
+	else if (is_tail) {
+		//the caller's gc frame is cleaned before its registers are reused, so locally allocated arguments are traced into the frame below
+		if (proc->do_gc) {
+			for (uint_fast8_t i = 0; i < value.data.proc_call->argument_count; i++) {
+				if (value.data.proc_call->arguments[i].gc_status == POSTPROC_GC_LOCAL_ALLOC)
+					EMIT_INS(INS1(COMPILER_OP_CODE_GC_TRACE, LOC_REG(compiler->proc_call_offsets[value.data.proc_call->id] + i + 1)))
+				else if (value.data.proc_call->arguments[i].gc_status == POSTPROC_GC_LOCAL_DYNAMIC)
+					EMIT_INS(INS2(COMPILER_OP_CODE_DYNAMIC_TRACE, LOC_REG(compiler->proc_call_offsets[value.data.proc_call->id] + i + 1), TYPEARG_INFO_REG(value.data.proc_call->arguments[i].type)));
+			}
+			EMIT_INS(INS0(COMPILER_OP_CODE_GC_CLEAN));
+		}
+		EMIT_INS(INS3(COMPILER_OP_CODE_TAIL_CALL, GLOB_REG(direct_ip), GLOB_REG(compiler->proc_call_offsets[value.data.proc_call->id]), GLOB_REG(value.data.proc_call->argument_count + value.data.proc_call->procedure.type.type_id)));
+		return 1;
+	}
+
+	if (direct_ip)
+		EMIT_INS(INS2(COMPILER_OP_CODE_CALL_DIRECT, GLOB_REG(direct_ip), GLOB_REG(compiler->proc_call_offsets[value.data.proc_call->id])))
+	else
+		EMIT_INS(INS2(COMPILER_OP_CODE_CALL, compiler->eval_regs[value.data.proc_call->procedure.id], GLOB_REG(compiler->proc_call_offsets[value.data.proc_call->id])));
+	if (type_sigs_to_pop)
+		EMIT_INS(INS1(COMPILER_OP_CODE_POP_ATOM_TYPESIGS, GLOB_REG(type_sigs_to_pop)));
+	if (compiler->proc_call_offsets[value.data.proc_call->id])
+		EMIT_INS(INS1(COMPILER_OP_CODE_STACK_DEOFFSET, GLOB_REG(compiler->proc_call_offsets[value.data.proc_call->id])));
+	return 1;
+}
+
 static int compile_value(compiler_t* compiler, ast_value_t value, ast_proc_t* proc) {
-	if (!value.affects_state)
+	if (!value.affects_state || compiler->hoisted[value.id])
 		return 1;
 
-	debug_loc_set_minip(compiler->ast->dbg_table, value.src_loc_id, compiler->ins_builder.instruction_count);
+	uint32_t src_loc_id = value.src_loc_id;
+	ESCAPE_ON_FAIL(inline_src_loc(compiler, &src_loc_id));
+	debug_loc_set_minip(compiler->ast->dbg_table, src_loc_id, compiler->ins_builder.instruction_count);
 
 	switch (value.value_type)
 	{
@@ -280,14 +991,19 @@ static int compile_value(compiler_t* compiler, ast_value_t value, ast_proc_t* pr
 		ESCAPE_ON_FAIL(sig = compiler_define_typesig(compiler, proc, value.type));
 		EMIT_INS(INS3(COMPILER_OP_CODE_CONFIG_TYPESIG, compiler->eval_regs[value.id], GLOB_REG(sig - compiler->target_machine->defined_signatures), GLOB_REG(typecheck_has_type(value.type, TYPE_TYPEARG))));
 
+		//every element is written, so the init bits are set all at once afterwards, leaving them clear for any trace that runs while the elements are evaluated
 		for (uint_fast32_t i = 0; i < value.data.array_literal.element_count; i++) {
 			ESCAPE_ON_FAIL(compile_value(compiler, value.data.array_literal.elements[i], proc));
-			EMIT_INS(INS3(COMPILER_OP_CODE_STORE_ALLOC_I, compiler->eval_regs[value.id], compiler->eval_regs[value.data.array_literal.elements[i].id], GLOB_REG(i)));
+			EMIT_INS(INS3(COMPILER_OP_CODE_STORE_ALLOC_I_INIT, compiler->eval_regs[value.id], compiler->eval_regs[value.data.array_literal.elements[i].id], GLOB_REG(i)));
 		}
+		if (value.data.array_literal.element_count)
+			EMIT_INS(INS2(COMPILER_OP_CODE_CONF_INIT_ALL, compiler->eval_regs[value.id], GLOB_REG(value.data.array_literal.element_count)));
 		break;
 	}
 	case AST_VALUE_ALLOC_RECORD: {
-		EMIT_INS(INS3(COMPILER_OP_CODE_ALLOC_I, compiler->eval_regs[value.id], GLOB_REG(value.data.alloc_record.proto->index_offset + value.data.alloc_record.proto->property_count), GLOB_REG(value.data.alloc_record.proto->do_gc ? GC_TRACE_MODE_SOME : GC_TRACE_MODE_NONE)));
+		compiler->record_allocs++;
+		int born_initialized = is_born_initialized(compiler, value.data.alloc_record.proto);
+		EMIT_INS(INS3(born_initialized ? COMPILER_OP_CODE_ALLOC_I_INIT : COMPILER_OP_CODE_ALLOC_I, compiler->eval_regs[value.id], GLOB_REG(value.data.alloc_record.proto->index_offset + value.data.alloc_record.proto->property_count), GLOB_REG(value.data.alloc_record.proto->do_gc ? GC_TRACE_MODE_SOME : GC_TRACE_MODE_NONE)));
 
 		machine_type_sig_t* sig;
 		ESCAPE_ON_FAIL(sig = compiler_define_typesig(compiler, proc, value.type));
@@ -298,7 +1014,7 @@ static int compile_value(compiler_t* compiler, ast_value_t value, ast_proc_t* pr
 
 		for (uint_fast16_t i = 0; i < value.data.alloc_record.init_value_count; i++) {
 			ESCAPE_ON_FAIL(compile_value(compiler, value.data.alloc_record.init_values[i].value, proc));
-			EMIT_INS(INS3(COMPILER_OP_CODE_STORE_ALLOC_I, compiler->eval_regs[value.id], compiler->eval_regs[value.data.alloc_record.init_values[i].value.id], GLOB_REG(value.data.alloc_record.init_values[i].property->id)));
+			EMIT_INS(INS3(born_initialized ? COMPILER_OP_CODE_STORE_ALLOC_I_INIT : COMPILER_OP_CODE_STORE_ALLOC_I, compiler->eval_regs[value.id], compiler->eval_regs[value.data.alloc_record.init_values[i].value.id], GLOB_REG(value.data.alloc_record.init_values[i].property->id)));
 		}
 
 		ast_record_proto_t* current_proto = value.data.alloc_record.proto;
@@ -330,6 +1046,7 @@ static int compile_value(compiler_t* compiler, ast_value_t value, ast_proc_t* pr
 		EMIT_INS(INS0(COMPILER_OP_CODE_JUMP));
 
 		compiler->ins_builder.instructions[start_ip].regs[1] = GLOB_REG(compiler->ins_builder.instruction_count);
+		compiler->proc_ips[value.data.procedure->thisproc->id] = compiler->ins_builder.instruction_count;
 		EMIT_INS(INS1(COMPILER_OP_CODE_STACK_VALIDATE, GLOB_REG(compiler->proc_call_max_locals[value.data.procedure->id])));
 		if (value.data.procedure->do_gc)
 			EMIT_INS(INS0(COMPILER_OP_CODE_GC_NEW_FRAME));
@@ -344,6 +1061,7 @@ static int compile_value(compiler_t* compiler, ast_value_t value, ast_proc_t* pr
 			if (compiler->move_eval[value.data.set_var->set_value.id]) {
 				ESCAPE_ON_FAIL(compile_force_free(compiler, compiler->var_regs[value.data.set_var->var_info->id], value.data.set_var->var_info->type, proc, value.data.set_var->var_info->type.type == TYPE_TYPEARG ? POSTPROC_FREE_DYNAMIC : IS_REF_TYPE(value.data.set_var->var_info->type) ? POSTPROC_FREE : POSTPROC_FREE_NONE));
 				EMIT_INS(INS2(COMPILER_OP_CODE_MOVE, compiler->var_regs[value.data.set_var->var_info->id], compiler->eval_regs[value.data.set_var->set_value.id]));
+				LAST_INS.dead_regs = eval_reg_is_temp(compiler, value.data.set_var->set_value) << 1;
 			}
 		}
 		else if (value.data.set_var->set_value.affects_state) {
@@ -354,17 +1072,20 @@ static int compile_value(compiler_t* compiler, ast_value_t value, ast_proc_t* pr
 	case AST_VALUE_SET_INDEX:
 		if (value.data.set_index->array.affects_state) {
 			ESCAPE_ON_FAIL(compile_value(compiler, value.data.set_index->array, proc));
-			if (value.data.set_index->index.value_type != AST_VALUE_PRIMITIVE)
+			if (!is_immediate_index(value.data.set_index->index))
 				ESCAPE_ON_FAIL(compile_value(compiler, value.data.set_index->index, proc));
 			ESCAPE_ON_FAIL(compile_value(compiler, value.data.set_index->value, proc));
 
 			if (value.data.set_index->array.type.sub_types[0].type == TYPE_TYPEARG || IS_REF_TYPE(*value.data.set_index->array.type.sub_types))
 				EMIT_INS(INS2(COMPILER_OP_CODE_TYPEGUARD_PROTECT_ARRAY, compiler->eval_regs[value.data.set_index->array.id], compiler->eval_regs[value.data.set_index->value.id]));
 
-			if (value.data.set_index->index.value_type == AST_VALUE_PRIMITIVE)
+			if (is_immediate_index(value.data.set_index->index))
 				EMIT_INS(INS3(COMPILER_OP_CODE_STORE_ALLOC_I_BOUND, compiler->eval_regs[value.data.set_index->array.id], compiler->eval_regs[value.data.set_index->value.id], GLOB_REG(value.data.set_index->index.data.primitive->data.long_int)))
-			else
-				EMIT_INS(INS3(COMPILER_OP_CODE_STORE_ALLOC, compiler->eval_regs[value.data.set_index->array.id], compiler->eval_regs[value.data.set_index->index.id], compiler->eval_regs[value.data.set_index->value.id]));
+			else {
+				compiler->bounds_checks++;
+				compiler->eliminated_bounds_checks += compiler->unchecked_indices[value.id];
+				EMIT_INS(INS3(compiler->unchecked_indices[value.id] ? COMPILER_OP_CODE_STORE_ALLOC_UNCHECKED : COMPILER_OP_CODE_STORE_ALLOC, compiler->eval_regs[value.data.set_index->array.id], compiler->eval_regs[value.data.set_index->index.id], compiler->eval_regs[value.data.set_index->value.id]));
+			}
 			ESCAPE_ON_FAIL(compile_value_free(compiler, value.data.set_index->array, proc));
 		}
 		else if (value.data.set_index->value.affects_state) {
@@ -373,7 +1094,12 @@ static int compile_value(compiler_t* compiler, ast_value_t value, ast_proc_t* pr
 		}
 		break;
 	case AST_VALUE_SET_PROP:
-		if (value.data.set_prop->record.affects_state) {
+		if (is_scalar_prop(value.data.set_prop->record)) {
+			ESCAPE_ON_FAIL(compile_value(compiler, value.data.set_prop->value, proc));
+			EMIT_INS(INS2(COMPILER_OP_CODE_MOVE, compiler->eval_regs[value.id], compiler->eval_regs[value.data.set_prop->value.id]));
+			LAST_INS.dead_regs = eval_reg_is_temp(compiler, value.data.set_prop->value) << 1;
+		}
+		else if (value.data.set_prop->record.affects_state) {
 			ESCAPE_ON_FAIL(compile_value(compiler, value.data.set_prop->record, proc));
 			ESCAPE_ON_FAIL(compile_value(compiler, value.data.set_prop->value, proc));
 
@@ -399,7 +1125,8 @@ static int compile_value(compiler_t* compiler, ast_value_t value, ast_proc_t* pr
 				}
 			}
 
-			EMIT_INS(INS3(COMPILER_OP_CODE_STORE_ALLOC_I, compiler->eval_regs[value.data.set_prop->record.id], compiler->eval_regs[value.data.set_prop->value.id], GLOB_REG(value.data.set_prop->property->id)));
+			//a property every allocation sets already has its init bit, if the record has any
+			EMIT_INS(INS3(value.data.set_prop->property->maybe_uninit ? COMPILER_OP_CODE_STORE_ALLOC_I : COMPILER_OP_CODE_STORE_ALLOC_I_INIT, compiler->eval_regs[value.data.set_prop->record.id], compiler->eval_regs[value.data.set_prop->value.id], GLOB_REG(value.data.set_prop->property->id)));
 			ESCAPE_ON_FAIL(compile_value_free(compiler, value.data.set_prop->record, proc));
 		}
 		else if (value.data.set_prop->value.affects_state) {
@@ -409,17 +1136,21 @@ static int compile_value(compiler_t* compiler, ast_value_t value, ast_proc_t* pr
 		break;
 	case AST_VALUE_GET_INDEX:
 		ESCAPE_ON_FAIL(compile_value(compiler, value.data.get_index->array, proc));
-		if (value.data.get_index->index.value_type == AST_VALUE_PRIMITIVE)
+		if (is_immediate_index(value.data.get_index->index))
 			EMIT_INS(INS3(COMPILER_OP_CODE_LOAD_ALLOC_I_BOUND, compiler->eval_regs[value.data.get_index->array.id], compiler->eval_regs[value.id], GLOB_REG(value.data.get_index->index.data.primitive->data.long_int)))
 		else {
 			ESCAPE_ON_FAIL(compile_value(compiler, value.data.get_index->index, proc));
-			EMIT_INS(INS3(COMPILER_OP_CODE_LOAD_ALLOC, compiler->eval_regs[value.data.get_index->array.id], compiler->eval_regs[value.data.get_index->index.id], compiler->eval_regs[value.id]));
+			compiler->bounds_checks++;
+			compiler->eliminated_bounds_checks += compiler->unchecked_indices[value.id];
+			EMIT_INS(INS3(compiler->unchecked_indices[value.id] ? COMPILER_OP_CODE_LOAD_ALLOC_UNCHECKED : COMPILER_OP_CODE_LOAD_ALLOC, compiler->eval_regs[value.data.get_index->array.id], compiler->eval_regs[value.data.get_index->index.id], compiler->eval_regs[value.id]));
 		}
 		ESCAPE_ON_FAIL(compile_value_free(compiler, value.data.get_index->array, proc));
 		break;
 	case AST_VALUE_GET_PROP:
+		if (is_scalar_prop(value.data.get_prop->record))
+			break;
 		ESCAPE_ON_FAIL(compile_value(compiler, value.data.get_prop->record, proc));
-		EMIT_INS(INS3(COMPILER_OP_CODE_LOAD_ALLOC_I, compiler->eval_regs[value.data.get_prop->record.id], compiler->eval_regs[value.id], GLOB_REG(value.data.get_prop->property->id)));
+		EMIT_INS(INS3(value.data.get_prop->property->maybe_uninit ? COMPILER_OP_CODE_LOAD_ALLOC_I : COMPILER_OP_CODE_LOAD_ALLOC_I_INIT, compiler->eval_regs[value.data.get_prop->record.id], compiler->eval_regs[value.id], GLOB_REG(value.data.get_prop->property->id)));
 		ESCAPE_ON_FAIL(compile_value_free(compiler, value.data.get_prop->record, proc));
 		break;
 	case AST_VALUE_BINARY_OP: {
@@ -443,6 +1174,7 @@ static int compile_value(compiler_t* compiler, ast_value_t value, ast_proc_t* pr
 				EMIT_INS(INS3(COMPILER_OP_CODE_LONG_MORE + (value.data.binary_op->operator - TOK_MORE), lhs, rhs, compiler->eval_regs[value.id]))
 			else
 				EMIT_INS(INS3(COMPILER_OP_CODE_FLOAT_MORE + (value.data.binary_op->operator - TOK_MORE), lhs, rhs, compiler->eval_regs[value.id]))
+			LAST_INS.dead_regs = eval_reg_is_temp(compiler, value.data.binary_op->lhs) | (eval_reg_is_temp(compiler, value.data.binary_op->rhs) << 1);
 		}
 		ESCAPE_ON_FAIL(compile_value_free(compiler, value.data.binary_op->lhs, proc));
 		ESCAPE_ON_FAIL(compile_value_free(compiler, value.data.binary_op->rhs, proc));
@@ -503,42 +1235,9 @@ static int compile_value(compiler_t* compiler, ast_value_t value, ast_proc_t* pr
 		}
 		break;
 	}
-	case AST_VALUE_PROC_CALL: {
-		for (uint_fast8_t i = 0; i < value.data.proc_call->argument_count; i++) {
-			ESCAPE_ON_FAIL(compile_value(compiler, value.data.proc_call->arguments[i], proc));
-			if (compiler->move_eval[value.data.proc_call->arguments[i].id])
-				EMIT_INS(INS2(COMPILER_OP_CODE_MOVE, LOC_REG(compiler->proc_call_offsets[value.data.proc_call->id] + i + 1), compiler->eval_regs[value.data.proc_call->arguments[i].id]));
-		}
-		ESCAPE_ON_FAIL(compile_value(compiler, value.data.proc_call->procedure, proc));
-
-		uint16_t type_sigs_to_pop = 0;
-		if (value.data.proc_call->procedure.type.type_id) {
-			uint16_t gen_arg_reg = value.data.proc_call->argument_count + 1 + compiler->proc_call_offsets[value.data.proc_call->id];
-			for (uint_fast8_t i = 0; i < value.data.proc_call->procedure.type.type_id; i++) {
-				//if (value.data.proc_call->procedure.type.sub_types[i].type == TYPE_ANY) {
-				if (value.data.proc_call->typeargs[i].type == TYPE_TYPEARG)
-					EMIT_INS(INS2(COMPILER_OP_CODE_MOVE, LOC_REG(gen_arg_reg++), TYPEARG_INFO_REG(value.data.proc_call->typeargs[i])))
-				else {
-					machine_type_sig_t* sig;
-					ESCAPE_ON_FAIL(sig = compiler_define_typesig(compiler, proc, value.data.proc_call->typeargs[i]))
-					if (typecheck_has_type(value.type, TYPE_TYPEARG)) {
-						EMIT_INS(INS3(COMPILER_OP_CODE_SET, LOC_REG(gen_arg_reg++), GLOB_REG(sig - compiler->target_machine->defined_signatures), GLOB_REG(1)));
-						type_sigs_to_pop++;
-					}
-					else
-						EMIT_INS(INS3(COMPILER_OP_CODE_SET, LOC_REG(gen_arg_reg++), GLOB_REG(sig - compiler->target_machine->defined_signatures), GLOB_REG(0)));
-				}
-				//}
-			}
-		}
-
-		EMIT_INS(INS2(COMPILER_OP_CODE_CALL, compiler->eval_regs[value.data.proc_call->procedure.id], GLOB_REG(compiler->proc_call_offsets[value.data.proc_call->id])));
-		if (type_sigs_to_pop)
-			EMIT_INS(INS1(COMPILER_OP_CODE_POP_ATOM_TYPESIGS, GLOB_REG(type_sigs_to_pop)));
-		if (compiler->proc_call_offsets[value.data.proc_call->id])
-			EMIT_INS(INS1(COMPILER_OP_CODE_STACK_DEOFFSET, GLOB_REG(compiler->proc_call_offsets[value.data.proc_call->id])));
+	case AST_VALUE_PROC_CALL:
+		ESCAPE_ON_FAIL(compile_proc_call(compiler, value, proc, 0));
 		break;
-	}
 	case AST_VALUE_FOREIGN:
 		ESCAPE_ON_FAIL(compile_value(compiler, value.data.foreign->op_id, proc));
 		if (value.data.foreign->input) {
@@ -558,12 +1257,18 @@ static int compile_value(compiler_t* compiler, ast_value_t value, ast_proc_t* pr
 	else if (value.trace_status == POSTPROC_TRACE_DYNAMIC && (proc && proc->do_gc))
 		EMIT_INS(INS2(COMPILER_OP_CODE_DYNAMIC_TRACE, compiler->eval_regs[value.id], TYPEARG_INFO_REG(value.type)));
 
-	debug_loc_set_maxip(compiler->ast->dbg_table, value.src_loc_id, compiler->ins_builder.instruction_count);
+	debug_loc_set_maxip(compiler->ast->dbg_table, src_loc_id, compiler->ins_builder.instruction_count);
 	return 1;
 }
 
 static int compile_conditional(compiler_t* compiler, ast_cond_t* conditional, ast_proc_t* proc, uint16_t continue_ip, uint16_t* break_jumps, uint8_t* break_jump_top) {
 	if (conditional->next_if_true) {
+		for (uint_fast8_t i = 0; i < conditional->invariant_count; i++) {
+			compiler->hoisted[conditional->invariants[i]->id] = 0;
+			ESCAPE_ON_FAIL(compile_value(compiler, *conditional->invariants[i], proc));
+			compiler->hoisted[conditional->invariants[i]->id] = 1;
+		}
+
 		uint16_t this_continue_ip = compiler->ins_builder.instruction_count;
 		ESCAPE_ON_FAIL(compile_value(compiler, *conditional->condition, proc));
 		uint16_t this_break_ip = compiler->ins_builder.instruction_count;
@@ -572,6 +1277,7 @@ static int compile_conditional(compiler_t* compiler, ast_cond_t* conditional, as
 		uint8_t lp_break_jump_count = 0;
 
 		EMIT_INS(INS1(COMPILER_OP_CODE_JUMP_CHECK, compiler->eval_regs[conditional->condition->id]));
+		LAST_INS.dead_regs = eval_reg_is_temp(compiler, *conditional->condition);
 		ESCAPE_ON_FAIL(compile_value_free(compiler, *conditional->condition, proc));
 		ESCAPE_ON_FAIL(compile_code_block(compiler, conditional->exec_block, proc, this_continue_ip, lp_break_jumps, &lp_break_jump_count));
 		EMIT_INS(INS1(COMPILER_OP_CODE_JUMP, GLOB_REG(this_continue_ip)));
@@ -596,6 +1302,7 @@ static int compile_conditional(compiler_t* compiler, ast_cond_t* conditional, as
 				ESCAPE_ON_FAIL(compile_value(compiler, *conditional->condition, proc));
 				uint16_t move_next_ip = compiler->ins_builder.instruction_count;
 				EMIT_INS(INS1(COMPILER_OP_CODE_JUMP_CHECK, compiler->eval_regs[conditional->condition->id]));
+				LAST_INS.dead_regs = eval_reg_is_temp(compiler, *conditional->condition);
 				ESCAPE_ON_FAIL(compile_value_free(compiler, *conditional->condition, proc));
 				ESCAPE_ON_FAIL(compile_code_block(compiler, conditional->exec_block, proc, continue_ip, break_jumps, break_jump_top));
 				if (conditional->next_if_false) {
@@ -621,10 +1328,26 @@ static int compile_code_block(compiler_t* compiler, ast_code_block_t code_block,
 		debug_loc_set_minip(compiler->ast->dbg_table, current_statement->src_loc_id, compiler->ins_builder.instruction_count);
 		switch (current_statement->type) {
 		case AST_STATEMENT_DECL_VAR:
-			if (current_statement->data.var_decl.var_info->is_used) {
+			if (current_statement->data.var_decl.var_info->is_scalar_replaced) {
+				ast_alloc_record_t alloc_record = current_statement->data.var_decl.set_value.data.alloc_record;
+				for (uint_fast16_t i = 0; i < alloc_record.init_value_count; i++) {
+					ESCAPE_ON_FAIL(compile_value(compiler, alloc_record.init_values[i].value, proc));
+					if (compiler->move_eval[alloc_record.init_values[i].value.id]) {
+						EMIT_INS(INS2(COMPILER_OP_CODE_MOVE, LOC_REG(compiler->var_regs[current_statement->data.var_decl.var_info->id].reg + alloc_record.init_values[i].property->id), compiler->eval_regs[alloc_record.init_values[i].value.id]));
+						LAST_INS.dead_regs = eval_reg_is_temp(compiler, alloc_record.init_values[i].value) << 1;
+					}
+				}
+				compiler->record_allocs++;
+				compiler->eliminated_record_allocs++;
+			}
+			else if (current_statement->data.var_decl.var_info->is_used) {
 				ESCAPE_ON_FAIL(compile_value(compiler, current_statement->data.var_decl.set_value, proc));
-				if (compiler->move_eval[current_statement->data.var_decl.set_value.id])
+				if (compiler->move_eval[current_statement->data.var_decl.set_value.id]) {
 					EMIT_INS(INS2(COMPILER_OP_CODE_MOVE, compiler->var_regs[current_statement->data.var_decl.var_info->id], compiler->eval_regs[current_statement->data.var_decl.set_value.id]));
+					LAST_INS.dead_regs = eval_reg_is_temp(compiler, current_statement->data.var_decl.set_value) << 1;
+				}
+				else if (current_statement->data.var_decl.set_value.value_type == AST_VALUE_PROC) //the variable aliases the procedure's own register, which only its label writes
+					compiler->proc_ips[current_statement->data.var_decl.var_info->id] = compiler->proc_ips[current_statement->data.var_decl.set_value.data.procedure->thisproc->id];
 			}
 			else if (current_statement->data.var_decl.set_value.affects_state)
 				ESCAPE_ON_FAIL(compile_value(compiler, current_statement->data.var_decl.set_value, proc));
@@ -633,19 +1356,22 @@ static int compile_code_block(compiler_t* compiler, ast_code_block_t code_block,
 			ESCAPE_ON_FAIL(compile_conditional(compiler, current_statement->data.conditional, proc, continue_ip, break_jumps, break_jump_top));
 			break;
 		case AST_STATEMENT_VALUE:
+			if (current_statement + 1 != &code_block.instructions[code_block.instruction_count] && current_statement[1].type == AST_STATEMENT_RETURN &&
+				current_statement->data.value.type.type == TYPE_NOTHING && is_tail_call(compiler, current_statement->data.value, proc)) {
+				debug_loc_set_minip(compiler->ast->dbg_table, current_statement->data.value.src_loc_id, compiler->ins_builder.instruction_count);
+				ESCAPE_ON_FAIL(compile_proc_call(compiler, current_statement->data.value, proc, 1));
+				break;
+			}
 			ESCAPE_ON_FAIL(compile_value(compiler, current_statement->data.value, proc));
 			ESCAPE_ON_FAIL(compile_value_free(compiler, current_statement->data.value, proc));
 			break;
-		case AST_STATEMENT_RETURN_VALUE: {
-			ESCAPE_ON_FAIL(compile_value(compiler, current_statement->data.value, proc));
-			compiler_reg_t src_reg = compiler->eval_regs[current_statement->data.value.id];
-			if (compiler->move_eval[current_statement->data.value.id] && !(!src_reg.reg && src_reg.offset))
-				EMIT_INS(INS2(COMPILER_OP_CODE_MOVE, LOC_REG(0), src_reg));
-			if (current_statement->data.value.gc_status == POSTPROC_GC_LOCAL_ALLOC)
-				EMIT_INS(INS1(COMPILER_OP_CODE_GC_TRACE, LOC_REG(0)))
-			else if (current_statement->data.value.gc_status == POSTPROC_GC_LOCAL_DYNAMIC)
-				EMIT_INS(INS2(COMPILER_OP_CODE_DYNAMIC_TRACE, LOC_REG(0), TYPEARG_INFO_REG(current_statement->data.value.type)));
-		}
+		case AST_STATEMENT_RETURN_VALUE:
+			if (is_tail_call(compiler, current_statement->data.value, proc)) {
+				debug_loc_set_minip(compiler->ast->dbg_table, current_statement->data.value.src_loc_id, compiler->ins_builder.instruction_count);
+				ESCAPE_ON_FAIL(compile_proc_call(compiler, current_statement->data.value, proc, 1));
+				break;
+			}
+			ESCAPE_ON_FAIL(compile_return_value(compiler, current_statement->data.value, proc));
 		case AST_STATEMENT_RETURN:
 			if (proc->do_gc)
 				EMIT_INS(INS0(COMPILER_OP_CODE_GC_CLEAN));
@@ -678,26 +1404,43 @@ static int compile_code_block(compiler_t* compiler, ast_code_block_t code_block,
 	return 1;
 }
 
-int compile(compiler_t* compiler, safe_gc_t* safe_gc, machine_t* target_machine, ast_t* ast) {
+int compile(compiler_t* compiler, safe_gc_t* safe_gc, machine_t* target_machine, ast_t* ast, int inline_procs, uint32_t max_stack_size, uint32_t max_frame_limit) {
 	compiler->target_machine = target_machine;
 	compiler->safe_gc = safe_gc;
 	compiler->ast = ast;
 	compiler->last_err = ERROR_NONE;
 	compiler->current_global = 0;
+	compiler->inline_procs = inline_procs;
+	compiler->inline_depth = 0;
+	compiler->inline_offset = 0;
+	compiler->top_level_inline_locals = 0;
+	compiler->inline_stamp = 0;
+	compiler->inline_expansions = 0;
+	compiler->bounds_checks = 0;
+	compiler->block_count = 0;
+	compiler->eliminated_bounds_checks = 0;
+	compiler->record_allocs = 0;
+	compiler->eliminated_record_allocs = 0;
 
 	PANIC_ON_FAIL(compiler->eval_regs = safe_malloc(safe_gc, ast->value_count * sizeof(compiler_reg_t)), compiler, ERROR_MEMORY);
 	PANIC_ON_FAIL(compiler->move_eval = safe_malloc(safe_gc, ast->value_count * sizeof(int)), compiler, ERROR_MEMORY);
 	PANIC_ON_FAIL(compiler->var_regs = safe_malloc(safe_gc, ast->var_decl_count * sizeof(compiler_reg_t)), compiler, ERROR_MEMORY);
 	PANIC_ON_FAIL(compiler->proc_call_offsets = safe_malloc(safe_gc, ast->proc_call_count * sizeof(uint16_t)), compiler, ERROR_MEMORY);
 	PANIC_ON_FAIL(compiler->proc_call_max_locals = safe_calloc(safe_gc, ast->proc_count, sizeof(uint16_t)), compiler, ERROR_MEMORY);
-	PANIC_ON_FAIL(init_machine(target_machine, UINT16_MAX / 8, 1000, ast->record_count), compiler, ERROR_MEMORY);
+	PANIC_ON_FAIL(compiler->proc_ips = safe_calloc(safe_gc, ast->var_decl_count, sizeof(uint16_t)), compiler, ERROR_MEMORY);
+	PANIC_ON_FAIL(compiler->var_procs = safe_calloc(safe_gc, ast->var_decl_count, sizeof(ast_proc_t*)), compiler, ERROR_MEMORY);
+	PANIC_ON_FAIL(compiler->inlined_calls = safe_calloc(safe_gc, ast->proc_call_count, sizeof(ast_proc_t*)), compiler, ERROR_MEMORY);
+	PANIC_ON_FAIL(compiler->hoisted = safe_calloc(safe_gc, ast->value_count, sizeof(uint8_t)), compiler, ERROR_MEMORY);
+	PANIC_ON_FAIL(compiler->unchecked_indices = safe_calloc(safe_gc, ast->value_count, sizeof(uint8_t)), compiler, ERROR_MEMORY);
+	PANIC_ON_FAIL(compiler->locals = safe_calloc(safe_gc, ast->var_decl_count, sizeof(compiler_local_t)), compiler, ERROR_MEMORY);
+	PANIC_ON_FAIL(compiler->inline_locs = safe_malloc(safe_gc, ast->dbg_table->src_loc_count * sizeof(uint32_t)), compiler, ERROR_MEMORY);
+	PANIC_ON_FAIL(compiler->inline_loc_stamps = safe_calloc(safe_gc, ast->dbg_table->src_loc_count, sizeof(uint32_t)), compiler, ERROR_MEMORY);
+	PANIC_ON_FAIL(init_machine(target_machine, max_stack_size, max_frame_limit, ast->record_count), compiler, ERROR_MEMORY);
 
 	//define standard type signatures (array<prim>)
 	for (typecheck_base_type_t prim = TYPE_PRIMITIVE_BOOL; prim <= TYPE_PRIMITIVE_FLOAT; prim++) {
-		machine_type_sig_t mybuf;
-		mybuf.super_signature = TYPE_SUPER_ARRAY;
-		PANIC_ON_FAIL(mybuf.sub_types = safe_transfer_malloc(compiler->safe_gc ,sizeof(machine_type_sig_t)), compiler, ERROR_MEMORY); //define array<char> typesig
-		mybuf.sub_types->super_signature = prim; mybuf.sub_types->sub_type_count = 0; mybuf.sub_type_count = 1;
+		machine_type_sig_t elem_sig = { .super_signature = prim, .sub_types = NULL, .sub_type_count = 0 };
+		machine_type_sig_t mybuf = { .super_signature = TYPE_SUPER_ARRAY, .sub_types = &elem_sig, .sub_type_count = 1 }; //define array<char> typesig
 		PANIC_ON_FAIL(machine_get_typesig(compiler->target_machine, &mybuf, 0), compiler, compiler->target_machine->last_err);
 	}
 
@@ -706,28 +1449,44 @@ int compile(compiler_t* compiler, safe_gc_t* safe_gc, machine_t* target_machine,
 	PANIC_ON_FAIL(init_ins_builder(&compiler->ins_builder, safe_gc), compiler, ERROR_MEMORY);
 
 	EMIT_INS(INS1(COMPILER_OP_CODE_STACK_OFFSET, GLOB_REG(compiler->ast->constant_count + compiler->current_global)));
+	if (compiler->top_level_inline_locals) //procedures inlined into top level code don't validate their own frames
+		EMIT_INS(INS1(COMPILER_OP_CODE_STACK_VALIDATE, GLOB_REG(compiler->top_level_inline_locals)));
 	EMIT_INS(INS0(COMPILER_OP_CODE_GC_NEW_FRAME));
 	ESCAPE_ON_FAIL(compile_code_block(compiler, ast->exec_block, NULL, 0, NULL, 0));
 	EMIT_INS(INS0(COMPILER_OP_CODE_GC_CLEAN));
 	EMIT_INS(INS1(COMPILER_OP_CODE_ABORT, GLOB_REG(ERROR_NONE)));
 
+	compiler->unoptimized_ins_count = compiler->ins_builder.instruction_count;
+	PANIC_ON_FAIL(peephole_optimize(&compiler->ins_builder, ast->dbg_table), compiler, ERROR_MEMORY);
+
 	safe_free(safe_gc, compiler->eval_regs);
 	safe_free(safe_gc, compiler->move_eval);
 	safe_free(safe_gc, compiler->var_regs);
 	safe_free(safe_gc, compiler->proc_call_offsets);
 	safe_free(safe_gc, compiler->proc_call_max_locals);
+	safe_free(safe_gc, compiler->proc_ips);
+	safe_free(safe_gc, compiler->var_procs);
+	safe_free(safe_gc, compiler->inlined_calls);
+	safe_free(safe_gc, compiler->hoisted);
+	safe_free(safe_gc, compiler->unchecked_indices);
+	safe_free(safe_gc, compiler->locals);
+	safe_free(safe_gc, compiler->inline_locs);
+	safe_free(safe_gc, compiler->inline_loc_stamps);
 
 	return 1;
 }
 
-static int compile_type_to_machine(machine_type_sig_t* out_sig, typecheck_type_t type, compiler_t* compiler, safe_gc_t* safe_gc, ast_proc_t* proc) {
+//builds a type signature straight into the target machine's interned form
+static int compile_type_to_machine(machine_type_sig_t* out_sig, typecheck_type_t type, compiler_t* compiler, ast_proc_t* proc) {
 	out_sig->sub_type_count = 0;
+	out_sig->sub_types = NULL;
 	if (type.type == TYPE_TYPEARG) {
 		out_sig->super_signature = TYPE_TYPEARG;
 		if (proc) {
 			compiler_reg_t info_reg = TYPEARG_INFO_REG(type);
 			//PANIC_ON_FAIL(info_reg.offset, compiler, ERROR_INTERNAL)
-			out_sig->sub_type_count = info_reg.reg;
+			PANIC_ON_FAIL(info_reg.reg + compiler->inline_offset <= UINT8_MAX, compiler, ERROR_INTERNAL);
+			out_sig->sub_type_count = info_reg.reg + compiler->inline_offset; //inlined typesigs read type arguments from the callee's frame, which starts at the call's offset
 		}
 		else
 			out_sig->sub_type_count = type.type_id;
@@ -745,9 +1504,10 @@ static int compile_type_to_machine(machine_type_sig_t* out_sig, typecheck_type_t
 
 	if (HAS_SUBTYPES(type)) {
 		if (type.sub_type_count) {
-			PANIC_ON_FAIL(out_sig->sub_types = safe_malloc(safe_gc, type.sub_type_count * sizeof(machine_type_sig_t)), compiler, ERROR_MEMORY);
+			machine_type_sig_t sub_types[TYPE_MAX_SUBTYPES];
 			for (uint_fast8_t i = 0; i < type.sub_type_count; i++)
-				ESCAPE_ON_FAIL(compile_type_to_machine(&out_sig->sub_types[i], type.sub_types[i], compiler, safe_gc, proc));
+				ESCAPE_ON_FAIL(compile_type_to_machine(&sub_types[i], type.sub_types[i], compiler, proc));
+			PANIC_ON_FAIL(out_sig->sub_types = typesig_intern(compiler->target_machine, sub_types, type.sub_type_count), compiler, compiler->target_machine->last_err);
 		}
 		out_sig->sub_type_count = type.sub_type_count;
 	}
@@ -756,23 +1516,135 @@ static int compile_type_to_machine(machine_type_sig_t* out_sig, typecheck_type_t
 }
 
 static machine_type_sig_t* compiler_define_typesig(compiler_t* compiler, ast_proc_t* proc, typecheck_type_t type) {
-	safe_gc_t temp_safe_gc;
-	ESCAPE_ON_FAIL(init_safe_gc(&temp_safe_gc));
-
 	machine_type_sig_t sig;
-	if (!compile_type_to_machine(&sig, type, compiler, &temp_safe_gc, proc)) {
-		free_safe_gc(&temp_safe_gc, 1);
-		return NULL;
+	ESCAPE_ON_FAIL(compile_type_to_machine(&sig, type, compiler, proc));
+	machine_type_sig_t* defined = machine_get_typesig(compiler->target_machine, &sig, 1);
+	PANIC_ON_FAIL(defined, compiler, compiler->target_machine->last_err);
+	return defined;
+}
+
+#define REGS_EQ(A, B) ((A).reg == (B).reg && (A).offset == (B).offset)
+#define FUSED_OP2(OP, A, B) ((OP) + ((!(A).offset) << 1) + !(B).offset)
+#define FUSED_OP3(OP, A, B, C) ((OP) + ((!(A).offset) << 2) + ((!(B).offset) << 1) + !(C).offset)
+
+//pairs hot instruction sequences into superinstructions. A superinstruction takes the slot of the first instruction of its pair and skips the second, which is left in place, so no jump targets or debug locations move.
+static void fuse_machine_ins(compiler_ins_t* compiler_ins, machine_ins_t* machine_ins, uint64_t ins_count) {
+	static const machine_op_code_t compare_jump_ops[] = {
+		MACHINE_OP_CODE_LONG_EQUAL_JUMP_CHECK_LL,
+		MACHINE_OP_CODE_FLOAT_EQUAL_JUMP_CHECK_LL,
+		MACHINE_OP_CODE_LONG_MORE_JUMP_CHECK_LL,
+		MACHINE_OP_CODE_LONG_LESS_JUMP_CHECK_LL,
+		MACHINE_OP_CODE_LONG_MORE_EQUAL_JUMP_CHECK_LL,
+		MACHINE_OP_CODE_LONG_LESS_EQUAL_JUMP_CHECK_LL,
+		MACHINE_OP_CODE_FLOAT_MORE_JUMP_CHECK_LL,
+		MACHINE_OP_CODE_FLOAT_LESS_JUMP_CHECK_LL,
+		MACHINE_OP_CODE_FLOAT_MORE_EQUAL_JUMP_CHECK_LL,
+		MACHINE_OP_CODE_FLOAT_LESS_EQUAL_JUMP_CHECK_LL
+	};
+
+	uint8_t* is_jump_target = calloc(ins_count + 1, sizeof(uint8_t));
+	if (!is_jump_target)
+		return; //superinstructions are only an optimization; the unfused instructions are still valid
+	for (uint_fast64_t i = 0; i < ins_count; i++) {
+		if (compiler_ins[i].op_code == COMPILER_OP_CODE_JUMP)
+			is_jump_target[compiler_ins[i].regs[0].reg] = 1;
+		else if (compiler_ins[i].op_code == COMPILER_OP_CODE_JUMP_CHECK || compiler_ins[i].op_code == COMPILER_OP_CODE_LABEL)
+			is_jump_target[compiler_ins[i].regs[1].reg] = 1;
 	}
 
-	uint16_t old_count = compiler->target_machine->defined_sig_count;
-	machine_type_sig_t* added = machine_get_typesig(compiler->target_machine, &sig, 0);
-	if (old_count == compiler->target_machine->defined_sig_count)
-		free_safe_gc(&temp_safe_gc, 1);
-	else
-		safe_gc_transfer_to(&temp_safe_gc, compiler->safe_gc, 1);
-	return added;
+	for (uint_fast64_t i = 0; i + 1 < ins_count; i++) {
+		compiler_ins_t first = compiler_ins[i];
+		compiler_ins_t second = compiler_ins[i + 1];
+		if (is_jump_target[i + 1])
+			continue;
+
+		int compare_offset = -1;
+		switch (first.op_code) {
+		case COMPILER_OP_CODE_LONG_EQUAL:
+		case COMPILER_OP_CODE_FLOAT_EQUAL:
+			compare_offset = first.op_code - COMPILER_OP_CODE_LONG_EQUAL;
+			break;
+		case COMPILER_OP_CODE_LONG_MORE:
+		case COMPILER_OP_CODE_LONG_LESS:
+		case COMPILER_OP_CODE_LONG_MORE_EQUAL:
+		case COMPILER_OP_CODE_LONG_LESS_EQUAL:
+			compare_offset = 2 + first.op_code - COMPILER_OP_CODE_LONG_MORE;
+			break;
+		case COMPILER_OP_CODE_FLOAT_MORE:
+		case COMPILER_OP_CODE_FLOAT_LESS:
+		case COMPILER_OP_CODE_FLOAT_MORE_EQUAL:
+		case COMPILER_OP_CODE_FLOAT_LESS_EQUAL:
+			compare_offset = 6 + first.op_code - COMPILER_OP_CODE_FLOAT_MORE;
+			break;
+		case COMPILER_OP_CODE_LONG_INCREMENT:
+		case COMPILER_OP_CODE_LONG_DECREMENT: {
+			//counted loops end in a step followed by a jump back to the loop condition
+			if (second.op_code != COMPILER_OP_CODE_JUMP || second.regs[0].reg + 1 >= ins_count)
+				break;
+			uint16_t cond_ip = second.regs[0].reg;
+			compiler_ins_t compare = compiler_ins[cond_ip];
+			compiler_ins_t check = compiler_ins[cond_ip + 1];
+			if (!REGS_EQ(compare.regs[0], first.regs[0]) || check.op_code != COMPILER_OP_CODE_JUMP_CHECK || !(check.dead_regs & 1) || !REGS_EQ(check.regs[0], compare.regs[2]) || check.regs[1].reg != i + 2)
+				break;
+
+			machine_op_code_t fused_op;
+			if (first.op_code == COMPILER_OP_CODE_LONG_INCREMENT && compare.op_code == COMPILER_OP_CODE_LONG_LESS)
+				fused_op = MACHINE_OP_CODE_LONG_INCREMENT_LESS_JUMP_LL;
+			else if (first.op_code == COMPILER_OP_CODE_LONG_INCREMENT && compare.op_code == COMPILER_OP_CODE_LONG_LESS_EQUAL)
+				fused_op = MACHINE_OP_CODE_LONG_INCREMENT_LESS_EQUAL_JUMP_LL;
+			else if (first.op_code == COMPILER_OP_CODE_LONG_DECREMENT && compare.op_code == COMPILER_OP_CODE_LONG_MORE)
+				fused_op = MACHINE_OP_CODE_LONG_DECREMENT_MORE_JUMP_LL;
+			else if (first.op_code == COMPILER_OP_CODE_LONG_DECREMENT && compare.op_code == COMPILER_OP_CODE_LONG_MORE_EQUAL)
+				fused_op = MACHINE_OP_CODE_LONG_DECREMENT_MORE_EQUAL_JUMP_LL;
+			else
+				break;
+			machine_ins[i] = (machine_ins_t){
+				.op_code = FUSED_OP2(fused_op, first.regs[0], compare.regs[1]),
+				.a = first.regs[0].reg,
+				.b = compare.regs[1].reg,
+				.c = cond_ip + 2
+			};
+			break;
+		}
+		case COMPILER_OP_CODE_LOAD_ALLOC:
+		case COMPILER_OP_CODE_LOAD_ALLOC_UNCHECKED: {
+			//only the accumulating form, acc = acc + a[i], fits in three operands. It keeps its bounds check, which costs less than a dispatch
+			if (second.op_code != COMPILER_OP_CODE_LONG_ADD && second.op_code != COMPILER_OP_CODE_FLOAT_ADD)
+				break;
+			compiler_reg_t acc_reg;
+			if ((second.dead_regs & 1) && REGS_EQ(second.regs[0], first.regs[2]))
+				acc_reg = second.regs[1];
+			else if ((second.dead_regs & 2) && REGS_EQ(second.regs[1], first.regs[2]))
+				acc_reg = second.regs[0];
+			else
+				break;
+			if (!REGS_EQ(acc_reg, second.regs[2]) || REGS_EQ(acc_reg, first.regs[2]))
+				break;
+			machine_ins[i] = (machine_ins_t){
+				.op_code = FUSED_OP3(second.op_code == COMPILER_OP_CODE_LONG_ADD ? MACHINE_OP_CODE_LOAD_ALLOC_LONG_ADD_LLL : MACHINE_OP_CODE_LOAD_ALLOC_FLOAT_ADD_LLL, first.regs[0], first.regs[1], acc_reg),
+				.a = first.regs[0].reg,
+				.b = first.regs[1].reg,
+				.c = acc_reg.reg
+			};
+			break;
+		}
+		default: //the rest are left unfused
+			break;
+		}
+
+		if (compare_offset >= 0 && second.op_code == COMPILER_OP_CODE_JUMP_CHECK && (second.dead_regs & 1) && REGS_EQ(second.regs[0], first.regs[2]))
+			machine_ins[i] = (machine_ins_t){
+				.op_code = FUSED_OP2(compare_jump_ops[compare_offset], first.regs[0], first.regs[1]),
+				.a = first.regs[0].reg,
+				.b = first.regs[1].reg,
+				.c = second.regs[1].reg
+			};
+	}
+	free(is_jump_target);
 }
+#undef REGS_EQ
+#undef FUSED_OP2
+#undef FUSED_OP3
 
 void compiler_ins_to_machine_ins(compiler_ins_t* compiler_ins, machine_ins_t* machine_ins, uint64_t ins_count) {
 	static const machine_op_code_t machine_ops[] = {
@@ -856,7 +1728,17 @@ void compiler_ins_to_machine_ins(compiler_ins_t* compiler_ins, machine_ins_t* ma
 		MACHINE_OP_CODE_TYPEGUARD_PROTECT_SUB_PROPERTY_LL,
 		MACHINE_OP_CODE_TYPEGUARD_PROTECT_SUB_PROPERTY_DOWNCAST_LL,
 
-		MACHINE_OP_CODE_SET_EXTRA_ARGS
+		MACHINE_OP_CODE_SET_EXTRA_ARGS,
+
+		MACHINE_OP_CODE_CALL_DIRECT,
+		MACHINE_OP_CODE_TAIL_CALL,
+
+		MACHINE_OP_CODE_LOAD_ALLOC_UNCHECKED_LLL,
+		MACHINE_OP_CODE_STORE_ALLOC_UNCHECKED_LLL,
+		MACHINE_OP_CODE_LOAD_ALLOC_I_INIT_LL,
+		MACHINE_OP_CODE_STORE_ALLOC_I_INIT_LL,
+		MACHINE_OP_CODE_ALLOC_I_INIT_L,
+		MACHINE_OP_CODE_CONF_INIT_ALL_L
 	};
 
 	static const int reg_operands[] = {
@@ -946,7 +1828,16 @@ void compiler_ins_to_machine_ins(compiler_ins_t* compiler_ins, machine_ins_t* ma
 		2, //typeguard protect record properties (w/ substitution)
 		2,
 
-		0 //sets extra argument registers
+		0, //sets extra argument registers
+
+		0, //call direct
+		0, //tail call
+		3, //load alloc unchecked
+		3, //store alloc unchecked
+		2, //load alloc (index, initialized)
+		2, //store alloc (index, initialized)
+		1, //alloc_i without init bits
+		1 //configure all initialized
 	};
 	
 	for (uint_fast64_t i = 0; i < ins_count; i++) {
@@ -962,4 +1853,5 @@ void compiler_ins_to_machine_ins(compiler_ins_t* compiler_ins, machine_ins_t* ma
 			.c = compiler_ins[i].regs[2].reg
 		};
 	}
+	fuse_machine_ins(compiler_ins, machine_ins, ins_count);
 }
\ No newline at end of file
@@ -111,12 +111,24 @@ typedef enum compiler_op_code {
 	COMPILER_OP_CODE_TYPEGUARD_PROTECT_SUB_PROPERTY,
 	COMPILER_OP_CODE_TYPEGUARD_PROTECT_SUB_PROPERTY_DOWNCAST,
 
-	COMPILER_OP_CODE_SET_EXTRA_ARGS
+	COMPILER_OP_CODE_SET_EXTRA_ARGS,
+
+	COMPILER_OP_CODE_CALL_DIRECT,
+	COMPILER_OP_CODE_TAIL_CALL,
+
+	COMPILER_OP_CODE_LOAD_ALLOC_UNCHECKED, //index proven to be in range at compile time
+	COMPILER_OP_CODE_STORE_ALLOC_UNCHECKED,
+	COMPILER_OP_CODE_LOAD_ALLOC_I_INIT, //register proven to be initialized at compile time
+	COMPILER_OP_CODE_STORE_ALLOC_I_INIT, //leaves the init bits alone
+	COMPILER_OP_CODE_ALLOC_I_INIT,
+	COMPILER_OP_CODE_CONF_INIT_ALL
 } compiler_op_code_t;
 
 typedef struct compiler_ins {
 	compiler_op_code_t op_code;
 	compiler_reg_t regs[3];
+
+	uint8_t dead_regs; //bit i is set when this instruction is the last reader of regs[i]
 } compiler_ins_t;
 
 typedef struct ins_builder {
@@ -126,6 +138,13 @@ typedef struct ins_builder {
 	safe_gc_t* safe_gc;
 } ins_builder_t;
 
+//where a variable is declared and the last statement of that block to use it
+typedef struct compiler_local {
+	uint32_t block, last_use;
+	ast_var_info_t* alias_of; //the variable whose register it shares
+	int owns_slot; //holds a local slot that can be reused once it's dead
+} compiler_local_t;
+
 typedef struct compiler {
 	compiler_reg_t* eval_regs;
 	int* move_eval;
@@ -134,11 +153,28 @@ typedef struct compiler {
 
 	uint16_t* proc_call_offsets;
 	uint16_t* proc_call_max_locals;
+	uint16_t* proc_ips; //entry point of the procedure a variable is bound to for its whole lifetime, or 0 if it isn't known at compile time
+
+	ast_proc_t** var_procs; //procedure a variable is bound to for its whole lifetime, known once that procedure's registers are allocated
+	ast_proc_t** inlined_calls; //callee whose body is compiled in place of a call, or NULL
+	uint8_t* hoisted; //values compiled in front of the loop that uses them rather than where they appear
+	uint8_t* unchecked_indices; //array accesses whose index is proven to lie within the array
+	uint32_t bounds_checks, eliminated_bounds_checks; //array accesses by a register index, and how many of them skip the check
+	uint32_t record_allocs, eliminated_record_allocs; //record allocations, and how many of them were replaced by registers
+
+	compiler_local_t* locals;
+	uint32_t block_count;
+	uint16_t inline_depth, inline_offset, top_level_inline_locals;
+	uint32_t* inline_locs; //copy of a source location made for the inline expansion in inline_loc_stamps
+	uint32_t* inline_loc_stamps;
+	uint32_t inline_stamp, inline_expansions, inline_call_loc; //expansion being compiled, or 0, and the call site it was inlined at
+	int inline_procs;
 
 	ast_t* ast;
 	machine_t* target_machine;
 
 	ins_builder_t ins_builder;
+	uint16_t unoptimized_ins_count; //instructions emitted before the peephole passes ran
 
 	uint16_t current_global;
 	
@@ -149,7 +185,7 @@ typedef struct compiler {
 int init_ins_builder(ins_builder_t* ins_builder, safe_gc_t* safe_gc);
 int ins_builder_append_ins(ins_builder_t* ins_builder, compiler_ins_t ins);
 
-int compile(compiler_t* compiler, safe_gc_t* safe_gc, machine_t* target_machine, ast_t* ast);
+int compile(compiler_t* compiler, safe_gc_t* safe_gc, machine_t* target_machine, ast_t* ast, int inline_procs, uint32_t max_stack_size, uint32_t max_frame_limit);
 
 void compiler_ins_to_machine_ins(compiler_ins_t* compiler_ins, machine_ins_t* machine_ins, uint64_t ins_count);
 #endif // !COMPILER_H
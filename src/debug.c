@@ -6,6 +6,8 @@
 #include "file.h"
 #include "debug.h"
 
+#define BACK_TRACE_EDGE 16
+
 static const char* opcode_names[] = {
 	"abort           ",
 	"foreign(lll)    ",
@@ -371,10 +373,124 @@ static const char* opcode_names[] = {
 	"typeprotprps(lg)",
 	"typeprotprps(gl)",
 	"typeprotprps(gg)",
-	"subprotprps(ll)",
-	"subprotprps(lg)",
-	"subprotprps(gl)",
-	"subprotprps(gg)",
+	"typeprotdwn(ll) ",
+	"typeprotdwn(lg) ",
+	"typeprotdwn(gl) ",
+	"typeprotdwn(gg) ",
+	"subprotprps(ll) ",
+	"subprotprps(lg) ",
+	"subprotprps(gl) ",
+	"subprotprps(gg) ",
+	"subprotdwn(ll)  ",
+	"subprotdwn(lg)  ",
+	"subprotdwn(gl)  ",
+	"subprotdwn(gg)  ",
+	"setextraargs    ",
+
+	"leqjmp(ll)      ",
+	"leqjmp(lg)      ",
+	"leqjmp(gl)      ",
+	"leqjmp(gg)      ",
+	"feqjmp(ll)      ",
+	"feqjmp(lg)      ",
+	"feqjmp(gl)      ",
+	"feqjmp(gg)      ",
+	"lmorejmp(ll)    ",
+	"lmorejmp(lg)    ",
+	"lmorejmp(gl)    ",
+	"lmorejmp(gg)    ",
+	"llessjmp(ll)    ",
+	"llessjmp(lg)    ",
+	"llessjmp(gl)    ",
+	"llessjmp(gg)    ",
+	"lmoreeqjmp(ll)  ",
+	"lmoreeqjmp(lg)  ",
+	"lmoreeqjmp(gl)  ",
+	"lmoreeqjmp(gg)  ",
+	"llesseqjmp(ll)  ",
+	"llesseqjmp(lg)  ",
+	"llesseqjmp(gl)  ",
+	"llesseqjmp(gg)  ",
+	"fmorejmp(ll)    ",
+	"fmorejmp(lg)    ",
+	"fmorejmp(gl)    ",
+	"fmorejmp(gg)    ",
+	"flessjmp(ll)    ",
+	"flessjmp(lg)    ",
+	"flessjmp(gl)    ",
+	"flessjmp(gg)    ",
+	"fmoreeqjmp(ll)  ",
+	"fmoreeqjmp(lg)  ",
+	"fmoreeqjmp(gl)  ",
+	"fmoreeqjmp(gg)  ",
+	"flesseqjmp(ll)  ",
+	"flesseqjmp(lg)  ",
+	"flesseqjmp(gl)  ",
+	"flesseqjmp(gg)  ",
+
+	"linclessjmp(ll) ",
+	"linclessjmp(lg) ",
+	"linclessjmp(gl) ",
+	"linclessjmp(gg) ",
+	"lincleqjmp(ll)  ",
+	"lincleqjmp(lg)  ",
+	"lincleqjmp(gl)  ",
+	"lincleqjmp(gg)  ",
+	"ldecmorejmp(ll) ",
+	"ldecmorejmp(lg) ",
+	"ldecmorejmp(gl) ",
+	"ldecmorejmp(gg) ",
+	"ldecmeqjmp(ll)  ",
+	"ldecmeqjmp(lg)  ",
+	"ldecmeqjmp(gl)  ",
+	"ldecmeqjmp(gg)  ",
+
+	"ldladd(lll)     ",
+	"ldladd(llg)     ",
+	"ldladd(lgl)     ",
+	"ldladd(lgg)     ",
+	"ldladd(gll)     ",
+	"ldladd(glg)     ",
+	"ldladd(ggl)     ",
+	"ldladd(ggg)     ",
+	"ldfadd(lll)     ",
+	"ldfadd(llg)     ",
+	"ldfadd(lgl)     ",
+	"ldfadd(lgg)     ",
+	"ldfadd(gll)     ",
+	"ldfadd(glg)     ",
+	"ldfadd(ggl)     ",
+	"ldfadd(ggg)     ",
+	"calldirect      ",
+	"tailcall        ",
+	"ldallocu(lll)   ",
+	"ldallocu(llg)   ",
+	"ldallocu(lgl)   ",
+	"ldallocu(lgg)   ",
+	"ldallocu(gll)   ",
+	"ldallocu(glg)   ",
+	"ldallocu(ggl)   ",
+	"ldallocu(ggg)   ",
+	"stoallocu(lll)  ",
+	"stoallocu(llg)  ",
+	"stoallocu(lgl)  ",
+	"stoallocu(lgg)  ",
+	"stoallocu(gll)  ",
+	"stoallocu(glg)  ",
+	"stoallocu(ggl)  ",
+	"stoallocu(ggg)  ",
+	"ldalloc_ii(ll)  ",
+	"ldalloc_ii(lg)  ",
+	"ldalloc_ii(gl)  ",
+	"ldalloc_ii(gg)  ",
+	"stoalloc_ii(ll) ",
+	"stoalloc_ii(lg) ",
+	"stoalloc_ii(gl) ",
+	"stoalloc_ii(gg) ",
+	"alloc_ii(l)     ",
+	"alloc_ii(g)     ",
+	"confinit(l)     ",
+	"confinit(g)     ",
 };
 
 static const char* error_names[] = {
@@ -437,15 +553,31 @@ void print_error_trace(multi_scanner_t multi_scanner) {
 	putchar('\n');
 }
 
+//an inlined location is reached through the call sites it was inlined at, outermost first
+static void print_inline_calls(dbg_table_t* dbg_table, dbg_src_loc_t* src_loc) {
+	if (!src_loc->inline_call)
+		return;
+	dbg_src_loc_t* call_loc = &dbg_table->src_locations[src_loc->inline_call - 1];
+	print_inline_calls(dbg_table, call_loc);
+	printf("\tCall from \"%s\", row %i, col %i\n", call_loc->file_name, call_loc->row, call_loc->col);
+}
+
 int print_back_trace(machine_t* machine, dbg_table_t* dbg_table, machine_ins_t* ins_begin) {
 	puts("Traceback (most recent call last):");
-	for (uint_fast16_t i = 0; i < machine->position_count; i++) {
+	//deep recursion is summarized by its outermost and innermost calls
+	for (uint_fast32_t i = 0; i < machine->position_count; i++) {
+		if (i == BACK_TRACE_EDGE && machine->position_count > BACK_TRACE_EDGE * 2) {
+			printf("\t... %" PRIu32 " more calls ...\n", machine->position_count - BACK_TRACE_EDGE * 2);
+			i = machine->position_count - BACK_TRACE_EDGE;
+		}
 		dbg_src_loc_t* src_loc = dbg_table_find_src_loc(dbg_table, machine->positions[i] - ins_begin);
 		ESCAPE_ON_FAIL(src_loc);
+		print_inline_calls(dbg_table, src_loc);
 		printf("\tCall from \"%s\", row %i, col %i\n", src_loc->file_name, src_loc->row, src_loc->col);
 	}
 	dbg_src_loc_t* src_loc_fin = dbg_table_find_src_loc(dbg_table, machine->last_err_ip);
 	ESCAPE_ON_FAIL(src_loc_fin);
+	print_inline_calls(dbg_table, src_loc_fin);
 
 	char* code_src = file_read_source(src_loc_fin->file_name);
 	ESCAPE_ON_FAIL(code_src);
@@ -497,6 +629,21 @@ int debug_table_add_loc(dbg_table_t* dbg_table, multi_scanner_t multi_scanner, u
 	src_loc->col = multi_scanner.scanners[multi_scanner.current_file - 1].col;
 	src_loc->min_ip = UINT64_MAX;
 	src_loc->max_ip = 0;
+	src_loc->inline_call = 0;
+	return 1;
+}
+
+int debug_table_inline_loc(dbg_table_t* dbg_table, uint32_t src_loc_id, uint32_t call_src_loc_id, uint32_t* output_src_loc_id) {
+	if (dbg_table->src_loc_count == dbg_table->alloced_src_locs)
+		ESCAPE_ON_FAIL(dbg_table->src_locations = safe_realloc(dbg_table->safe_gc, dbg_table->src_locations, (dbg_table->alloced_src_locs += 16) * sizeof(dbg_src_loc_t)));
+	dbg_src_loc_t* src_loc = &dbg_table->src_locations[*output_src_loc_id = dbg_table->src_loc_count++];
+
+	*src_loc = dbg_table->src_locations[src_loc_id];
+	ESCAPE_ON_FAIL(src_loc->file_name = safe_transfer_malloc(dbg_table->safe_gc, (strlen(dbg_table->src_locations[src_loc_id].file_name) + 1) * sizeof(char)));
+	strcpy(src_loc->file_name, dbg_table->src_locations[src_loc_id].file_name);
+	src_loc->min_ip = UINT64_MAX;
+	src_loc->max_ip = 0;
+	src_loc->inline_call = call_src_loc_id + 1;
 	return 1;
 }
 
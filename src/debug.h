@@ -12,6 +12,7 @@ typedef struct debug_src_loc {
 	char* file_name;
 
 	uint64_t min_ip, max_ip;
+	uint32_t inline_call; //one past the call site an inlined copy of a location was compiled for, or 0
 } dbg_src_loc_t;
 
 typedef struct debug_table {
@@ -33,6 +34,7 @@ int init_debug_table(dbg_table_t* dbg_table, safe_gc_t* safe_gc);
 void free_debug_table(dbg_table_t* dbg_table);
 
 int debug_table_add_loc(dbg_table_t* dbg_table, multi_scanner_t multi_scanner, uint32_t* output_src_loc_id);
+int debug_table_inline_loc(dbg_table_t* dbg_table, uint32_t src_loc_id, uint32_t call_src_loc_id, uint32_t* output_src_loc_id);
 void debug_loc_set_minip(dbg_table_t* dbg_table, uint32_t src_loc_id, uint64_t min_ip);
 void debug_loc_set_maxip(dbg_table_t* dbg_table, uint32_t src_loc_id, uint64_t max_ip);
 
@@ -22,7 +22,7 @@ static int read_type_sig(machine_type_sig_t* out_sig, FILE* infile, safe_gc_t* s
 	ESCAPE_ON_FAIL(fread(&out_sig->super_signature, sizeof(uint16_t), 1, infile));
 	ESCAPE_ON_FAIL(fread(&out_sig->sub_type_count, sizeof(uint16_t), 1, infile));
 
-	ESCAPE_ON_FAIL(out_sig->sub_types = safe_transfer_malloc(safe_gc, out_sig->sub_type_count * sizeof(machine_type_sig_t)));
+	ESCAPE_ON_FAIL(out_sig->sub_types = safe_malloc(safe_gc, out_sig->sub_type_count * sizeof(machine_type_sig_t))); //only read until the machine interns its own copy
 
 	if (out_sig->super_signature != TYPE_TYPEARG) {
 		for (uint_fast8_t i = 0; i < out_sig->sub_type_count; i++)
@@ -50,7 +50,7 @@ static int write_type_sig(machine_type_sig_t type_sig, FILE* infile) {
 	return 1;
 }
 
-machine_ins_t* file_load_ins(const char* path, safe_gc_t* safe_gc, machine_t* machine, uint16_t* instruction_count, uint16_t* constant_count, uint16_t* signature_count) {
+machine_ins_t* file_load_ins(const char* path, safe_gc_t* safe_gc, machine_t* machine, uint32_t max_stack_size, uint32_t max_frame_limit, uint16_t* instruction_count, uint16_t* constant_count, uint16_t* signature_count) {
 	FILE* infile = fopen(path, "rb");
 	ESCAPE_ON_FAIL(infile);
 
@@ -64,7 +64,7 @@ machine_ins_t* file_load_ins(const char* path, safe_gc_t* safe_gc, machine_t* ma
 
 	ESCAPE_ON_FAIL(fread(instruction_count, sizeof(uint16_t), 1, infile));
 
-	ESCAPE_ON_FAIL(init_machine(machine, UINT16_MAX / 8, 1000, type_table_count));
+	ESCAPE_ON_FAIL(init_machine(machine, max_stack_size, max_frame_limit, type_table_count));
 	machine_ins_t* instructions = safe_transfer_malloc(safe_gc, *instruction_count * sizeof(machine_ins_t));
 	ESCAPE_ON_FAIL(instructions);
 
@@ -76,7 +76,7 @@ machine_ins_t* file_load_ins(const char* path, safe_gc_t* safe_gc, machine_t* ma
 	for (uint_fast16_t i = 0; i < const_allocs; i++)
 		ESCAPE_ON_FAIL(fread(&machine->stack[i], sizeof(uint64_t), 1, infile));
 
-	for (uint_fast8_t i = 0; i < defined_sigs; i++) {
+	for (uint_fast16_t i = 0; i < defined_sigs; i++) {
 		machine_type_sig_t loaded_sig;
 		ESCAPE_ON_FAIL(read_type_sig(&loaded_sig, infile, safe_gc));
 		ESCAPE_ON_FAIL(machine_get_typesig(machine, &loaded_sig, 0));
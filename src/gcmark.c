@@ -0,0 +1,325 @@
+#include <stdlib.h>
+#include <string.h>
+#include "gcmark.h"
+
+#ifdef CISH_PARALLEL_GC
+#include <pthread.h>
+
+#define MARK_CHUNK 256 //objects a busy marker gives up at once
+
+typedef struct mark_chunk {
+	struct mark_chunk* next;
+	heap_alloc_t* allocs[MARK_CHUNK];
+} mark_chunk_t;
+
+typedef struct marker {
+	heap_alloc_t** stack;
+	uint32_t count, alloced;
+
+	heap_alloc_t** flagged; //everything this marker flagged, moved to the reset stack once every marker has joined
+	uint32_t flagged_count, alloced_flagged;
+
+	struct mark_pool* pool;
+	pthread_t thread;
+	uint32_t generation; //the last mark this marker's thread took part in
+} marker_t;
+
+//marker threads are started once and park between marks, waiting for the generation to change
+typedef struct mark_pool {
+	pthread_mutex_t lock;
+	pthread_cond_t wake, start, done;
+
+	//chunks shared by markers with work to spare, which idle markers steal
+	mark_chunk_t* shared;
+	mark_chunk_t* spare;
+
+	uint16_t marker_count, idle;
+	int failed;
+
+	uint32_t generation;
+	uint16_t finished; //threads done with the current mark
+	int stopping;
+
+	marker_t** markers; //the first belongs to the calling thread, the rest to threads that hold on to them
+	uint16_t alloced_markers;
+} mark_pool_t;
+
+static int reserve(heap_alloc_t*** buffer, uint32_t* alloced, uint32_t count, uint64_t more) {
+	if (count + more <= *alloced)
+		return 1;
+	uint64_t new_alloced = *alloced;
+	while (new_alloced < count + more)
+		new_alloced *= 2;
+	if (new_alloced > UINT32_MAX)
+		return 0;
+	heap_alloc_t** new_buffer = realloc(*buffer, new_alloced * sizeof(heap_alloc_t*));
+	if (!new_buffer)
+		return 0;
+	*buffer = new_buffer;
+	*alloced = new_alloced;
+	return 1;
+}
+
+//hands the top of a marker's stack to the pool when another marker has run out
+static void share_chunk(marker_t* marker) {
+	mark_pool_t* pool = marker->pool;
+	pthread_mutex_lock(&pool->lock);
+	mark_chunk_t* chunk = pool->spare;
+	if (chunk)
+		pool->spare = chunk->next;
+	else if (!(chunk = malloc(sizeof(mark_chunk_t)))) {
+		pthread_mutex_unlock(&pool->lock);
+		return; //the marker keeps the work to itself
+	}
+	marker->count -= MARK_CHUNK;
+	memcpy(chunk->allocs, &marker->stack[marker->count], MARK_CHUNK * sizeof(heap_alloc_t*));
+	chunk->next = pool->shared;
+	pool->shared = chunk;
+	pthread_cond_signal(&pool->wake);
+	pthread_mutex_unlock(&pool->lock);
+}
+
+//waits for a shared chunk, or returns 0 once every marker is idle and nothing is left to steal
+static int steal_chunk(marker_t* marker) {
+	mark_pool_t* pool = marker->pool;
+	pthread_mutex_lock(&pool->lock);
+	__atomic_add_fetch(&pool->idle, 1, __ATOMIC_RELAXED);
+	while (!pool->shared && pool->idle < pool->marker_count && !pool->failed)
+		pthread_cond_wait(&pool->wake, &pool->lock);
+	if (!pool->shared || pool->failed) {
+		pthread_cond_broadcast(&pool->wake);
+		pthread_mutex_unlock(&pool->lock);
+		return 0;
+	}
+	__atomic_sub_fetch(&pool->idle, 1, __ATOMIC_RELAXED);
+
+	mark_chunk_t* chunk = pool->shared;
+	pool->shared = chunk->next;
+	if (!reserve(&marker->stack, &marker->alloced, marker->count, MARK_CHUNK)) {
+		chunk->next = pool->shared;
+		pool->shared = chunk;
+		pool->failed = 1;
+		pthread_cond_broadcast(&pool->wake);
+		pthread_mutex_unlock(&pool->lock);
+		return 0;
+	}
+	memcpy(&marker->stack[marker->count], chunk->allocs, MARK_CHUNK * sizeof(heap_alloc_t*));
+	marker->count += MARK_CHUNK;
+	chunk->next = pool->spare;
+	pool->spare = chunk;
+	pthread_mutex_unlock(&pool->lock);
+	return 1;
+}
+
+static void fail_marker(marker_t* marker) {
+	pthread_mutex_lock(&marker->pool->lock);
+	marker->pool->failed = 1;
+	pthread_cond_broadcast(&marker->pool->wake);
+	pthread_mutex_unlock(&marker->pool->lock);
+	marker->count = 0;
+}
+
+//the mark bit is claimed with an atomic or, so exactly one marker scans each object
+static void mark(marker_t* marker) {
+	mark_pool_t* pool = marker->pool;
+	do {
+		while (marker->count) {
+			heap_alloc_t* heap_alloc = marker->stack[--marker->count];
+			if (__atomic_fetch_or(&heap_alloc->flags, HEAP_ALLOC_GC_FLAG, __ATOMIC_RELAXED) & HEAP_ALLOC_GC_FLAG)
+				continue;
+
+			if (!reserve(&marker->flagged, &marker->alloced_flagged, marker->flagged_count, 1) || (heap_alloc->trace_mode != GC_TRACE_MODE_NONE && !reserve(&marker->stack, &marker->alloced, marker->count, heap_alloc->limit))) {
+				fail_marker(marker);
+				break;
+			}
+			marker->flagged[marker->flagged_count++] = heap_alloc;
+
+			if (heap_alloc->trace_mode == GC_TRACE_MODE_ALL) {
+				for (uint_fast32_t i = 0; i < heap_alloc->limit; i++)
+					if (HEAP_IS_INIT(heap_alloc, i))
+						marker->stack[marker->count++] = heap_alloc->registers[i].heap_alloc;
+			}
+			else if (heap_alloc->trace_mode == GC_TRACE_MODE_SOME) {
+				for (uint_fast32_t i = 0; i < heap_alloc->limit; i++)
+					if (HEAP_IS_INIT(heap_alloc, i) && HEAP_BIT(HEAP_TRACE_STAT(heap_alloc), i))
+						marker->stack[marker->count++] = heap_alloc->registers[i].heap_alloc;
+			}
+
+			if (marker->count > MARK_CHUNK && __atomic_load_n(&pool->idle, __ATOMIC_RELAXED))
+				share_chunk(marker);
+		}
+	} while (steal_chunk(marker));
+}
+
+//a new generation is only begun once the roots are dealt out
+static void* run_marker(void* arg) {
+	marker_t* marker = arg;
+	mark_pool_t* pool = marker->pool;
+	pthread_mutex_lock(&pool->lock);
+	for (;;) {
+		while (marker->generation == pool->generation && !pool->stopping)
+			pthread_cond_wait(&pool->start, &pool->lock);
+		if (pool->stopping)
+			break;
+		marker->generation = pool->generation;
+		pthread_mutex_unlock(&pool->lock);
+		mark(marker);
+		pthread_mutex_lock(&pool->lock);
+		if (++pool->finished == pool->marker_count - 1)
+			pthread_cond_signal(&pool->done);
+	}
+	pthread_mutex_unlock(&pool->lock);
+	return NULL;
+}
+
+static void free_marker(marker_t* marker) {
+	free(marker->stack);
+	free(marker->flagged);
+	free(marker);
+}
+
+static mark_pool_t* get_pool(machine_t* machine) {
+	mark_pool_t* pool = machine->mark_pool;
+	if (!pool) {
+		PANIC_ON_FAIL(pool = malloc(sizeof(mark_pool_t)), machine, ERROR_MEMORY);
+		pool->shared = NULL;
+		pool->spare = NULL;
+		pool->markers = NULL;
+		pool->alloced_markers = 0;
+		pool->marker_count = 0;
+		pool->generation = 0;
+		pool->stopping = 0;
+		if (pthread_mutex_init(&pool->lock, NULL)) {
+			free(pool);
+			PANIC(machine, ERROR_INTERNAL);
+		}
+		if (pthread_cond_init(&pool->wake, NULL) || pthread_cond_init(&pool->start, NULL) || pthread_cond_init(&pool->done, NULL)) {
+			pthread_mutex_destroy(&pool->lock);
+			free(pool);
+			PANIC(machine, ERROR_INTERNAL);
+		}
+		machine->mark_pool = pool;
+	}
+	if (pool->alloced_markers < machine->gc_threads) {
+		marker_t** new_markers = realloc(pool->markers, machine->gc_threads * sizeof(marker_t*));
+		PANIC_ON_FAIL(new_markers, machine, ERROR_MEMORY);
+		pool->markers = new_markers;
+		for (uint_fast16_t i = pool->alloced_markers; i < machine->gc_threads; i++) {
+			marker_t* marker = malloc(sizeof(marker_t));
+			PANIC_ON_FAIL(marker, machine, ERROR_MEMORY);
+			marker->pool = pool;
+			marker->stack = malloc((marker->alloced = 1024) * sizeof(heap_alloc_t*));
+			marker->flagged = malloc((marker->alloced_flagged = 1024) * sizeof(heap_alloc_t*));
+			if (!marker->stack || !marker->flagged) {
+				free_marker(marker);
+				PANIC(machine, ERROR_MEMORY);
+			}
+			pool->markers[pool->alloced_markers++] = marker;
+		}
+	}
+
+	//markers without a thread, because one couldn't be started, are left out of every mark
+	if (!pool->marker_count)
+		pool->marker_count = 1;
+	for (; pool->marker_count < machine->gc_threads; pool->marker_count++) {
+		marker_t* marker = pool->markers[pool->marker_count];
+		marker->generation = pool->generation;
+		if (pthread_create(&marker->thread, NULL, run_marker, marker))
+			break;
+	}
+	return pool;
+}
+
+int gc_mark_parallel(machine_t* machine, heap_alloc_t** roots, uint32_t root_count) {
+	mark_pool_t* pool;
+	ESCAPE_ON_FAIL(pool = get_pool(machine));
+
+	//parked markers can't begin until the roots are dealt out and the generation changes
+	pthread_mutex_lock(&pool->lock);
+	pool->idle = 0;
+	pool->failed = 0;
+	pool->finished = 0;
+	for (uint_fast16_t i = 0; i < pool->marker_count; i++) {
+		pool->markers[i]->count = 0;
+		pool->markers[i]->flagged_count = 0;
+	}
+	for (uint_fast32_t i = 0; i < root_count; i++) {
+		marker_t* marker = pool->markers[i % pool->marker_count];
+		if (!reserve(&marker->stack, &marker->alloced, marker->count, 1)) {
+			pool->failed = 1;
+			break;
+		}
+		marker->stack[marker->count++] = roots[i];
+	}
+	pool->generation++;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->lock);
+
+	//the calling thread is the first marker, and sweeping waits for every other one to finish
+	mark(pool->markers[0]);
+	pthread_mutex_lock(&pool->lock);
+	while (pool->finished < pool->marker_count - 1)
+		pthread_cond_wait(&pool->done, &pool->lock);
+	pthread_mutex_unlock(&pool->lock);
+
+	while (pool->shared) {
+		mark_chunk_t* chunk = pool->shared;
+		pool->shared = chunk->next;
+		chunk->next = pool->spare;
+		pool->spare = chunk;
+	}
+
+	for (uint_fast16_t i = 0; i < pool->marker_count; i++) {
+		marker_t* marker = pool->markers[i];
+		if (machine->reset_count + (uint64_t)marker->flagged_count > machine->alloced_reset) {
+			uint64_t new_alloced = machine->alloced_reset;
+			while (new_alloced < machine->reset_count + (uint64_t)marker->flagged_count)
+				new_alloced *= 2;
+			PANIC_ON_FAIL(new_alloced <= UINT32_MAX, machine, ERROR_MEMORY);
+			heap_alloc_t** new_reset_stack = realloc(machine->reset_stack, new_alloced * sizeof(heap_alloc_t*));
+			PANIC_ON_FAIL(new_reset_stack, machine, ERROR_MEMORY);
+			machine->reset_stack = new_reset_stack;
+			machine->alloced_reset = new_alloced;
+		}
+		memcpy(&machine->reset_stack[machine->reset_count], marker->flagged, marker->flagged_count * sizeof(heap_alloc_t*));
+		machine->reset_count += marker->flagged_count;
+	}
+	if (pool->failed)
+		PANIC(machine, ERROR_MEMORY);
+	return 1;
+}
+
+void free_gc_markers(machine_t* machine) {
+	mark_pool_t* pool = machine->mark_pool;
+	if (!pool)
+		return;
+	pthread_mutex_lock(&pool->lock);
+	pool->stopping = 1;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->lock);
+	for (uint_fast16_t i = 1; i < pool->marker_count; i++)
+		pthread_join(pool->markers[i]->thread, NULL);
+
+	while (pool->spare) {
+		mark_chunk_t* chunk = pool->spare;
+		pool->spare = chunk->next;
+		free(chunk);
+	}
+	for (uint_fast16_t i = 0; i < pool->alloced_markers; i++)
+		free_marker(pool->markers[i]);
+	free(pool->markers);
+	pthread_cond_destroy(&pool->wake);
+	pthread_cond_destroy(&pool->start);
+	pthread_cond_destroy(&pool->done);
+	pthread_mutex_destroy(&pool->lock);
+	free(pool);
+}
+#else
+int gc_mark_parallel(machine_t* machine, heap_alloc_t** roots, uint32_t root_count) {
+	PANIC(machine, ERROR_INTERNAL);
+}
+
+void free_gc_markers(machine_t* machine) {
+
+}
+#endif // CISH_PARALLEL_GC
@@ -0,0 +1,21 @@
+#pragma once
+
+#ifndef GCMARK_H
+#define GCMARK_H
+
+#include <stdint.h>
+#include "machine.h"
+
+//marker threads are pthreads, the collector marks serially elsewhere
+#if defined(__GNUC__) && !defined(_WIN32)
+#define CISH_PARALLEL_GC
+#endif
+
+//frames with fewer objects than this are always marked on the calling thread
+#define GC_PARALLEL_MIN_OBJECTS 16384
+
+//flags everything reachable from roots with machine->gc_threads markers, adding every object it flags to the reset stack
+int gc_mark_parallel(machine_t* machine, heap_alloc_t** roots, uint32_t root_count);
+void free_gc_markers(machine_t* machine);
+
+#endif // !GCMARK_H
@@ -0,0 +1,880 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include "jit.h"
+
+#ifdef CISH_JIT_SUPPORTED
+#include <sys/mman.h>
+
+typedef enum jit_reg {
+	JIT_RAX, JIT_RCX, JIT_RDX, JIT_RBX, JIT_RSP, JIT_RBP, JIT_RSI, JIT_RDI,
+	JIT_R8, JIT_R9, JIT_R10, JIT_R11, JIT_R12, JIT_R13, JIT_R14, JIT_R15
+} jit_reg_t;
+
+//pinned for the lifetime of jitted code. All are callee-saved, so calls back into C preserve them
+#define FRAME_REG JIT_RBX
+#define GLOBAL_REG JIT_R12
+#define MACHINE_REG JIT_R13
+#define TABLE_REG JIT_R14
+#define INS_REG JIT_R15
+
+#define NATIVE_FRAME_SIZE 16 //a Cish call pushes its return address and 8 bytes of alignment
+
+typedef enum jit_cond {
+	JIT_COND_B = 0x2,
+	JIT_COND_AE = 0x3,
+	JIT_COND_E = 0x4,
+	JIT_COND_NE = 0x5,
+	JIT_COND_A = 0x7,
+	JIT_COND_P = 0xA,
+	JIT_COND_L = 0xC,
+	JIT_COND_GE = 0xD,
+	JIT_COND_LE = 0xE,
+	JIT_COND_G = 0xF,
+	JIT_COND_ALWAYS = -1,
+	JIT_COND_CALL = -2 //not a condition, emits a call instead of a jump
+} jit_cond_t;
+
+//same order as the compare opcodes in machine.h, after the equality ones
+typedef enum jit_compare {
+	JIT_COMPARE_EQUAL,
+	JIT_COMPARE_MORE,
+	JIT_COMPARE_LESS,
+	JIT_COMPARE_MORE_EQUAL,
+	JIT_COMPARE_LESS_EQUAL
+} jit_compare_t;
+
+typedef struct jit_operand {
+	jit_reg_t base;
+	int32_t disp;
+} jit_operand_t;
+
+typedef struct jit_fixup {
+	uint64_t pos; //position of the rel32 to patch
+	uint16_t ip;
+	error_t err; //ERROR_NONE jumps to the instruction at ip, anything else to a stub that raises err at ip
+} jit_fixup_t;
+
+typedef struct jit_builder {
+	uint8_t* code;
+	uint64_t size, alloced;
+
+	jit_fixup_t* fixups;
+	uint32_t fixup_count, alloced_fixups;
+
+	uint64_t* ins_offsets;
+	uint64_t exit_ok, exit_fail;
+
+	int failed;
+} jit_builder_t;
+
+#define OP1_RANGE(OPCODE) MACHINE_OP_CODE_##OPCODE##_L ... MACHINE_OP_CODE_##OPCODE##_G
+#define OP2_RANGE(OPCODE) MACHINE_OP_CODE_##OPCODE##_LL ... MACHINE_OP_CODE_##OPCODE##_GG
+#define OP3_RANGE(OPCODE) MACHINE_OP_CODE_##OPCODE##_LLL ... MACHINE_OP_CODE_##OPCODE##_GGG
+
+#define OPERANDS1(OPCODE) a = jit_slot(ins.a, ins.op_code - MACHINE_OP_CODE_##OPCODE##_L);
+#define OPERANDS2(OPCODE) { int variant = ins.op_code - MACHINE_OP_CODE_##OPCODE##_LL; a = jit_slot(ins.a, variant & 2); b = jit_slot(ins.b, variant & 1); }
+#define OPERANDS3(OPCODE) { int variant = ins.op_code - MACHINE_OP_CODE_##OPCODE##_LLL; a = jit_slot(ins.a, variant & 4); b = jit_slot(ins.b, variant & 2); c = jit_slot(ins.c, variant & 1); }
+
+#define MACHINE_FIELD(FIELD) MACHINE_REG, -1, 0, offsetof(machine_t, FIELD)
+#define HEAP_FIELD(FIELD) JIT_RAX, -1, 0, offsetof(heap_alloc_t, FIELD)
+#define SLOT(OPERAND) (OPERAND).base, -1, 0, (OPERAND).disp
+
+static void emit_byte(jit_builder_t* builder, uint8_t byte) {
+	if (builder->failed)
+		return;
+	if (builder->size == builder->alloced) {
+		uint8_t* new_code = realloc(builder->code, builder->alloced * 2);
+		if (!new_code) {
+			builder->failed = 1;
+			return;
+		}
+		builder->code = new_code;
+		builder->alloced *= 2;
+	}
+	builder->code[builder->size++] = byte;
+}
+
+static void emit_bytes(jit_builder_t* builder, const char* bytes, int count) {
+	for (int i = 0; i < count; i++)
+		emit_byte(builder, bytes[i]);
+}
+
+static void emit_imm32(jit_builder_t* builder, uint32_t imm) {
+	for (int i = 0; i < 4; i++)
+		emit_byte(builder, imm >> (i * 8));
+}
+
+static void emit_imm64(jit_builder_t* builder, uint64_t imm) {
+	for (int i = 0; i < 8; i++)
+		emit_byte(builder, imm >> (i * 8));
+}
+
+static void emit_opcode(jit_builder_t* builder, uint8_t prefix, uint8_t rex, uint32_t opcode, int opcode_len) {
+	if (prefix)
+		emit_byte(builder, prefix);
+	if (rex != 0x40)
+		emit_byte(builder, rex);
+	for (int i = opcode_len - 1; i >= 0; i--)
+		emit_byte(builder, opcode >> (i * 8));
+}
+
+//emits an instruction with a memory operand, [base + index * (1 << scale) + disp]. Pass -1 as index for none
+static void emit_mem(jit_builder_t* builder, uint8_t prefix, int wide, uint32_t opcode, int opcode_len, int reg, jit_reg_t base, int index, int scale, int32_t disp) {
+	emit_opcode(builder, prefix, (wide ? 0x48 : 0x40) | ((reg & 8) >> 1) | (index >= 0 ? (index & 8) >> 2 : 0) | ((base & 8) >> 3), opcode, opcode_len);
+
+	uint8_t mod = (disp == 0 && (base & 7) != JIT_RBP) ? 0 : ((disp >= -128 && disp <= 127) ? 1 : 2);
+	if (index >= 0 || (base & 7) == JIT_RSP) {
+		emit_byte(builder, (mod << 6) | ((reg & 7) << 3) | JIT_RSP);
+		emit_byte(builder, (scale << 6) | (((index >= 0 ? index : JIT_RSP) & 7) << 3) | (base & 7));
+	}
+	else
+		emit_byte(builder, (mod << 6) | ((reg & 7) << 3) | (base & 7));
+
+	if (mod == 1)
+		emit_byte(builder, disp);
+	else if (mod == 2)
+		emit_imm32(builder, disp);
+}
+
+//emits an instruction with two register operands
+static void emit_rr(jit_builder_t* builder, uint8_t prefix, int wide, uint32_t opcode, int opcode_len, int reg, int rm) {
+	emit_opcode(builder, prefix, (wide ? 0x48 : 0x40) | ((reg & 8) >> 1) | ((rm & 8) >> 3), opcode, opcode_len);
+	emit_byte(builder, 0xC0 | ((reg & 7) << 3) | (rm & 7));
+}
+
+static jit_operand_t jit_slot(uint16_t reg, int global) {
+	jit_operand_t operand = {
+		.base = global ? GLOBAL_REG : FRAME_REG,
+		.disp = reg * (int32_t)sizeof(machine_reg_t)
+	};
+	return operand;
+}
+
+static void emit_load(jit_builder_t* builder, jit_reg_t reg, jit_operand_t src) {
+	emit_mem(builder, 0, 1, 0x8B, 1, reg, SLOT(src));
+}
+
+static void emit_store(jit_builder_t* builder, jit_operand_t dest, jit_reg_t reg) {
+	emit_mem(builder, 0, 1, 0x89, 1, reg, SLOT(dest));
+}
+
+static void emit_jump_to(jit_builder_t* builder, jit_cond_t cond, uint64_t target) {
+	if (cond == JIT_COND_ALWAYS)
+		emit_byte(builder, 0xE9);
+	else if (cond == JIT_COND_CALL)
+		emit_byte(builder, 0xE8);
+	else {
+		emit_byte(builder, 0x0F);
+		emit_byte(builder, 0x80 | cond);
+	}
+	emit_imm32(builder, (uint32_t)(target - (builder->size + 4)));
+}
+
+//jumps to the instruction at ip, or raises err at ip
+static void emit_jump(jit_builder_t* builder, jit_cond_t cond, uint16_t ip, error_t err) {
+	emit_jump_to(builder, cond, builder->size);
+	if (builder->failed)
+		return;
+	if (builder->fixup_count == builder->alloced_fixups) {
+		jit_fixup_t* new_fixups = realloc(builder->fixups, (builder->alloced_fixups * 2) * sizeof(jit_fixup_t));
+		if (!new_fixups) {
+			builder->failed = 1;
+			return;
+		}
+		builder->fixups = new_fixups;
+		builder->alloced_fixups *= 2;
+	}
+	builder->fixups[builder->fixup_count++] = (jit_fixup_t){ .pos = builder->size - 4, .ip = ip, .err = err };
+}
+
+//emits a short conditional jump over the code that follows, and returns where its rel8 is for emit_skip_here
+static uint64_t emit_skip(jit_builder_t* builder, jit_cond_t cond) {
+	emit_byte(builder, 0x70 | cond);
+	emit_byte(builder, 0);
+	return builder->size;
+}
+
+static void emit_skip_here(jit_builder_t* builder, uint64_t skip) {
+	if (!builder->failed)
+		builder->code[skip - 1] = (uint8_t)(builder->size - skip);
+}
+
+static void emit_reload_frame(jit_builder_t* builder) {
+	emit_mem(builder, 0, 0, 0x8B, 1, JIT_RAX, MACHINE_FIELD(global_offset)); //mov eax, global_offset
+	emit_mem(builder, 0, 1, 0x8D, 1, FRAME_REG, GLOBAL_REG, JIT_RAX, 3, 0); //lea frame, [stack + rax * 8]
+}
+
+static void emit_set_bool(jit_builder_t* builder, jit_cond_t cond, jit_operand_t dest) {
+	emit_rr(builder, 0, 0, 0x0F90 | cond, 2, 0, JIT_RAX); //setcc al
+	emit_rr(builder, 0, 0, 0x0FB6, 2, JIT_RAX, JIT_RAX); //movzx eax, al
+	emit_mem(builder, 0, 0, 0x89, 1, JIT_RAX, SLOT(dest));
+}
+
+//returns the condition under which the comparison holds. Float comparisons are arranged so unordered operands compare false, like in C; float equality additionally needs the parity flag clear
+static jit_cond_t emit_compare(jit_builder_t* builder, int is_float, jit_compare_t compare, jit_operand_t a, jit_operand_t b) {
+	if (is_float) {
+		int swap = compare == JIT_COMPARE_LESS || compare == JIT_COMPARE_LESS_EQUAL;
+		emit_mem(builder, 0xF2, 0, 0x0F10, 2, 0, SLOT(swap ? b : a)); //movsd xmm0
+		emit_mem(builder, 0x66, 0, 0x0F2E, 2, 0, SLOT(swap ? a : b)); //ucomisd xmm0
+		switch (compare) {
+		case JIT_COMPARE_EQUAL:
+			return JIT_COND_E;
+		case JIT_COMPARE_MORE:
+		case JIT_COMPARE_LESS:
+			return JIT_COND_A;
+		default:
+			return JIT_COND_AE;
+		}
+	}
+	else {
+		static const jit_cond_t long_conds[] = { JIT_COND_E, JIT_COND_G, JIT_COND_L, JIT_COND_GE, JIT_COND_LE };
+		emit_load(builder, JIT_RAX, a);
+		emit_mem(builder, 0, 1, 0x3B, 1, JIT_RAX, SLOT(b));
+		return long_conds[compare];
+	}
+}
+
+static void emit_compare_set(jit_builder_t* builder, int is_float, jit_compare_t compare, jit_operand_t a, jit_operand_t b, jit_operand_t c) {
+	jit_cond_t cond = emit_compare(builder, is_float, compare, a, b);
+	emit_rr(builder, 0, 0, 0x0F90 | cond, 2, 0, JIT_RAX); //setcc al
+	if (is_float && compare == JIT_COMPARE_EQUAL) {
+		emit_rr(builder, 0, 0, 0x0F9B, 2, 0, JIT_RCX); //setnp cl
+		emit_rr(builder, 0, 0, 0x20, 1, JIT_RCX, JIT_RAX); //and al, cl
+	}
+	emit_rr(builder, 0, 0, 0x0FB6, 2, JIT_RAX, JIT_RAX);
+	emit_mem(builder, 0, 0, 0x89, 1, JIT_RAX, SLOT(c));
+}
+
+//jumps to target when the comparison doesn't hold, like a compare followed by a jump check
+static void emit_compare_jump(jit_builder_t* builder, int is_float, jit_compare_t compare, jit_operand_t a, jit_operand_t b, uint16_t target) {
+	jit_cond_t cond = emit_compare(builder, is_float, compare, a, b);
+	emit_jump(builder, cond ^ 1, target, ERROR_NONE);
+	if (is_float && compare == JIT_COMPARE_EQUAL)
+		emit_jump(builder, JIT_COND_P, target, ERROR_NONE);
+}
+
+//loads the word of init bits holding the bit of the element at rcx into r9, leaving its address at [rdx + r8 * 8]
+static void emit_init_word(jit_builder_t* builder) {
+	emit_mem(builder, 0, 1, 0x8B, 1, JIT_RDX, HEAP_FIELD(init_stat));
+	emit_rr(builder, 0, 1, 0x89, 1, JIT_RCX, JIT_R8); //mov r8, rcx
+	emit_rr(builder, 0, 1, 0xC1, 1, 5, JIT_R8); //shr r8, 6
+	emit_byte(builder, 6);
+	emit_mem(builder, 0, 1, 0x8B, 1, JIT_R9, JIT_RDX, JIT_R8, 3, 0);
+}
+
+//leaves the heap alloc in rax, the index in rcx and the registers in rdx, so the element is at [rdx + rcx * 8]
+static void emit_element(jit_builder_t* builder, uint16_t ip, jit_operand_t array, jit_operand_t* index, uint16_t imm_index, int bounded, int check_init) {
+	emit_load(builder, JIT_RAX, array);
+	if (index)
+		emit_load(builder, JIT_RCX, *index);
+	else {
+		emit_byte(builder, 0xB9); //mov ecx, imm32
+		emit_imm32(builder, imm_index);
+	}
+	if (bounded) {
+		//negative indicies wrap to huge unsigned values and fail the same check
+		emit_mem(builder, 0, 0, 0x8B, 1, JIT_RDX, HEAP_FIELD(limit));
+		emit_rr(builder, 0, 1, 0x39, 1, JIT_RDX, JIT_RCX); //cmp rcx, rdx
+		emit_jump(builder, JIT_COND_AE, ip, ERROR_INDEX_OUT_OF_RANGE);
+	}
+	if (check_init) {
+		emit_init_word(builder);
+		emit_rr(builder, 0, 1, 0x0FA3, 2, JIT_RCX, JIT_R9); //bt r9, rcx
+		emit_jump(builder, JIT_COND_AE, ip, ERROR_READ_UNINIT);
+	}
+	emit_mem(builder, 0, 1, 0x8B, 1, JIT_RDX, HEAP_FIELD(registers));
+}
+
+static void emit_load_element(jit_builder_t* builder, uint16_t ip, jit_operand_t array, jit_operand_t* index, uint16_t imm_index, int bounded, int check_init, jit_operand_t dest) {
+	emit_element(builder, ip, array, index, imm_index, bounded, check_init);
+	emit_mem(builder, 0, 1, 0x8B, 1, JIT_RDX, JIT_RDX, JIT_RCX, 3, 0);
+	emit_store(builder, dest, JIT_RDX);
+}
+
+static void emit_store_element(jit_builder_t* builder, uint16_t ip, jit_operand_t array, jit_operand_t* index, uint16_t imm_index, int bounded, int set_init, jit_operand_t value) {
+	emit_load(builder, JIT_RSI, value);
+	emit_element(builder, ip, array, index, imm_index, bounded, 0);
+	emit_mem(builder, 0, 1, 0x89, 1, JIT_RSI, JIT_RDX, JIT_RCX, 3, 0);
+	if (!set_init)
+		return;
+	emit_init_word(builder);
+	emit_rr(builder, 0, 1, 0x0FAB, 2, JIT_RCX, JIT_R9); //bts r9, rcx
+	emit_mem(builder, 0, 1, 0x89, 1, JIT_R9, JIT_RDX, JIT_R8, 3, 0);
+}
+
+static int jit_fallback(machine_t* machine, machine_ins_t* ins, uint16_t ip) {
+	if (machine_execute(machine, ins, ins, 0))
+		return 1;
+	machine->last_err_ip = ip;
+	return 0;
+}
+
+static int jit_grow_stack(machine_t* machine, uint64_t required_size, uint16_t ip) {
+	if (machine_grow_stack(machine, required_size))
+		return 1;
+	machine->last_err_ip = ip;
+	return 0;
+}
+
+static int jit_grow_frames(machine_t* machine, uint64_t unused, uint16_t ip) {
+	if (machine_grow_frames(machine))
+		return 1;
+	machine->last_err_ip = ip;
+	return 0;
+}
+
+//calls helper(machine, rsi, ip), leaving through the common exit if it fails
+static void emit_grow(jit_builder_t* builder, int (*helper)(machine_t*, uint64_t, uint16_t), uint16_t ip) {
+	emit_rr(builder, 0, 1, 0x89, 1, MACHINE_REG, JIT_RDI); //mov rdi, machine
+	emit_byte(builder, 0xB8 | JIT_RDX); //mov edx, imm32
+	emit_imm32(builder, ip);
+	emit_byte(builder, 0x48); //mov rax, imm64
+	emit_byte(builder, 0xB8 | JIT_RAX);
+	emit_imm64(builder, (uint64_t)helper);
+	emit_rr(builder, 0, 0, 0xFF, 1, 2, JIT_RAX); //call rax
+	emit_rr(builder, 0, 0, 0x85, 1, JIT_RAX, JIT_RAX); //test eax, eax
+	emit_jump_to(builder, JIT_COND_E, builder->exit_fail);
+}
+
+//hands the instruction to the interpreter, used for allocation, gc, ffi and typechecking opcodes
+static void emit_fallback(jit_builder_t* builder, jit_t* jit, uint16_t ip) {
+	emit_rr(builder, 0, 1, 0x89, 1, MACHINE_REG, JIT_RDI); //mov rdi, machine
+	emit_byte(builder, 0x48); //mov rsi, imm64
+	emit_byte(builder, 0xB8 | JIT_RSI);
+	emit_imm64(builder, (uint64_t)&jit->fallback_ins[ip * 2]);
+	emit_byte(builder, 0xB8 | JIT_RDX); //mov edx, imm32
+	emit_imm32(builder, ip);
+	emit_byte(builder, 0x48); //mov rax, imm64
+	emit_byte(builder, 0xB8 | JIT_RAX);
+	emit_imm64(builder, (uint64_t)jit_fallback);
+	emit_rr(builder, 0, 0, 0xFF, 1, 2, JIT_RAX); //call rax
+	emit_rr(builder, 0, 0, 0x85, 1, JIT_RAX, JIT_RAX); //test eax, eax
+	emit_jump_to(builder, JIT_COND_E, builder->exit_fail);
+}
+
+//pushes the return position and moves the frame, leaving rdi untouched
+static void emit_call_frame(jit_builder_t* builder, uint16_t ip, uint16_t offset) {
+	emit_mem(builder, 0, 0, 0x8B, 1, JIT_RAX, MACHINE_FIELD(position_count));
+	emit_mem(builder, 0, 0, 0x3B, 1, JIT_RAX, MACHINE_FIELD(frame_limit)); //cmp eax, frame_limit
+	uint64_t skip = emit_skip(builder, JIT_COND_NE);
+	emit_bytes(builder, "\x57\x48\x83\xEC\x08", 5); //push rdi; sub rsp, 8
+	emit_grow(builder, jit_grow_frames, ip);
+	emit_bytes(builder, "\x48\x83\xC4\x08\x5F", 5); //add rsp, 8; pop rdi
+	emit_mem(builder, 0, 0, 0x8B, 1, JIT_RAX, MACHINE_FIELD(position_count));
+	emit_skip_here(builder, skip);
+
+	//positions are kept as instruction pointers so back traces work unchanged
+	emit_mem(builder, 0, 1, 0x8B, 1, JIT_RDX, MACHINE_FIELD(positions));
+	emit_mem(builder, 0, 1, 0x8D, 1, JIT_RSI, INS_REG, -1, 0, ip * (int32_t)sizeof(machine_ins_t));
+	emit_mem(builder, 0, 1, 0x89, 1, JIT_RSI, JIT_RDX, JIT_RAX, 3, 0);
+	emit_rr(builder, 0, 0, 0xFF, 1, 0, JIT_RAX); //inc eax
+	emit_mem(builder, 0, 0, 0x89, 1, JIT_RAX, MACHINE_FIELD(position_count));
+
+	emit_mem(builder, 0, 0, 0x81, 1, 0, MACHINE_FIELD(global_offset)); //add dword, imm32
+	emit_imm32(builder, offset);
+	emit_reload_frame(builder);
+}
+
+//while an incremental collection is marking, a heap store runs in the interpreter instead, which shades the value it overwrites
+static void emit_barrier_check(jit_builder_t* builder, jit_t* jit, uint16_t ip) {
+	if (!jit->gc_barriers)
+		return;
+	emit_mem(builder, 0, 0, 0x80, 1, 7, MACHINE_FIELD(gc_phase)); //cmp byte, imm8
+	emit_byte(builder, GC_PHASE_MARK);
+	uint64_t skip = emit_skip(builder, JIT_COND_NE);
+	emit_fallback(builder, jit, ip);
+	emit_jump(builder, JIT_COND_ALWAYS, ip + 1, ERROR_NONE);
+	emit_skip_here(builder, skip);
+}
+
+//emits native code for the instruction at ip, and returns how many machine instructions it covered
+static int jit_compile_ins(jit_builder_t* builder, jit_t* jit, uint16_t ip) {
+	machine_ins_t ins = jit->instructions[ip];
+	jit_operand_t a, b, c;
+
+	switch (ins.op_code) {
+	case MACHINE_OP_CODE_ABORT:
+		if (ins.a == ERROR_NONE)
+			emit_jump_to(builder, JIT_COND_ALWAYS, builder->exit_ok);
+		else
+			emit_jump(builder, JIT_COND_ALWAYS, ip, ins.a);
+		return 1;
+	case OP2_RANGE(MOVE):
+		OPERANDS2(MOVE);
+		emit_load(builder, JIT_RAX, b);
+		emit_store(builder, a, JIT_RAX);
+		return 1;
+	case MACHINE_OP_CODE_SET_L:
+		if (ins.c)
+			break;
+		emit_mem(builder, 0, 1, 0xC7, 1, 0, SLOT(jit_slot(ins.a, 0)));
+		emit_imm32(builder, ins.b);
+		return 1;
+	case MACHINE_OP_CODE_JUMP:
+		emit_jump(builder, JIT_COND_ALWAYS, ins.a, ERROR_NONE);
+		return 1;
+	case OP1_RANGE(JUMP_CHECK):
+		OPERANDS1(JUMP_CHECK);
+		emit_mem(builder, 0, 0, 0x83, 1, 7, SLOT(a)); //cmp dword, 0
+		emit_byte(builder, 0);
+		emit_jump(builder, JIT_COND_E, ins.b, ERROR_NONE);
+		return 1;
+	case OP1_RANGE(CALL):
+		OPERANDS1(CALL);
+		emit_load(builder, JIT_RDI, a); //the callee is read before the frame moves
+		emit_call_frame(builder, ip, ins.b);
+
+		//procedure values are instruction pointers; dividing the offset by sizeof(machine_ins_t) = 12 indexes the native table
+		emit_rr(builder, 0, 1, 0x89, 1, JIT_RDI, JIT_RAX);
+		emit_rr(builder, 0, 1, 0x29, 1, INS_REG, JIT_RAX);
+		emit_byte(builder, 0xB9); //mov ecx, imm32
+		emit_imm32(builder, 0xAAAAAAAB);
+		emit_rr(builder, 0, 1, 0x0FAF, 2, JIT_RAX, JIT_RCX); //imul rax, rcx
+		emit_rr(builder, 0, 1, 0xC1, 1, 5, JIT_RAX); //shr rax, 35
+		emit_byte(builder, 35);
+
+		//the extra 8 bytes keep the native stack 16-byte aligned inside every callee
+		emit_bytes(builder, "\x48\x83\xEC\x08", 4); //sub rsp, 8
+		emit_mem(builder, 0, 0, 0xFF, 1, 2, TABLE_REG, JIT_RAX, 3, 0); //call [table + rax * 8]
+		emit_bytes(builder, "\x48\x83\xC4\x08", 4); //add rsp, 8
+		return 1;
+	case MACHINE_OP_CODE_CALL_DIRECT:
+		emit_call_frame(builder, ip, ins.b);
+		emit_bytes(builder, "\x48\x83\xEC\x08", 4); //sub rsp, 8
+		emit_jump(builder, JIT_COND_CALL, ins.a, ERROR_NONE);
+		emit_bytes(builder, "\x48\x83\xC4\x08", 4); //add rsp, 8
+		return 1;
+	case MACHINE_OP_CODE_TAIL_CALL:
+		//arguments only ever move down, so copying in ascending order is safe
+		for (uint_fast16_t i = 1; i <= ins.c; i++) {
+			emit_load(builder, JIT_RAX, jit_slot(ins.b + i, 0));
+			emit_store(builder, jit_slot(i, 0), JIT_RAX);
+		}
+		emit_jump(builder, JIT_COND_ALWAYS, ins.a, ERROR_NONE);
+		return 1;
+	case MACHINE_OP_CODE_RETURN:
+		emit_mem(builder, 0, 0, 0xFF, 1, 1, MACHINE_FIELD(position_count)); //dec dword
+		emit_byte(builder, 0xC3);
+		return 1;
+	case MACHINE_OP_CODE_STACK_VALIDATE: {
+		emit_mem(builder, 0, 0, 0x8B, 1, JIT_RAX, MACHINE_FIELD(global_offset));
+		emit_bytes(builder, "\x48\x05", 2); //add rax, imm32
+		emit_imm32(builder, ins.a);
+		emit_mem(builder, 0, 0, 0x8B, 1, JIT_RCX, MACHINE_FIELD(stack_size));
+		emit_rr(builder, 0, 1, 0x39, 1, JIT_RCX, JIT_RAX);
+		uint64_t skip = emit_skip(builder, JIT_COND_B);
+		emit_mem(builder, 0, 1, 0x8D, 1, JIT_RSI, JIT_RAX, -1, 0, 1); //lea rsi, [rax + 1]
+		emit_grow(builder, jit_grow_stack, ip);
+		emit_skip_here(builder, skip);
+		return 1;
+	}
+	case OP1_RANGE(LABEL):
+		OPERANDS1(LABEL);
+		emit_mem(builder, 0, 1, 0x8D, 1, JIT_RAX, INS_REG, -1, 0, ins.b * (int32_t)sizeof(machine_ins_t));
+		emit_store(builder, a, JIT_RAX);
+		return 1;
+	case MACHINE_OP_CODE_STACK_OFFSET:
+	case MACHINE_OP_CODE_STACK_DEOFFSET:
+		emit_mem(builder, 0, 0, 0x81, 1, ins.op_code == MACHINE_OP_CODE_STACK_OFFSET ? 0 : 5, MACHINE_FIELD(global_offset)); //add/sub dword, imm32
+		emit_imm32(builder, ins.a);
+		emit_reload_frame(builder);
+		return 1;
+	case OP3_RANGE(LOAD_ALLOC):
+		OPERANDS3(LOAD_ALLOC);
+		emit_load_element(builder, ip, a, &b, 0, 1, 1, c);
+		return 1;
+	case OP2_RANGE(LOAD_ALLOC_I):
+		OPERANDS2(LOAD_ALLOC_I);
+		emit_load_element(builder, ip, a, NULL, ins.c, 0, 1, b);
+		return 1;
+	case OP2_RANGE(LOAD_ALLOC_I_BOUND):
+		OPERANDS2(LOAD_ALLOC_I_BOUND);
+		emit_load_element(builder, ip, a, NULL, ins.c, 1, 1, b);
+		return 1;
+	case OP3_RANGE(STORE_ALLOC):
+		OPERANDS3(STORE_ALLOC);
+		emit_barrier_check(builder, jit, ip);
+		emit_store_element(builder, ip, a, &b, 0, 1, 1, c);
+		return 1;
+	case OP2_RANGE(STORE_ALLOC_I):
+		OPERANDS2(STORE_ALLOC_I);
+		emit_barrier_check(builder, jit, ip);
+		emit_store_element(builder, ip, a, NULL, ins.c, 0, 1, b);
+		return 1;
+	case OP2_RANGE(STORE_ALLOC_I_BOUND):
+		OPERANDS2(STORE_ALLOC_I_BOUND);
+		emit_barrier_check(builder, jit, ip);
+		emit_store_element(builder, ip, a, NULL, ins.c, 1, 1, b);
+		return 1;
+	case OP3_RANGE(LOAD_ALLOC_UNCHECKED):
+		OPERANDS3(LOAD_ALLOC_UNCHECKED);
+		emit_load_element(builder, ip, a, &b, 0, 0, 1, c);
+		return 1;
+	case OP3_RANGE(STORE_ALLOC_UNCHECKED):
+		OPERANDS3(STORE_ALLOC_UNCHECKED);
+		emit_barrier_check(builder, jit, ip);
+		emit_store_element(builder, ip, a, &b, 0, 0, 1, c);
+		return 1;
+	case OP2_RANGE(LOAD_ALLOC_I_INIT):
+		OPERANDS2(LOAD_ALLOC_I_INIT);
+		emit_load_element(builder, ip, a, NULL, ins.c, 0, 0, b);
+		return 1;
+	case OP2_RANGE(STORE_ALLOC_I_INIT):
+		OPERANDS2(STORE_ALLOC_I_INIT);
+		emit_barrier_check(builder, jit, ip);
+		emit_store_element(builder, ip, a, NULL, ins.c, 0, 0, b);
+		return 1;
+	case OP1_RANGE(CONF_INIT_ALL):
+		if (ins.b > 64 * 8)
+			break;
+		OPERANDS1(CONF_INIT_ALL);
+		emit_load(builder, JIT_RAX, a);
+		emit_mem(builder, 0, 1, 0x8B, 1, JIT_RDX, HEAP_FIELD(init_stat));
+		for (uint_fast16_t i = 0; i < ins.b / 64; i++) {
+			emit_mem(builder, 0, 1, 0xC7, 1, 0, JIT_RDX, -1, 0, i * sizeof(uint64_t)); //mov qword, -1
+			emit_imm32(builder, UINT32_MAX);
+		}
+		if (ins.b % 64) {
+			emit_byte(builder, 0x48); //mov rcx, imm64
+			emit_byte(builder, 0xB8 | JIT_RCX);
+			emit_imm64(builder, (UINT64_C(1) << (ins.b % 64)) - 1);
+			emit_mem(builder, 0, 1, 0x09, 1, JIT_RCX, JIT_RDX, -1, 0, (ins.b / 64) * sizeof(uint64_t)); //or [rdx + disp], rcx
+		}
+		return 1;
+	case OP3_RANGE(AND):
+	case OP3_RANGE(OR):
+		if (ins.op_code >= MACHINE_OP_CODE_OR_LLL)
+			OPERANDS3(OR)
+		else
+			OPERANDS3(AND)
+		emit_mem(builder, 0, 0, 0x8B, 1, JIT_RAX, SLOT(a));
+		emit_rr(builder, 0, 0, 0x85, 1, JIT_RAX, JIT_RAX);
+		emit_rr(builder, 0, 0, 0x0F95, 2, 0, JIT_RAX); //setne al
+		emit_mem(builder, 0, 0, 0x8B, 1, JIT_RCX, SLOT(b));
+		emit_rr(builder, 0, 0, 0x85, 1, JIT_RCX, JIT_RCX);
+		emit_rr(builder, 0, 0, 0x0F95, 2, 0, JIT_RCX); //setne cl
+		emit_rr(builder, 0, 0, ins.op_code >= MACHINE_OP_CODE_OR_LLL ? 0x08 : 0x20, 1, JIT_RCX, JIT_RAX); //or/and al, cl
+		emit_rr(builder, 0, 0, 0x0FB6, 2, JIT_RAX, JIT_RAX);
+		emit_mem(builder, 0, 0, 0x89, 1, JIT_RAX, SLOT(c));
+		return 1;
+	case OP2_RANGE(NOT):
+		OPERANDS2(NOT);
+		emit_mem(builder, 0, 0, 0x83, 1, 7, SLOT(b));
+		emit_byte(builder, 0);
+		emit_set_bool(builder, JIT_COND_E, a);
+		return 1;
+	case OP2_RANGE(LENGTH):
+		OPERANDS2(LENGTH);
+		emit_load(builder, JIT_RAX, b);
+		emit_mem(builder, 0, 0, 0x8B, 1, JIT_RAX, HEAP_FIELD(limit));
+		emit_store(builder, a, JIT_RAX);
+		return 1;
+	case OP3_RANGE(PTR_EQUAL):
+		OPERANDS3(PTR_EQUAL);
+		emit_load(builder, JIT_RAX, a);
+		emit_mem(builder, 0, 1, 0x3B, 1, JIT_RAX, SLOT(b));
+		emit_set_bool(builder, JIT_COND_E, c);
+		return 1;
+	case OP3_RANGE(BOOL_EQUAL):
+		OPERANDS3(BOOL_EQUAL);
+		emit_mem(builder, 0, 0, 0x8B, 1, JIT_RAX, SLOT(a));
+		emit_mem(builder, 0, 0, 0x3B, 1, JIT_RAX, SLOT(b));
+		emit_set_bool(builder, JIT_COND_E, c);
+		return 1;
+	case OP3_RANGE(CHAR_EQUAL):
+		OPERANDS3(CHAR_EQUAL);
+		emit_mem(builder, 0, 0, 0x8A, 1, JIT_RAX, SLOT(a));
+		emit_mem(builder, 0, 0, 0x3A, 1, JIT_RAX, SLOT(b));
+		emit_set_bool(builder, JIT_COND_E, c);
+		return 1;
+	case OP3_RANGE(LONG_EQUAL):
+		OPERANDS3(LONG_EQUAL);
+		emit_compare_set(builder, 0, JIT_COMPARE_EQUAL, a, b, c);
+		return 1;
+	case OP3_RANGE(FLOAT_EQUAL):
+		OPERANDS3(FLOAT_EQUAL);
+		emit_compare_set(builder, 1, JIT_COMPARE_EQUAL, a, b, c);
+		return 1;
+	case MACHINE_OP_CODE_LONG_MORE_LLL ... MACHINE_OP_CODE_LONG_LESS_EQUAL_GGG:
+		OPERANDS3(LONG_MORE); //variant bits repeat every 8 opcodes
+		emit_compare_set(builder, 0, JIT_COMPARE_MORE + (ins.op_code - MACHINE_OP_CODE_LONG_MORE_LLL) / 8, a, b, c);
+		return 1;
+	case MACHINE_OP_CODE_FLOAT_MORE_LLL ... MACHINE_OP_CODE_FLOAT_LESS_EQUAL_GGG:
+		OPERANDS3(FLOAT_MORE);
+		emit_compare_set(builder, 1, JIT_COMPARE_MORE + (ins.op_code - MACHINE_OP_CODE_FLOAT_MORE_LLL) / 8, a, b, c);
+		return 1;
+	case OP3_RANGE(LONG_ADD):
+	case OP3_RANGE(LONG_SUBTRACT):
+	case OP3_RANGE(LONG_MULTIPLY):
+		OPERANDS3(LONG_ADD);
+		emit_load(builder, JIT_RAX, a);
+		if (ins.op_code <= MACHINE_OP_CODE_LONG_ADD_GGG)
+			emit_mem(builder, 0, 1, 0x03, 1, JIT_RAX, SLOT(b));
+		else if (ins.op_code <= MACHINE_OP_CODE_LONG_SUBTRACT_GGG)
+			emit_mem(builder, 0, 1, 0x2B, 1, JIT_RAX, SLOT(b));
+		else
+			emit_mem(builder, 0, 1, 0x0FAF, 2, JIT_RAX, SLOT(b));
+		emit_store(builder, c, JIT_RAX);
+		return 1;
+	case OP3_RANGE(LONG_DIVIDE):
+		//the interpreter divides by the divisor as an unsigned value
+		OPERANDS3(LONG_DIVIDE);
+		emit_load(builder, JIT_RAX, a);
+		emit_load(builder, JIT_RCX, b);
+		emit_rr(builder, 0, 1, 0x85, 1, JIT_RCX, JIT_RCX);
+		emit_jump(builder, JIT_COND_E, ip, ERROR_DIVIDE_BY_ZERO);
+		emit_rr(builder, 0, 0, 0x31, 1, JIT_RDX, JIT_RDX); //xor edx, edx
+		emit_rr(builder, 0, 1, 0xF7, 1, 6, JIT_RCX); //div rcx
+		emit_store(builder, c, JIT_RAX);
+		return 1;
+	case OP3_RANGE(LONG_MODULO):
+		OPERANDS3(LONG_MODULO);
+		emit_load(builder, JIT_RAX, a);
+		emit_bytes(builder, "\x48\x99", 2); //cqo
+		emit_mem(builder, 0, 1, 0xF7, 1, 7, SLOT(b)); //idiv
+		emit_store(builder, c, JIT_RDX);
+		return 1;
+	case OP3_RANGE(FLOAT_ADD):
+	case OP3_RANGE(FLOAT_SUBTRACT):
+	case OP3_RANGE(FLOAT_MULTIPLY):
+	case OP3_RANGE(FLOAT_DIVIDE): {
+		static const uint32_t float_ops[] = { 0x0F58, 0x0F5C, 0x0F59, 0x0F5E }; //addsd, subsd, mulsd, divsd
+		OPERANDS3(FLOAT_ADD);
+		emit_mem(builder, 0xF2, 0, 0x0F10, 2, 0, SLOT(a));
+		emit_mem(builder, 0xF2, 0, float_ops[(ins.op_code - MACHINE_OP_CODE_FLOAT_ADD_LLL) / 8], 2, 0, SLOT(b));
+		emit_mem(builder, 0xF2, 0, 0x0F11, 2, 0, SLOT(c));
+		return 1;
+	}
+	case OP2_RANGE(LONG_NEGATE):
+		OPERANDS2(LONG_NEGATE);
+		emit_load(builder, JIT_RAX, b);
+		emit_rr(builder, 0, 1, 0xF7, 1, 3, JIT_RAX); //neg rax
+		emit_store(builder, a, JIT_RAX);
+		return 1;
+	case OP2_RANGE(FLOAT_NEGATE):
+		OPERANDS2(FLOAT_NEGATE);
+		emit_load(builder, JIT_RAX, b);
+		emit_rr(builder, 0, 1, 0x0FBA, 2, 7, JIT_RAX); //btc rax, 63
+		emit_byte(builder, 63);
+		emit_store(builder, a, JIT_RAX);
+		return 1;
+	case OP1_RANGE(LONG_INCREMENT):
+		OPERANDS1(LONG_INCREMENT);
+		emit_mem(builder, 0, 1, 0xFF, 1, 0, SLOT(a));
+		return 1;
+	case OP1_RANGE(LONG_DECREMENT):
+		OPERANDS1(LONG_DECREMENT);
+		emit_mem(builder, 0, 1, 0xFF, 1, 1, SLOT(a));
+		return 1;
+	case OP1_RANGE(FLOAT_INCREMENT):
+	case OP1_RANGE(FLOAT_DECREMENT):
+		if (ins.op_code >= MACHINE_OP_CODE_FLOAT_DECREMENT_L)
+			OPERANDS1(FLOAT_DECREMENT)
+		else
+			OPERANDS1(FLOAT_INCREMENT)
+		emit_mem(builder, 0xF2, 0, 0x0F10, 2, 0, SLOT(a));
+		emit_byte(builder, 0x48); //mov rax, 1.0
+		emit_byte(builder, 0xB8 | JIT_RAX);
+		emit_imm64(builder, 0x3FF0000000000000);
+		emit_rr(builder, 0x66, 1, 0x0F6E, 2, 1, JIT_RAX); //movq xmm1, rax
+		emit_rr(builder, 0xF2, 0, ins.op_code >= MACHINE_OP_CODE_FLOAT_DECREMENT_L ? 0x0F5C : 0x0F58, 2, 0, 1);
+		emit_mem(builder, 0xF2, 0, 0x0F11, 2, 0, SLOT(a));
+		return 1;
+	case OP2_RANGE(LONG_EQUAL_JUMP_CHECK):
+		OPERANDS2(LONG_EQUAL_JUMP_CHECK);
+		emit_compare_jump(builder, 0, JIT_COMPARE_EQUAL, a, b, ins.c);
+		return 2;
+	case OP2_RANGE(FLOAT_EQUAL_JUMP_CHECK):
+		OPERANDS2(FLOAT_EQUAL_JUMP_CHECK);
+		emit_compare_jump(builder, 1, JIT_COMPARE_EQUAL, a, b, ins.c);
+		return 2;
+	case MACHINE_OP_CODE_LONG_MORE_JUMP_CHECK_LL ... MACHINE_OP_CODE_LONG_LESS_EQUAL_JUMP_CHECK_GG:
+		OPERANDS2(LONG_MORE_JUMP_CHECK);
+		emit_compare_jump(builder, 0, JIT_COMPARE_MORE + (ins.op_code - MACHINE_OP_CODE_LONG_MORE_JUMP_CHECK_LL) / 4, a, b, ins.c);
+		return 2;
+	case MACHINE_OP_CODE_FLOAT_MORE_JUMP_CHECK_LL ... MACHINE_OP_CODE_FLOAT_LESS_EQUAL_JUMP_CHECK_GG:
+		OPERANDS2(FLOAT_MORE_JUMP_CHECK);
+		emit_compare_jump(builder, 1, JIT_COMPARE_MORE + (ins.op_code - MACHINE_OP_CODE_FLOAT_MORE_JUMP_CHECK_LL) / 4, a, b, ins.c);
+		return 2;
+	case MACHINE_OP_CODE_LONG_INCREMENT_LESS_JUMP_LL ... MACHINE_OP_CODE_LONG_DECREMENT_MORE_EQUAL_JUMP_GG: {
+		static const jit_cond_t step_conds[] = { JIT_COND_L, JIT_COND_LE, JIT_COND_G, JIT_COND_GE };
+		int step_op = (ins.op_code - MACHINE_OP_CODE_LONG_INCREMENT_LESS_JUMP_LL) / 4;
+		OPERANDS2(LONG_INCREMENT_LESS_JUMP);
+		emit_mem(builder, 0, 1, 0xFF, 1, step_op >= 2, SLOT(a)); //inc/dec
+		emit_load(builder, JIT_RAX, a);
+		emit_mem(builder, 0, 1, 0x3B, 1, JIT_RAX, SLOT(b));
+		emit_jump(builder, step_conds[step_op], ins.c, ERROR_NONE);
+		return 2;
+	}
+	case OP3_RANGE(LOAD_ALLOC_LONG_ADD):
+		OPERANDS3(LOAD_ALLOC_LONG_ADD);
+		emit_element(builder, ip, a, &b, 0, 1, 1);
+		emit_mem(builder, 0, 1, 0x8B, 1, JIT_RDX, JIT_RDX, JIT_RCX, 3, 0);
+		emit_mem(builder, 0, 1, 0x01, 1, JIT_RDX, SLOT(c)); //add [c], rdx
+		return 2;
+	case OP3_RANGE(LOAD_ALLOC_FLOAT_ADD):
+		OPERANDS3(LOAD_ALLOC_FLOAT_ADD);
+		emit_element(builder, ip, a, &b, 0, 1, 1);
+		emit_mem(builder, 0xF2, 0, 0x0F10, 2, 1, JIT_RDX, JIT_RCX, 3, 0); //movsd xmm1, element
+		emit_mem(builder, 0xF2, 0, 0x0F10, 2, 0, SLOT(c));
+		emit_rr(builder, 0xF2, 0, 0x0F58, 2, 0, 1);
+		emit_mem(builder, 0xF2, 0, 0x0F11, 2, 0, SLOT(c));
+		return 2;
+	default:
+		break;
+	}
+	emit_fallback(builder, jit, ip);
+	return 1;
+}
+
+int init_jit(jit_t* jit, machine_ins_t* instructions, uint16_t instruction_count, int gc_barriers) {
+	jit->instructions = instructions;
+	jit->gc_barriers = gc_barriers;
+	jit->code = NULL;
+	jit->last_err = ERROR_NONE;
+
+	if (sizeof(machine_ins_t) != 12 || sizeof(machine_reg_t) != 8)
+		PANIC(jit, ERROR_INTERNAL);
+
+	PANIC_ON_FAIL(jit->fallback_ins = malloc(instruction_count * 2 * sizeof(machine_ins_t)), jit, ERROR_MEMORY);
+	for (uint_fast16_t i = 0; i < instruction_count; i++) {
+		jit->fallback_ins[i * 2] = instructions[i];
+		jit->fallback_ins[i * 2 + 1] = (machine_ins_t){ .op_code = MACHINE_OP_CODE_ABORT, .a = ERROR_NONE };
+	}
+	jit->ins_table = malloc((instruction_count + 1) * sizeof(void*));
+
+	jit_builder_t builder = {
+		.code = malloc(builder.alloced = 64 + instruction_count * 32),
+		.fixups = malloc((builder.alloced_fixups = 64) * sizeof(jit_fixup_t)),
+		.ins_offsets = malloc((instruction_count + 1) * sizeof(uint64_t)),
+		.size = 0,
+		.fixup_count = 0,
+		.failed = 0
+	};
+	builder.failed = !jit->ins_table || !builder.code || !builder.fixups || !builder.ins_offsets;
+
+	//int entry(machine_t* machine, machine_reg_t* stack, void** ins_table, machine_ins_t* instructions)
+	emit_bytes(&builder, "\x55\x53\x41\x54\x41\x55\x41\x56\x41\x57", 10); //push rbp, rbx, r12-r15
+	emit_bytes(&builder, "\x48\x83\xEC\x08", 4); //sub rsp, 8
+	emit_bytes(&builder, "\x48\x89\xE5", 3); //mov rbp, rsp
+	emit_rr(&builder, 0, 1, 0x89, 1, JIT_RDI, MACHINE_REG);
+	emit_rr(&builder, 0, 1, 0x89, 1, JIT_RSI, GLOBAL_REG);
+	emit_rr(&builder, 0, 1, 0x89, 1, JIT_RDX, TABLE_REG);
+	emit_rr(&builder, 0, 1, 0x89, 1, JIT_RCX, INS_REG);
+	emit_reload_frame(&builder);
+	emit_jump(&builder, JIT_COND_ALWAYS, 0, ERROR_NONE);
+
+	builder.exit_ok = builder.size;
+	emit_bytes(&builder, "\xB8\x01\x00\x00\x00\xEB\x02", 7); //mov eax, 1; jmp over the next instruction
+	builder.exit_fail = builder.size;
+	emit_bytes(&builder, "\x31\xC0", 2); //xor eax, eax
+	emit_bytes(&builder, "\x48\x89\xEC\x48\x83\xC4\x08", 7); //mov rsp, rbp; add rsp, 8
+	emit_bytes(&builder, "\x41\x5F\x41\x5E\x41\x5D\x41\x5C\x5B\x5D\xC3", 11); //pop r15-r12, rbx, rbp; ret
+
+	for (uint_fast16_t ip = 0; ip < instruction_count && !builder.failed; ip++) {
+		builder.ins_offsets[ip] = builder.size;
+		if (jit_compile_ins(&builder, jit, ip) == 2)
+			builder.ins_offsets[++ip] = builder.size; //the second half of a superinstruction is never a jump target
+	}
+	if (!builder.failed) {
+		builder.ins_offsets[instruction_count] = builder.size; //running off the end finishes the program
+		emit_jump_to(&builder, JIT_COND_ALWAYS, builder.exit_ok);
+	}
+
+	//error stubs record the error and its instruction, then leave through the common exit
+	for (uint_fast32_t i = 0; i < builder.fixup_count && !builder.failed; i++) {
+		jit_fixup_t fixup = builder.fixups[i];
+		uint64_t target;
+		if (fixup.err == ERROR_NONE)
+			target = builder.ins_offsets[fixup.ip];
+		else {
+			target = builder.size;
+			emit_mem(&builder, 0, 0, 0xC7, 1, 0, MACHINE_FIELD(last_err));
+			emit_imm32(&builder, fixup.err);
+			emit_mem(&builder, 0, 1, 0xC7, 1, 0, MACHINE_FIELD(last_err_ip));
+			emit_imm32(&builder, fixup.ip);
+			emit_jump_to(&builder, JIT_COND_ALWAYS, builder.exit_fail);
+		}
+		if (!builder.failed) {
+			uint32_t rel = (uint32_t)(target - (fixup.pos + 4));
+			memcpy(&builder.code[fixup.pos], &rel, sizeof(uint32_t));
+		}
+	}
+
+	if (!builder.failed) {
+		jit->code_size = builder.size;
+		jit->code = mmap(NULL, jit->code_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (jit->code == MAP_FAILED)
+			jit->code = NULL;
+		else {
+			memcpy(jit->code, builder.code, builder.size);
+			if (mprotect(jit->code, jit->code_size, PROT_READ | PROT_EXEC)) {
+				munmap(jit->code, jit->code_size);
+				jit->code = NULL;
+			}
+			else {
+				for (uint_fast32_t i = 0; i <= instruction_count; i++)
+					jit->ins_table[i] = jit->code + builder.ins_offsets[i];
+			}
+		}
+	}
+
+	free(builder.code);
+	free(builder.fixups);
+	free(builder.ins_offsets);
+	if (!jit->code) {
+		free(jit->fallback_ins);
+		free(jit->ins_table);
+		PANIC(jit, ERROR_MEMORY);
+	}
+	return 1;
+}
+
+void free_jit(jit_t* jit) {
+	munmap(jit->code, jit->code_size);
+	free(jit->fallback_ins);
+	free(jit->ins_table);
+}
+
+typedef int (*jit_entry_t)(machine_t* machine, machine_reg_t* stack, void** ins_table, machine_ins_t* instructions);
+
+static int run_entry(machine_t* machine, void* arg) {
+	jit_t* jit = arg;
+	jit_entry_t entry = (jit_entry_t)jit->code;
+	return entry(machine, machine->stack, jit->ins_table, jit->instructions);
+}
+
+int jit_execute(jit_t* jit, machine_t* machine) {
+	machine->last_err = ERROR_NONE;
+	if (machine->alloced_sig_defs < machine->defined_sig_count + (machine->frame_limit / 4)) {
+		machine_type_sig_t* new_sigs = realloc(machine->defined_signatures, sizeof(machine_type_sig_t) * (machine->alloced_sig_defs = machine->defined_sig_count + (machine->frame_limit / 4)));
+		PANIC_ON_FAIL(new_sigs, machine, ERROR_MEMORY);
+		machine->defined_signatures = new_sigs;
+	}
+
+	return machine_run_native(machine, NATIVE_FRAME_SIZE, run_entry, jit);
+}
+#undef OP1_RANGE
+#undef OP2_RANGE
+#undef OP3_RANGE
+#undef OPERANDS1
+#undef OPERANDS2
+#undef OPERANDS3
+#undef MACHINE_FIELD
+#undef HEAP_FIELD
+#undef SLOT
+#undef NATIVE_FRAME_SIZE
+#else
+int init_jit(jit_t* jit, machine_ins_t* instructions, uint16_t instruction_count, int gc_barriers) {
+	PANIC(jit, ERROR_INTERNAL);
+}
+
+void free_jit(jit_t* jit) {
+
+}
+
+int jit_execute(jit_t* jit, machine_t* machine) {
+	PANIC(machine, ERROR_INTERNAL);
+}
+#endif // CISH_JIT_SUPPORTED
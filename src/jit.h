@@ -0,0 +1,31 @@
+#pragma once
+
+#ifndef JIT_H
+#define JIT_H
+
+#include <stdint.h>
+#include "error.h"
+#include "machine.h"
+
+//the template jit emits x86-64 System V code into mmap'd memory
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(_WIN32)
+#define CISH_JIT_SUPPORTED
+#endif
+
+typedef struct jit {
+	uint8_t* code;
+	uint64_t code_size;
+
+	void** ins_table; //native address of every machine instruction
+	machine_ins_t* instructions;
+	machine_ins_t* fallback_ins; //each interpreted instruction followed by an abort, ran through machine_execute
+	int gc_barriers; //heap stores check for an incremental collection that's marking, and leave it to the interpreter's write barrier
+
+	error_t last_err;
+} jit_t;
+
+int init_jit(jit_t* jit, machine_ins_t* instructions, uint16_t instruction_count, int gc_barriers);
+void free_jit(jit_t* jit);
+
+int jit_execute(jit_t* jit, machine_t* machine);
+#endif // !JIT_H
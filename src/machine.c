@@ -1,8 +1,24 @@
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <pthread.h>
+#endif
 #include "error.h"
 #include "type.h"
 #include "machine.h"
+#include "gcmark.h"
+#include "reclaim.h"
+#include "typesig.h"
+
+//computed-goto dispatch is used whenever the compiler supports labels as values. Define CISH_SWITCH_DISPATCH to force the portable switch engine.
+#if defined(__GNUC__) && !defined(CISH_SWITCH_DISPATCH)
+#define CISH_THREADED_DISPATCH
+#endif
 
 static int64_t longpow(int64_t base, int64_t exp) {
 	int64_t result = 1;
@@ -17,73 +33,173 @@ static int64_t longpow(int64_t base, int64_t exp) {
 	return result;
 }
 
-heap_alloc_t* machine_alloc(machine_t* machine, uint16_t req_size, gc_trace_mode_t trace_mode) {
-#define CHECK_HEAP_COUNT if(machine->heap_count == UINT16_MAX) \
+//bytes taken by a block with room for capacity registers
+static size_t heap_alloc_size(uint32_t capacity, int trace_bits, int init_bits) {
+	return sizeof(heap_alloc_t) + (size_t)capacity * sizeof(machine_reg_t) + HEAP_BIT_WORDS(capacity) * ((trace_bits != 0) + (init_bits != 0)) * sizeof(uint64_t);
+}
+
+//carves a fresh block of a size class out of the current slab, starting a new slab once it runs out
+static heap_alloc_t* carve_slab_block(machine_t* machine, uint8_t size_class) {
+	size_t size = (size_t)size_class * HEAP_SLAB_GRANULE;
+	if ((size_t)(machine->slab_end - machine->slab_top) < size) {
+		char* slab = malloc(HEAP_SLAB_SIZE);
+		PANIC_ON_FAIL(slab, machine, ERROR_MEMORY);
+		*(void**)slab = machine->slabs;
+		machine->slabs = slab;
+		machine->slab_top = machine->slab_freed_top = slab + HEAP_SLAB_GRANULE;
+		machine->slab_end = slab + HEAP_SLAB_SIZE;
+	}
+	heap_alloc_t* heap_alloc = (heap_alloc_t*)machine->slab_top;
+	machine->slab_top += size;
+	return heap_alloc;
+}
+
+static int machine_gc_slice(machine_t* machine);
+
+static void count_alloc(machine_gc_stats_t* stats, uint64_t req_size, int fresh) {
+	uint_fast8_t bucket = 0;
+	while (bucket < GC_STATS_SIZE_BUCKETS - 1 && req_size >> bucket)
+		bucket++;
+	stats->allocs_by_size[bucket]++;
+	if (fresh)
+		stats->fresh_blocks++;
+	else
+		stats->recycled_blocks++;
+}
+static int inc_keep(machine_t* machine, heap_alloc_t* heap_alloc);
+
+static heap_alloc_t* alloc_block(machine_t* machine, uint64_t req_size, gc_trace_mode_t trace_mode, int init_bits) {
+#define CHECK_HEAP_COUNT if(machine->heap_count == UINT32_MAX) \
 							PANIC(machine, ERROR_MEMORY); \
 						if (machine->heap_count == machine->alloced_heap_allocs) { \
-							heap_alloc_t** new_heap_allocs = realloc(machine->heap_allocs, (machine->alloced_heap_allocs += 100) * sizeof(heap_alloc_t*)); \
+							heap_alloc_t** new_heap_allocs = realloc(machine->heap_allocs, (machine->alloced_heap_allocs = machine->alloced_heap_allocs > UINT32_MAX / 2 ? UINT32_MAX : machine->alloced_heap_allocs * 2) * sizeof(heap_alloc_t*)); \
 							PANIC_ON_FAIL(new_heap_allocs, machine, ERROR_MEMORY); \
 							machine->heap_allocs = new_heap_allocs; \
 						}
 
-	heap_alloc_t* heap_alloc;
-	if (machine->freed_heap_count) {
-		heap_alloc = machine->freed_heap_allocs[--machine->freed_heap_count];
-		if (!heap_alloc->reg_with_table) {
+	if (req_size > UINT32_MAX) //also catches negative lengths
+		PANIC(machine, ERROR_MEMORY);
+
+	//an incremental collection advances by one slice per allocation
+	if (machine->gc_phase)
+		ESCAPE_ON_FAIL(machine_gc_slice(machine));
+
+	int trace_bits = trace_mode == GC_TRACE_MODE_SOME;
+	uint8_t room_flags = (trace_bits ? HEAP_ALLOC_TRACE_BITS : 0) | (init_bits ? HEAP_ALLOC_INIT_BITS : 0);
+	heap_alloc_t* heap_alloc = NULL;
+	int fresh = 0;
+	size_t size = heap_alloc_size(req_size, trace_bits, init_bits);
+	if (size <= HEAP_SLAB_MAX_SIZE) {
+		//slab blocks of a class are interchangeable, so a freed one is always taken as is
+		uint8_t size_class = (size + HEAP_SLAB_GRANULE - 1) / HEAP_SLAB_GRANULE;
+		if ((heap_alloc = machine->slab_free[size_class])) {
+			machine->slab_free[size_class] = (heap_alloc_t*)heap_alloc->registers;
+			if (!(heap_alloc->flags & HEAP_ALLOC_REG_WITH_TABLE)) {
+				CHECK_HEAP_COUNT;
+				machine->heap_allocs[machine->heap_count++] = heap_alloc;
+			}
+		}
+		else {
+			ESCAPE_ON_FAIL(heap_alloc = carve_slab_block(machine, size_class));
 			CHECK_HEAP_COUNT;
 			machine->heap_allocs[machine->heap_count++] = heap_alloc;
-			heap_alloc->reg_with_table = 1;
+			fresh = 1;
 		}
+		heap_alloc->size_class = size_class;
+		heap_alloc->capacity = req_size;
+		heap_alloc->flags = (heap_alloc->flags & HEAP_ALLOC_REG_WITH_TABLE) | room_flags;
 	}
-	else {
-		heap_alloc = malloc(sizeof(heap_alloc_t));
+	else if (machine->freed_heap_count) {
+		heap_alloc = machine->freed_heap_allocs[machine->freed_heap_count - 1];
+		int fits = heap_alloc->capacity >= req_size && (heap_alloc->flags & room_flags) == room_flags;
+		if (heap_alloc->flags & HEAP_ALLOC_REG_WITH_TABLE) {
+			//the heap table still points at the block, so it can't move and is only taken if it fits
+			if (fits)
+				machine->freed_heap_count--;
+			else
+				heap_alloc = NULL;
+		}
+		else {
+			machine->freed_heap_count--;
+			//blocks are also shrunk, so a freed array doesn't linger behind small objects
+			if (!fits || heap_alloc->capacity / 2 > req_size + 8) {
+				heap_alloc_t* resized = realloc(heap_alloc, size);
+				if (!resized) {
+					free(heap_alloc);
+					PANIC(machine, ERROR_MEMORY);
+				}
+				heap_alloc = resized;
+				heap_alloc->capacity = req_size;
+				heap_alloc->flags = room_flags;
+			}
+			CHECK_HEAP_COUNT;
+			machine->heap_allocs[machine->heap_count++] = heap_alloc;
+		}
+	}
+	if (!heap_alloc) {
+		heap_alloc = malloc(size);
 		PANIC_ON_FAIL(heap_alloc, machine, ERROR_MEMORY);
 		CHECK_HEAP_COUNT;
 		machine->heap_allocs[machine->heap_count++] = heap_alloc;
-		heap_alloc->reg_with_table = 1;
+		heap_alloc->size_class = 0;
+		heap_alloc->capacity = req_size;
+		heap_alloc->flags = room_flags;
+		fresh = 1;
 	}
+	if (machine->gc_stats)
+		count_alloc(machine->gc_stats, req_size, fresh);
 
-	heap_alloc->pre_freed = 0;
+	//a block taken while the heap table still holds it may sit in a frame that's being swept, and mustn't be mistaken for garbage there
+	int in_table = heap_alloc->flags & HEAP_ALLOC_REG_WITH_TABLE;
+	heap_alloc->flags = (heap_alloc->flags & (HEAP_ALLOC_TRACE_BITS | HEAP_ALLOC_INIT_BITS)) | HEAP_ALLOC_REG_WITH_TABLE;
+	if (in_table && (machine->gc_phase == GC_PHASE_MARK || machine->gc_phase == GC_PHASE_SWEEP))
+		ESCAPE_ON_FAIL(inc_keep(machine, heap_alloc));
 	heap_alloc->limit = req_size;
-	heap_alloc->gc_flag = 0;
 	heap_alloc->trace_mode = trace_mode;
-
-	PANIC_ON_FAIL(heap_alloc, machine, ERROR_MEMORY);
-	
-	if (req_size) {
-		PANIC_ON_FAIL(heap_alloc->registers = malloc(req_size * sizeof(machine_reg_t)), machine, ERROR_MEMORY);
-		PANIC_ON_FAIL(heap_alloc->init_stat = calloc(req_size, sizeof(int)), machine, ERROR_MEMORY);
-		if (trace_mode == GC_TRACE_MODE_SOME)
-			PANIC_ON_FAIL(heap_alloc->trace_stat = malloc(req_size * sizeof(int)), machine, ERROR_MEMORY);
+	heap_alloc->type_sig = NULL; //until it's configured, so the signature sweep never follows a stale one
+	heap_alloc->registers = (machine_reg_t*)(heap_alloc + 1);
+	if (trace_bits)
+		memset(HEAP_TRACE_STAT(heap_alloc), 0, HEAP_BIT_WORDS(req_size) * sizeof(uint64_t));
+	if (init_bits) {
+		heap_alloc->init_stat = HEAP_TRACE_STAT(heap_alloc) + (heap_alloc->flags & HEAP_ALLOC_TRACE_BITS ? HEAP_BIT_WORDS(heap_alloc->capacity) : 0);
+		memset(heap_alloc->init_stat, 0, HEAP_BIT_WORDS(req_size) * sizeof(uint64_t));
 	}
+	else
+		heap_alloc->init_stat = NULL;
 	return heap_alloc;
 #undef CHECK_HEAP_COUNT
 }
 
-static void free_type_signature(machine_type_sig_t* type_sig) {
-	if (type_sig->super_signature != TYPE_TYPEARG && type_sig->sub_type_count) {
-		for (uint_fast8_t i = 0; i < type_sig->sub_type_count; i++)
-			free_type_signature(&type_sig->sub_types[i]);
-		free(type_sig->sub_types);
-	}
+heap_alloc_t* machine_alloc(machine_t* machine, uint64_t req_size, gc_trace_mode_t trace_mode) {
+	return alloc_block(machine, req_size, trace_mode, 1);
+}
+
+heap_alloc_t* machine_alloc_initialized(machine_t* machine, uint64_t req_size, gc_trace_mode_t trace_mode) {
+	return alloc_block(machine, req_size, trace_mode, 0);
 }
 
+//releases what a heap object owns outside of its block
 static void free_heap_alloc(machine_t* machine, heap_alloc_t* heap_alloc) {
-	if (heap_alloc->limit) {
-		free(heap_alloc->registers);
-		free(heap_alloc->init_stat);
-		if (heap_alloc->trace_mode == GC_TRACE_MODE_SOME)
-			free(heap_alloc->trace_stat);
-	}
-	if (!(heap_alloc->type_sig >= machine->defined_signatures && heap_alloc->type_sig < (machine->defined_signatures + machine->defined_sig_count))) {
-		free_type_signature(heap_alloc->type_sig);
-		free(heap_alloc->type_sig);
+	if (heap_alloc->flags & HEAP_ALLOC_RESIZED) {
+		reclaim_block(machine, heap_alloc->registers);
+		heap_alloc->flags &= ~HEAP_ALLOC_RESIZED;
+		heap_alloc->capacity = 0; //the block's own room was forgotten when its registers moved out
 	}
+	heap_alloc->type_sig = NULL; //an interned signature is reclaimed by the next sweep that finds nothing else marking it
 }
 
 static int recycle_heap_alloc(machine_t* machine, heap_alloc_t* heap_alloc) {
+	if (heap_alloc->size_class) {
+		//a frame's region is never rewound below a block that sits on a free list
+		char* block_end = (char*)heap_alloc + heap_alloc->size_class * HEAP_SLAB_GRANULE;
+		if (block_end > machine->slab_freed_top && block_end <= machine->slab_end && (char*)heap_alloc > (char*)machine->slabs)
+			machine->slab_freed_top = block_end;
+		heap_alloc->registers = (machine_reg_t*)machine->slab_free[heap_alloc->size_class];
+		machine->slab_free[heap_alloc->size_class] = heap_alloc;
+		return 1;
+	}
 	if (machine->freed_heap_count == machine->alloc_freed_heaps) {
-		heap_alloc_t** new_freed_heaps = realloc(machine->freed_heap_allocs, (machine->alloc_freed_heaps += 10) * sizeof(heap_alloc_t*));
+		heap_alloc_t** new_freed_heaps = realloc(machine->freed_heap_allocs, (machine->alloc_freed_heaps *= 2) * sizeof(heap_alloc_t*));
 		PANIC_ON_FAIL(new_freed_heaps, machine, ERROR_MEMORY);
 		machine->freed_heap_allocs = new_freed_heaps;
 	}
@@ -91,131 +207,370 @@ static int recycle_heap_alloc(machine_t* machine, heap_alloc_t* heap_alloc) {
 	return 1;
 }
 
-int free_alloc(machine_t* machine, heap_alloc_t* heap_alloc) {
-	if (heap_alloc->pre_freed || heap_alloc->gc_flag)
-		return 1;
-	heap_alloc->pre_freed = 1;
+#if defined(__GNUC__)
+#define HEAP_PREFETCH(ALLOC) __builtin_prefetch(ALLOC)
+#else
+#define HEAP_PREFETCH(ALLOC)
+#endif
 
-	switch (heap_alloc->trace_mode) {
-	case GC_TRACE_MODE_ALL:
-		for (uint_fast16_t i = 0; i < heap_alloc->limit; i++)
-			if (heap_alloc->init_stat[i])
-				ESCAPE_ON_FAIL(free_alloc(machine, heap_alloc->registers[i].heap_alloc));
-		break;
-	case GC_TRACE_MODE_SOME:
-		if (heap_alloc->limit) {
-			for (uint_fast16_t i = 0; i < heap_alloc->limit; i++)
-				if (heap_alloc->init_stat[i] && heap_alloc->trace_stat[i])
-					ESCAPE_ON_FAIL(free_alloc(machine, heap_alloc->registers[i].heap_alloc));
-		}
-		break;
+//makes room for count more objects on the mark stack
+static int reserve_marks(machine_t* machine, uint64_t count) {
+	if (machine->mark_count + count > machine->alloced_marks) {
+		uint64_t new_size = (uint64_t)machine->alloced_marks * 2 + count;
+		if (new_size > UINT32_MAX)
+			PANIC(machine, ERROR_MEMORY);
+		heap_alloc_t** new_mark_stack = realloc(machine->mark_stack, new_size * sizeof(heap_alloc_t*));
+		PANIC_ON_FAIL(new_mark_stack, machine, ERROR_MEMORY);
+		machine->mark_stack = new_mark_stack;
+		machine->alloced_marks = new_size;
 	}
-	free_heap_alloc(machine, heap_alloc);
-	return recycle_heap_alloc(machine, heap_alloc);
+	return 1;
 }
 
-static void machine_heap_supertrace(machine_t* machine, heap_alloc_t* heap_alloc) {
-	if (heap_alloc->gc_flag)
-		return;
-	heap_alloc->gc_flag = 1;
+//pushes every reference an object holds onto the mark stack, prefetching their headers so they're close by once popped
+static int push_children(machine_t* machine, heap_alloc_t* heap_alloc) {
 	switch (heap_alloc->trace_mode) {
 	case GC_TRACE_MODE_ALL:
-		for (uint_fast16_t i = 0; i < heap_alloc->limit; i++)
-			if (heap_alloc->init_stat[i])
-				machine_heap_supertrace(machine, heap_alloc->registers[i].heap_alloc);
+		ESCAPE_ON_FAIL(reserve_marks(machine, heap_alloc->limit));
+		for (uint_fast32_t i = 0; i < heap_alloc->limit; i++)
+			if (HEAP_IS_INIT(heap_alloc, i)) {
+				HEAP_PREFETCH(heap_alloc->registers[i].heap_alloc);
+				machine->mark_stack[machine->mark_count++] = heap_alloc->registers[i].heap_alloc;
+			}
 		break;
 	case GC_TRACE_MODE_SOME:
-		for (uint_fast16_t i = 0; i < heap_alloc->limit; i++)
-			if (heap_alloc->init_stat[i] && heap_alloc->trace_stat[i])
-				machine_heap_supertrace(machine, heap_alloc->registers[i].heap_alloc);
+		ESCAPE_ON_FAIL(reserve_marks(machine, heap_alloc->limit));
+		for (uint_fast32_t i = 0; i < heap_alloc->limit; i++)
+			if (HEAP_IS_INIT(heap_alloc, i) && HEAP_BIT(HEAP_TRACE_STAT(heap_alloc), i)) {
+				HEAP_PREFETCH(heap_alloc->registers[i].heap_alloc);
+				machine->mark_stack[machine->mark_count++] = heap_alloc->registers[i].heap_alloc;
+			}
 		break;
 	}
+	return 1;
 }
 
-static void machine_heap_detrace(machine_t* machine, heap_alloc_t* heap_alloc) {
-	if (!heap_alloc->gc_flag)
-		return;
-	heap_alloc->gc_flag = 0;
-	switch (heap_alloc->trace_mode) {
-	case GC_TRACE_MODE_ALL:
-		for (uint_fast16_t i = 0; i < heap_alloc->limit; i++)
-			if (heap_alloc->init_stat[i])
-				machine_heap_detrace(machine, heap_alloc->registers[i].heap_alloc);
-		break;
-	case GC_TRACE_MODE_SOME:
-		for (uint_fast16_t i = 0; i < heap_alloc->limit; i++)
-			if (heap_alloc->init_stat[i] && heap_alloc->trace_stat[i])
-				machine_heap_detrace(machine, heap_alloc->registers[i].heap_alloc);
-		break;
+//the traversals below walk the mark stack down to where it stood when they began, so objects are never visited by recursing on the native stack
+int free_alloc(machine_t* machine, heap_alloc_t* heap_alloc) {
+	uint32_t base = machine->mark_count;
+	ESCAPE_ON_FAIL(reserve_marks(machine, 1));
+	machine->mark_stack[machine->mark_count++] = heap_alloc;
+	while (machine->mark_count > base) {
+		heap_alloc = machine->mark_stack[--machine->mark_count];
+		if (heap_alloc->flags & (HEAP_ALLOC_PRE_FREED | HEAP_ALLOC_GC_FLAG | HEAP_ALLOC_INC_MARK))
+			continue;
+		heap_alloc->flags |= HEAP_ALLOC_PRE_FREED;
+		ESCAPE_ON_FAIL(push_children(machine, heap_alloc));
+		free_heap_alloc(machine, heap_alloc);
+		ESCAPE_ON_FAIL(recycle_heap_alloc(machine, heap_alloc));
+	}
+	return 1;
+}
+
+static int machine_heap_supertrace(machine_t* machine, heap_alloc_t* heap_alloc) {
+	uint32_t base = machine->mark_count;
+	ESCAPE_ON_FAIL(reserve_marks(machine, 1));
+	machine->mark_stack[machine->mark_count++] = heap_alloc;
+	while (machine->mark_count > base) {
+		heap_alloc = machine->mark_stack[--machine->mark_count];
+		if (heap_alloc->flags & HEAP_ALLOC_GC_FLAG)
+			continue;
+		heap_alloc->flags |= HEAP_ALLOC_GC_FLAG;
+		ESCAPE_ON_FAIL(push_children(machine, heap_alloc));
+	}
+	return 1;
+}
+
+static int machine_heap_detrace(machine_t* machine, heap_alloc_t* heap_alloc) {
+	uint32_t base = machine->mark_count;
+	ESCAPE_ON_FAIL(reserve_marks(machine, 1));
+	machine->mark_stack[machine->mark_count++] = heap_alloc;
+	while (machine->mark_count > base) {
+		heap_alloc = machine->mark_stack[--machine->mark_count];
+		if (!(heap_alloc->flags & HEAP_ALLOC_GC_FLAG))
+			continue;
+		heap_alloc->flags &= ~HEAP_ALLOC_GC_FLAG;
+		//the flag kept it alive when the incremental collection in progress began, so it has to outlive the collection
+		if ((machine->gc_phase == GC_PHASE_MARK || machine->gc_phase == GC_PHASE_SWEEP) && !(heap_alloc->flags & HEAP_ALLOC_INC_MARK))
+			ESCAPE_ON_FAIL(inc_keep(machine, heap_alloc));
+		ESCAPE_ON_FAIL(push_children(machine, heap_alloc));
 	}
+	return 1;
 }
 
 static int machine_heap_trace(machine_t* machine, heap_alloc_t* heap_alloc) {
-	if (heap_alloc->gc_flag)
-		return 1;
+	uint32_t base = machine->mark_count;
+	ESCAPE_ON_FAIL(reserve_marks(machine, 1));
+	machine->mark_stack[machine->mark_count++] = heap_alloc;
+	while (machine->mark_count > base) {
+		heap_alloc = machine->mark_stack[--machine->mark_count];
+		if (heap_alloc->flags & HEAP_ALLOC_GC_FLAG)
+			continue;
+
+		if (machine->reset_count == machine->alloced_reset) {
+			heap_alloc_t** new_reset_stack = realloc(machine->reset_stack, (machine->alloced_reset *= 2) * sizeof(heap_alloc_t*));
+			PANIC_ON_FAIL(new_reset_stack, machine, ERROR_MEMORY);
+			machine->reset_stack = new_reset_stack;
+		}
 
-	if (machine->reset_count == machine->alloced_reset) {
-		heap_alloc_t** new_reset_stack = realloc(machine->reset_stack, (machine->alloced_reset += 32) * sizeof(heap_alloc_t*));
-		PANIC_ON_FAIL(new_reset_stack, machine, ERROR_MEMORY);
-		machine->reset_stack = new_reset_stack;
+		heap_alloc->flags |= HEAP_ALLOC_GC_FLAG;
+		machine->reset_stack[machine->reset_count++] = heap_alloc;
+		ESCAPE_ON_FAIL(push_children(machine, heap_alloc));
 	}
+	return 1;
+}
 
-	heap_alloc->gc_flag = 1;
-	machine->reset_stack[machine->reset_count++] = heap_alloc;
+static uint64_t gc_clock(void) {
+	struct timespec now;
+	timespec_get(&now, TIME_UTC);
+	return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
 
-	switch (heap_alloc->trace_mode) {
-	case GC_TRACE_MODE_ALL:
-		for (uint_fast16_t i = 0; i < heap_alloc->limit; i++)
-			if (heap_alloc->init_stat[i])
-				ESCAPE_ON_FAIL(machine_heap_trace(machine, heap_alloc->registers[i].heap_alloc));
-		break;
-	case GC_TRACE_MODE_SOME:
-		for (uint_fast16_t i = 0; i < heap_alloc->limit; i++)
-			if (heap_alloc->init_stat[i] && heap_alloc->trace_stat[i])
-				ESCAPE_ON_FAIL(machine_heap_trace(machine, heap_alloc->registers[i].heap_alloc));
-		break;
+//files the wall time of a clean or slice that began at start under the pause histogram and the statistics
+static void record_pause(machine_t* machine, uint64_t start) {
+	uint64_t nanos = gc_clock() - start;
+	if (machine->record_pauses) {
+		uint64_t micros = nanos / 1000;
+		uint_fast8_t bucket = 0;
+		while (bucket < MACHINE_GC_PAUSE_BUCKETS - 1 && micros >> bucket)
+			bucket++;
+		machine->gc_pauses[bucket]++;
+		if (micros > machine->max_gc_pause)
+			machine->max_gc_pause = micros;
 	}
+	if (machine->gc_stats) {
+		machine->gc_stats->collections++;
+		machine->gc_stats->total_collection_ns += nanos;
+		if (nanos > machine->gc_stats->max_collection_ns)
+			machine->gc_stats->max_collection_ns = nanos;
+	}
+}
+
+//marks an object without scanning it, so it lives through the incremental collection in progress
+static int inc_keep(machine_t* machine, heap_alloc_t* heap_alloc) {
+	if (machine->inc_marked_count == machine->alloced_inc_marked) {
+		heap_alloc_t** new_inc_marked = realloc(machine->inc_marked, (machine->alloced_inc_marked *= 2) * sizeof(heap_alloc_t*));
+		PANIC_ON_FAIL(new_inc_marked, machine, ERROR_MEMORY);
+		machine->inc_marked = new_inc_marked;
+	}
+	heap_alloc->flags |= HEAP_ALLOC_INC_MARK;
+	machine->inc_marked[machine->inc_marked_count++] = heap_alloc;
 	return 1;
 }
 
-static int machine_gc_clean(machine_t* machine) {
+//marks an object and queues it to have its references marked by a later slice
+static int inc_shade(machine_t* machine, heap_alloc_t* heap_alloc) {
+	//stale references left in objects from before the collection began may lead to blocks that have been freed since, which are never scanned
+	if ((heap_alloc->flags & (HEAP_ALLOC_INC_MARK | HEAP_ALLOC_REG_WITH_TABLE | HEAP_ALLOC_PRE_FREED)) != HEAP_ALLOC_REG_WITH_TABLE)
+		return 1;
+	ESCAPE_ON_FAIL(inc_keep(machine, heap_alloc));
+	if (heap_alloc->trace_mode != GC_TRACE_MODE_NONE) {
+		ESCAPE_ON_FAIL(reserve_marks(machine, 1));
+		machine->mark_stack[machine->mark_count++] = heap_alloc;
+	}
+	return 1;
+}
+
+//snapshot-at-the-beginning write barrier: whatever a store overwrites while marking is marked, so everything reachable when the frame was deferred survives
+static int machine_gc_barrier(machine_t* machine, heap_alloc_t* heap_alloc, uint64_t index) {
+	if (index >= heap_alloc->limit || !HEAP_IS_INIT(heap_alloc, index))
+		return 1;
+	if (heap_alloc->trace_mode == GC_TRACE_MODE_NONE || (heap_alloc->trace_mode == GC_TRACE_MODE_SOME && !HEAP_BIT(HEAP_TRACE_STAT(heap_alloc), index)))
+		return 1;
+	return inc_shade(machine, heap_alloc->registers[index].heap_alloc);
+}
+
+//does up to budget objects' worth of the incremental collection's work, returning to the idle phase once it's complete
+static int machine_gc_step(machine_t* machine, uint64_t budget) {
+	while (budget) {
+		switch (machine->gc_phase) {
+		case GC_PHASE_MARK: {
+			if (!machine->mark_count) {
+				machine->gc_phase = GC_PHASE_SWEEP;
+				break;
+			}
+			heap_alloc_t* heap_alloc = machine->mark_stack[--machine->mark_count];
+			if (machine->gc_stats)
+				machine->gc_stats->traced++;
+			for (uint_fast32_t i = 0; i < heap_alloc->limit; i++)
+				if (HEAP_IS_INIT(heap_alloc, i) && (heap_alloc->trace_mode == GC_TRACE_MODE_ALL || HEAP_BIT(HEAP_TRACE_STAT(heap_alloc), i)))
+					ESCAPE_ON_FAIL(inc_shade(machine, heap_alloc->registers[i].heap_alloc));
+			uint64_t cost = 1 + heap_alloc->limit / 64;
+			budget -= cost < budget ? cost : budget;
+			break;
+		}
+		case GC_PHASE_SWEEP: {
+			if (machine->inc_cursor == machine->inc_end) {
+				//entries registered since the frame was deferred close the gap the swept ones left, along with the bounds of the frames they're in
+				uint32_t removed = machine->inc_end - machine->inc_write;
+				memmove(&machine->heap_allocs[machine->inc_write], &machine->heap_allocs[machine->inc_end], (machine->heap_count - machine->inc_end) * sizeof(heap_alloc_t*));
+				machine->heap_count -= removed;
+				for (uint_fast32_t i = 0; i < machine->heap_frame; i++)
+					if (machine->heap_frame_bounds[i] >= machine->inc_end)
+						machine->heap_frame_bounds[i] -= removed;
+				machine->gc_phase = GC_PHASE_UNMARK;
+				break;
+			}
+			heap_alloc_t* heap_alloc = machine->heap_allocs[machine->inc_cursor++];
+			if (machine->gc_stats)
+				machine->gc_stats->swept++;
+			if (heap_alloc->flags & (HEAP_ALLOC_GC_FLAG | HEAP_ALLOC_INC_MARK)) {
+				machine->heap_allocs[machine->inc_write++] = heap_alloc;
+				if (machine->gc_stats)
+					machine->gc_stats->survived++;
+			}
+			else if (heap_alloc->flags & HEAP_ALLOC_PRE_FREED)
+				heap_alloc->flags &= ~HEAP_ALLOC_REG_WITH_TABLE;
+			else {
+				if (machine->gc_stats)
+					machine->gc_stats->freed++;
+				free_heap_alloc(machine, heap_alloc);
+				heap_alloc->flags &= ~HEAP_ALLOC_REG_WITH_TABLE;
+				ESCAPE_ON_FAIL(recycle_heap_alloc(machine, heap_alloc));
+			}
+			budget--;
+			break;
+		}
+		case GC_PHASE_UNMARK:
+			if (!machine->inc_marked_count) {
+				machine->gc_phase = GC_PHASE_IDLE;
+				return 1;
+			}
+			machine->inc_marked[--machine->inc_marked_count]->flags &= ~HEAP_ALLOC_INC_MARK;
+			budget--;
+			break;
+		default:
+			return 1;
+		}
+	}
+	return 1;
+}
+
+static int machine_gc_slice(machine_t* machine) {
+	if (!machine->record_pauses && !machine->gc_stats)
+		return machine_gc_step(machine, machine->gc_slice);
+	uint64_t start = gc_clock();
+	ESCAPE_ON_FAIL(machine_gc_step(machine, machine->gc_slice));
+	record_pause(machine, start);
+	return 1;
+}
+
+//starts collecting the frame being cleaned incrementally: its roots are marked now, while its objects stay in the heap table until they're swept
+static int defer_frame(machine_t* machine) {
+	for (uint_fast32_t i = machine->trace_frame_bounds[machine->heap_frame]; i < machine->trace_count; i++)
+		if (machine->heap_traces[i]->flags & HEAP_ALLOC_GC_FLAG) {
+			machine->heap_traces[i]->flags &= ~HEAP_ALLOC_GC_FLAG;
+			ESCAPE_ON_FAIL(machine_heap_supertrace(machine, machine->heap_traces[i]));
+		}
+		else
+			ESCAPE_ON_FAIL(inc_shade(machine, machine->heap_traces[i]));
+	machine->trace_count = machine->trace_frame_bounds[machine->heap_frame];
+
+	machine->inc_start = machine->inc_cursor = machine->inc_write = machine->heap_frame_bounds[machine->heap_frame];
+	machine->inc_end = machine->heap_count;
+	machine->gc_phase = GC_PHASE_MARK;
+	return 1;
+}
+
+//super-traces the frame's flagged roots first, then hands the rest to the parallel markers, which are partitioned among them
+static int trace_roots_parallel(machine_t* machine) {
+	uint32_t root_start = machine->trace_frame_bounds[machine->heap_frame];
+	uint32_t root_end = root_start;
+	for (uint_fast32_t i = root_start; i < machine->trace_count; i++)
+		if (machine->heap_traces[i]->flags & HEAP_ALLOC_GC_FLAG) {
+			machine->heap_traces[i]->flags &= ~HEAP_ALLOC_GC_FLAG;
+			ESCAPE_ON_FAIL(machine_heap_supertrace(machine, machine->heap_traces[i]));
+		}
+		else
+			machine->heap_traces[root_end++] = machine->heap_traces[i];
+	return gc_mark_parallel(machine, &machine->heap_traces[root_start], root_end - root_start);
+}
+
+static int collect_frame(machine_t* machine) {
 	machine->reset_count = 0;
 
 	--machine->heap_frame;
+	//a deferred frame lies in the range of every frame below it, so it's finished before any of them is cleaned
+	if (machine->gc_phase && machine->heap_frame_bounds[machine->heap_frame] <= machine->inc_start)
+		ESCAPE_ON_FAIL(machine_gc_step(machine, UINT64_MAX));
 	heap_alloc_t** frame_start = &machine->heap_allocs[machine->heap_frame_bounds[machine->heap_frame]];
 	heap_alloc_t** frame_end = &machine->heap_allocs[machine->heap_count];
 
 	if (machine->heap_frame) {
-		for (uint_fast16_t i = machine->trace_frame_bounds[machine->heap_frame]; i < machine->trace_count; i++)
-			if (machine->heap_traces[i]->gc_flag) {
-				machine->heap_traces[i]->gc_flag = 0;
-				machine_heap_supertrace(machine, machine->heap_traces[i]);
-			}
-			else
-				ESCAPE_ON_FAIL(machine_heap_trace(machine, machine->heap_traces[i]));
+		if (machine->gc_slice && !machine->gc_phase && frame_end - frame_start > machine->gc_slice)
+			return defer_frame(machine);
+
+		char* region_floor = NULL;
+		if (machine->gc_threads > 1 && frame_end - frame_start >= GC_PARALLEL_MIN_OBJECTS) {
+			ESCAPE_ON_FAIL(trace_roots_parallel(machine));
+		}
+		else
+			for (uint_fast32_t i = machine->trace_frame_bounds[machine->heap_frame]; i < machine->trace_count; i++)
+				if (machine->heap_traces[i]->flags & HEAP_ALLOC_GC_FLAG) {
+					machine->heap_traces[i]->flags &= ~HEAP_ALLOC_GC_FLAG;
+					ESCAPE_ON_FAIL(machine_heap_supertrace(machine, machine->heap_traces[i]));
+				}
+				else
+					ESCAPE_ON_FAIL(machine_heap_trace(machine, machine->heap_traces[i]));
+
+		//blocks carved from the current slab since the frame opened form its region, which is rewound down to its highest survivor
+		char* mark = machine->region_marks[machine->heap_frame];
+		if (machine->slab_top != mark) {
+			char* slab_start = (char*)machine->slabs + HEAP_SLAB_GRANULE;
+			region_floor = mark >= slab_start && mark <= machine->slab_top ? mark : slab_start;
+			if (machine->slab_freed_top > region_floor)
+				region_floor = machine->slab_freed_top;
+			for (heap_alloc_t** current_alloc = frame_start; current_alloc != frame_end; current_alloc++)
+				if ((*current_alloc)->flags & (HEAP_ALLOC_GC_FLAG | HEAP_ALLOC_INC_MARK) && (char*)*current_alloc >= region_floor && (char*)*current_alloc < machine->slab_top)
+					region_floor = (char*)*current_alloc + (*current_alloc)->size_class * HEAP_SLAB_GRANULE;
+		}
 
+		heap_alloc_t** swept_start = frame_start;
+		uint32_t freed = 0;
 		for (heap_alloc_t** current_alloc = frame_start; current_alloc != frame_end; current_alloc++) {
-			if ((*current_alloc)->gc_flag)
+			if ((*current_alloc)->flags & (HEAP_ALLOC_GC_FLAG | HEAP_ALLOC_INC_MARK))
 				*frame_start++ = *current_alloc;
-			else if ((*current_alloc)->pre_freed)
-				(*current_alloc)->reg_with_table = 0;
+			else if ((*current_alloc)->flags & HEAP_ALLOC_PRE_FREED)
+				(*current_alloc)->flags &= ~HEAP_ALLOC_REG_WITH_TABLE;
 			else {
+				freed++;
 				free_heap_alloc(machine, *current_alloc);
-				(*current_alloc)->reg_with_table = 0;
-				ESCAPE_ON_FAIL(recycle_heap_alloc(machine, *current_alloc));
+				(*current_alloc)->flags &= ~HEAP_ALLOC_REG_WITH_TABLE;
+				//dead blocks above the floor go back with the rest of the region
+				if (!region_floor || (char*)*current_alloc < region_floor || (char*)*current_alloc >= machine->slab_top)
+					ESCAPE_ON_FAIL(recycle_heap_alloc(machine, *current_alloc));
 			}
 		}
+		if (region_floor)
+			machine->slab_top = region_floor;
 		machine->heap_count = frame_start - machine->heap_allocs;
 		machine->trace_count = machine->trace_frame_bounds[machine->heap_frame];
 
-		for (uint_fast16_t i = 0; i < machine->reset_count; i++)
-			machine->reset_stack[i]->gc_flag = 0;
+		for (uint_fast32_t i = 0; i < machine->reset_count; i++)
+			machine->reset_stack[i]->flags &= ~HEAP_ALLOC_GC_FLAG;
+
+		if (machine->gc_stats) {
+			machine->gc_stats->traced += machine->reset_count;
+			machine->gc_stats->swept += frame_end - swept_start;
+			machine->gc_stats->survived += frame_start - swept_start;
+			machine->gc_stats->freed += freed;
+			if (machine->reset_count > machine->gc_stats->reset_high_water)
+				machine->gc_stats->reset_high_water = machine->reset_count;
+		}
 	}
 	else {
+		if (machine->gc_stats)
+			machine->gc_stats->swept += frame_end - frame_start;
 		for (heap_alloc_t** current_alloc = frame_start; current_alloc != frame_end; current_alloc++) {
-			if (!(*current_alloc)->pre_freed) {
+			(*current_alloc)->flags &= ~HEAP_ALLOC_REG_WITH_TABLE;
+			if (!((*current_alloc)->flags & HEAP_ALLOC_PRE_FREED)) {
+				if (machine->gc_stats)
+					machine->gc_stats->freed++;
 				free_heap_alloc(machine, *current_alloc);
-				free(*current_alloc);
+				if ((*current_alloc)->size_class)
+					recycle_heap_alloc(machine, *current_alloc);
+				else
+					free(*current_alloc);
 			}
 		}
 		machine->heap_count = 0;
@@ -223,27 +578,61 @@ static int machine_gc_clean(machine_t* machine) {
 	return 1;
 }
 
-//makes a copy of a type signature, given a prototype defined signature which may contain context dependent type parameters that may escape
+//interned signatures are only held by defined signatures and heap objects between instructions, so a clean can sweep the ones neither marks
+//an incremental collection in progress may leave dead objects with stale signatures in the heap table, so the sweep waits for it to finish
+static int sweep_typesigs(machine_t* machine) {
+	if (machine->gc_phase || !typesig_should_sweep(machine))
+		return 1;
+	for (uint_fast32_t i = 0; i < machine->defined_sig_count; i++)
+		typesig_mark(machine->defined_signatures[i]);
+	for (uint_fast32_t i = 0; i < machine->heap_count; i++) {
+		machine_type_sig_t* type_sig = machine->heap_allocs[i]->type_sig;
+		if (type_sig && !(type_sig >= machine->defined_signatures && type_sig < machine->defined_signatures + machine->defined_sig_count))
+			typesig_mark_array(type_sig);
+	}
+	return typesig_sweep(machine, machine->heap_count);
+}
+
+static int machine_gc_clean(machine_t* machine) {
+	if (!machine->record_pauses && !machine->gc_stats)
+		return collect_frame(machine) && sweep_typesigs(machine);
+	if (machine->gc_stats)
+		machine->gc_stats->cleans_by_depth[machine->heap_frame - 1 < GC_STATS_DEPTH_BUCKETS ? machine->heap_frame - 1 : GC_STATS_DEPTH_BUCKETS - 1]++;
+	uint64_t start = gc_clock();
+	ESCAPE_ON_FAIL(collect_frame(machine));
+	ESCAPE_ON_FAIL(sweep_typesigs(machine));
+	record_pause(machine, start);
+	return 1;
+}
+
+//interns a type signature, given a prototype defined signature which may contain context dependent type parameters that may escape
 static int atomize_heap_type_sig(machine_t* machine, machine_type_sig_t prototype, machine_type_sig_t* output, int atom_typeargs) {
 	if (prototype.super_signature == TYPE_TYPEARG && atom_typeargs)
 		return atomize_heap_type_sig(machine, machine->defined_signatures[machine->stack[prototype.sub_type_count + machine->global_offset].long_int], output, 1);
-	else {
-		output->super_signature = prototype.super_signature;
-		if ((output->sub_type_count = prototype.sub_type_count) && prototype.super_signature != TYPE_TYPEARG) {
-			PANIC_ON_FAIL(output->sub_types = malloc(prototype.sub_type_count * sizeof(machine_type_sig_t)), machine, ERROR_MEMORY);
-			for (uint_fast8_t i = 0; i < output->sub_type_count; i++)
-				ESCAPE_ON_FAIL(atomize_heap_type_sig(machine, prototype.sub_types[i], &output->sub_types[i], atom_typeargs));
+	*output = prototype;
+	if (prototype.sub_type_count && prototype.super_signature != TYPE_TYPEARG) {
+		machine_type_sig_t sub_types[TYPE_MAX_SUBTYPES];
+		int changed = 0;
+		for (uint_fast8_t i = 0; i < prototype.sub_type_count; i++) {
+			ESCAPE_ON_FAIL(atomize_heap_type_sig(machine, prototype.sub_types[i], &sub_types[i], atom_typeargs));
+			changed = changed || !TYPESIG_EQ(sub_types[i], prototype.sub_types[i]);
 		}
+		if (changed) //a prototype without type parameters below it is already its own atom
+			ESCAPE_ON_FAIL(output->sub_types = typesig_intern(machine, sub_types, prototype.sub_type_count));
 	}
 	return 1;
 }
 
-static int get_super_type(machine_t* machine, machine_type_sig_t* child_typeargs, machine_type_sig_t* output) {
-	if (output->super_signature == TYPE_TYPEARG)
-		ESCAPE_ON_FAIL(atomize_heap_type_sig(machine, child_typeargs[output->sub_type_count], output, 1))
-	else {
-		for (uint_fast8_t i = 0; i < output->sub_type_count; i++)
-			ESCAPE_ON_FAIL(get_super_type(machine, child_typeargs, &output->sub_types[i]));
+//substitutes a child record's type arguments into the signature of its base record
+static int get_super_type(machine_t* machine, machine_type_sig_t* child_typeargs, machine_type_sig_t prototype, machine_type_sig_t* output) {
+	if (prototype.super_signature == TYPE_TYPEARG)
+		return atomize_heap_type_sig(machine, child_typeargs[prototype.sub_type_count], output, 1);
+	*output = prototype;
+	if (prototype.sub_type_count) {
+		machine_type_sig_t sub_types[TYPE_MAX_SUBTYPES];
+		for (uint_fast8_t i = 0; i < prototype.sub_type_count; i++)
+			ESCAPE_ON_FAIL(get_super_type(machine, child_typeargs, prototype.sub_types[i], &sub_types[i]));
+		ESCAPE_ON_FAIL(output->sub_types = typesig_intern(machine, sub_types, prototype.sub_type_count));
 	}
 	return 1;
 }
@@ -267,9 +656,7 @@ static int downcast_type_signature(machine_t* machine, machine_type_sig_t* sig,
 	while (sig->super_signature != req_record)
 	{
 		machine_type_sig_t super_type;
-		ESCAPE_ON_FAIL(atomize_heap_type_sig(machine, machine->defined_signatures[machine->type_table[sig->super_signature - TYPE_SUPER_RECORD] - 1], &super_type, 0));
-		ESCAPE_ON_FAIL(get_super_type(machine, sig->sub_types, &super_type));
-		free_type_signature(sig);
+		ESCAPE_ON_FAIL(get_super_type(machine, sig->sub_types, machine->defined_signatures[machine->type_table[sig->super_signature - TYPE_SUPER_RECORD] - 1], &super_type));
 		*sig = super_type;
 	}
 	return 1;
@@ -283,6 +670,8 @@ static int type_signature_match(machine_t* machine, machine_type_sig_t match_sig
 		match_signature = machine->defined_signatures[machine->stack[match_signature.sub_type_count + machine->global_offset].long_int];
 	if (parent_signature.super_signature == TYPE_TYPEARG)
 		parent_signature = machine->defined_signatures[machine->stack[parent_signature.sub_type_count + machine->global_offset].long_int];
+	if (TYPESIG_EQ(match_signature, parent_signature))
+		return 1;
 
 	if (match_signature.super_signature != parent_signature.super_signature) {
 		if (is_super_type(machine, match_signature.super_signature, parent_signature.super_signature)) {
@@ -291,11 +680,8 @@ static int type_signature_match(machine_t* machine, machine_type_sig_t match_sig
 			ESCAPE_ON_FAIL(get_super_type(machine, match_signature.sub_types, &super_type));
 			int res = type_signature_match(machine, super_type, parent_signature);
 			free_type_signature(&super_type);*/
-			ESCAPE_ON_FAIL(atomize_heap_type_sig(machine, match_signature, &match_signature, 0));
 			ESCAPE_ON_FAIL(downcast_type_signature(machine, &match_signature, parent_signature.super_signature));
-			int res = type_signature_match(machine, match_signature, parent_signature);
-			free_type_signature(&match_signature);
-			return res;
+			return type_signature_match(machine, match_signature, parent_signature);
 		}
 		return 0;
 	}
@@ -305,9 +691,118 @@ static int type_signature_match(machine_t* machine, machine_type_sig_t match_sig
 	return 1;
 }
 
-int init_machine(machine_t* machine, uint16_t stack_size, uint16_t frame_limit, uint16_t type_count) {
-	machine->frame_limit = frame_limit;
-	machine->stack_size = stack_size;
+//the whole stack is reserved up front, so registers never move and jitted or compiled code can keep pointers into it
+static machine_reg_t* reserve_stack(uint32_t max_stack_size) {
+#ifdef _WIN32
+	return VirtualAlloc(NULL, (size_t)max_stack_size * sizeof(machine_reg_t), MEM_RESERVE, PAGE_NOACCESS);
+#else
+	void* stack = mmap(NULL, (size_t)max_stack_size * sizeof(machine_reg_t), PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	return stack == MAP_FAILED ? NULL : stack;
+#endif
+}
+
+static void release_stack(machine_t* machine) {
+#ifdef _WIN32
+	VirtualFree(machine->stack, 0, MEM_RELEASE);
+#else
+	munmap(machine->stack, (size_t)machine->max_stack_size * sizeof(machine_reg_t));
+#endif
+}
+
+int machine_grow_stack(machine_t* machine, uint64_t required_size) {
+	if (required_size > machine->max_stack_size)
+		PANIC(machine, ERROR_STACK_OVERFLOW);
+	uint64_t new_size = machine->stack_size ? machine->stack_size : 1;
+	while (new_size < required_size)
+		new_size *= 2;
+	if (new_size > machine->max_stack_size)
+		new_size = machine->max_stack_size;
+
+	//committing the already committed prefix again is harmless, and keeps the range page aligned
+#ifdef _WIN32
+	PANIC_ON_FAIL(VirtualAlloc(machine->stack, new_size * sizeof(machine_reg_t), MEM_COMMIT, PAGE_READWRITE), machine, ERROR_MEMORY);
+#else
+	PANIC_ON_FAIL(!mprotect(machine->stack, new_size * sizeof(machine_reg_t), PROT_READ | PROT_WRITE), machine, ERROR_MEMORY);
+#endif
+	machine->stack_size = new_size;
+	return 1;
+}
+
+int machine_grow_frames(machine_t* machine) {
+	if (machine->frame_limit == machine->max_frame_limit)
+		PANIC(machine, ERROR_STACK_OVERFLOW);
+	uint32_t new_limit = machine->frame_limit > machine->max_frame_limit / 2 ? machine->max_frame_limit : machine->frame_limit * 2;
+
+	machine_ins_t** new_positions = realloc(machine->positions, new_limit * sizeof(machine_ins_t*));
+	PANIC_ON_FAIL(new_positions, machine, ERROR_MEMORY);
+	machine->positions = new_positions;
+	uint32_t* new_heap_bounds = realloc(machine->heap_frame_bounds, new_limit * sizeof(uint32_t));
+	PANIC_ON_FAIL(new_heap_bounds, machine, ERROR_MEMORY);
+	machine->heap_frame_bounds = new_heap_bounds;
+	uint32_t* new_trace_bounds = realloc(machine->trace_frame_bounds, new_limit * sizeof(uint32_t));
+	PANIC_ON_FAIL(new_trace_bounds, machine, ERROR_MEMORY);
+	machine->trace_frame_bounds = new_trace_bounds;
+	char** new_region_marks = realloc(machine->region_marks, new_limit * sizeof(char*));
+	PANIC_ON_FAIL(new_region_marks, machine, ERROR_MEMORY);
+	machine->region_marks = new_region_marks;
+
+	machine->frame_limit = new_limit;
+	return 1;
+}
+
+typedef struct native_run {
+	machine_t* machine;
+	int (*body)(machine_t* machine, void* arg);
+	void* arg;
+	int result;
+} native_run_t;
+
+#ifdef _WIN32
+static DWORD WINAPI run_native_body(LPVOID arg) {
+#else
+static void* run_native_body(void* arg) {
+#endif
+	native_run_t* run = arg;
+	run->result = run->body(run->machine, run->arg);
+	return 0;
+}
+
+//runs a native_run_t to completion on a thread with the given stack, or returns 0 if that stack can't be reserved
+static int run_on_stack(native_run_t* run, uint64_t stack_size) {
+#ifdef _WIN32
+	HANDLE thread = CreateThread(NULL, stack_size, run_native_body, run, STACK_SIZE_PARAM_IS_A_RESERVATION, NULL);
+	ESCAPE_ON_FAIL(thread);
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+#else
+	pthread_attr_t attr;
+	pthread_t thread;
+	ESCAPE_ON_FAIL(!pthread_attr_init(&attr));
+	int failed = pthread_attr_setstacksize(&attr, stack_size) || pthread_create(&thread, &attr, run_native_body, run);
+	pthread_attr_destroy(&attr);
+	ESCAPE_ON_FAIL(!failed);
+	pthread_join(thread, NULL);
+#endif
+	return 1;
+}
+
+int machine_run_native(machine_t* machine, uint64_t frame_size, int (*body)(machine_t* machine, void* arg), void* arg) {
+	native_run_t run = { .machine = machine, .body = body, .arg = arg, .result = 0 };
+	//a call limit whose stack can't be reserved is lowered until it fits, so calls past it raise a stack overflow
+	while (!run_on_stack(&run, machine->max_frame_limit * frame_size + MACHINE_NATIVE_STACK_RESERVE)) {
+		PANIC_ON_FAIL(machine->max_frame_limit > MACHINE_INITIAL_FRAME_LIMIT, machine, ERROR_MEMORY);
+		machine->max_frame_limit /= 2;
+		if (machine->frame_limit > machine->max_frame_limit)
+			machine->frame_limit = machine->max_frame_limit;
+	}
+	return run.result;
+}
+
+int init_machine(machine_t* machine, uint32_t max_stack_size, uint32_t max_frame_limit, uint16_t type_count) {
+	machine->max_stack_size = max_stack_size;
+	machine->max_frame_limit = max_frame_limit;
+	machine->frame_limit = max_frame_limit < MACHINE_INITIAL_FRAME_LIMIT ? max_frame_limit : MACHINE_INITIAL_FRAME_LIMIT;
+	machine->stack_size = 0;
 
 	machine->global_offset = 0;
 	machine->position_count = 0;
@@ -317,41 +812,75 @@ int init_machine(machine_t* machine, uint16_t stack_size, uint16_t frame_limit,
 	machine->freed_heap_count = 0;
 	machine->defined_sig_count = 0;
 	machine->reset_count = 0;
+	machine->mark_count = 0;
+	machine->mark_pool = NULL;
+	machine->gc_stats = NULL;
+	machine->reclaimer = NULL;
+	machine->typesigs = NULL;
+	machine->gc_threads = 1;
+	machine->inc_marked_count = 0;
+	machine->gc_slice = 0;
+	machine->gc_phase = GC_PHASE_IDLE;
+	machine->record_pauses = 0;
+	machine->max_gc_pause = 0;
+	memset(machine->gc_pauses, 0, sizeof(machine->gc_pauses));
+	memset(machine->slab_free, 0, sizeof(machine->slab_free));
+	machine->slab_top = machine->slab_end = machine->slab_freed_top = NULL;
+	machine->slabs = NULL;
+#ifdef CISH_COUNT_DISPATCHES
+	machine->dispatch_count = 0;
+#endif // CISH_COUNT_DISPATCHES
 
-	ESCAPE_ON_FAIL(machine->stack = malloc(stack_size * sizeof(machine_reg_t)));
+	//constants and globals are addressed directly, so everything a 16-bit operand reaches is committed from the start
+	ESCAPE_ON_FAIL(machine->stack = reserve_stack(max_stack_size));
+	ESCAPE_ON_FAIL(machine_grow_stack(machine, max_stack_size < UINT16_MAX + 1 ? max_stack_size : UINT16_MAX + 1));
 	ESCAPE_ON_FAIL(machine->positions = malloc(machine->frame_limit * sizeof(machine_ins_t*)));
-	ESCAPE_ON_FAIL(machine->heap_allocs = malloc((machine->alloced_heap_allocs = frame_limit) * sizeof(heap_alloc_t*)));
+	ESCAPE_ON_FAIL(machine->heap_allocs = malloc((machine->alloced_heap_allocs = machine->frame_limit) * sizeof(heap_alloc_t*)));
 	ESCAPE_ON_FAIL(machine->heap_traces = malloc((machine->alloced_trace_allocs = 128) * sizeof(heap_alloc_t*)));
-	ESCAPE_ON_FAIL(machine->heap_frame_bounds = malloc(machine->frame_limit * sizeof(uint16_t)));
-	ESCAPE_ON_FAIL(machine->trace_frame_bounds = malloc(machine->frame_limit * sizeof(uint16_t)));
+	ESCAPE_ON_FAIL(machine->heap_frame_bounds = malloc(machine->frame_limit * sizeof(uint32_t)));
+	ESCAPE_ON_FAIL(machine->trace_frame_bounds = malloc(machine->frame_limit * sizeof(uint32_t)));
+	ESCAPE_ON_FAIL(machine->region_marks = malloc(machine->frame_limit * sizeof(char*)));
 	ESCAPE_ON_FAIL(machine->freed_heap_allocs = malloc((machine->alloc_freed_heaps = 128) * sizeof(heap_alloc_t*)));
 	ESCAPE_ON_FAIL(machine->dynamic_library_table = malloc(sizeof(dynamic_library_table_t)));
 	ESCAPE_ON_FAIL(machine->type_table = calloc(type_count, sizeof(uint16_t)));
 	ESCAPE_ON_FAIL(machine->defined_signatures = malloc((machine->alloced_sig_defs = 16) * sizeof(machine_type_sig_t)));
+	ESCAPE_ON_FAIL(init_typesig_table(machine));
 	ESCAPE_ON_FAIL(machine->reset_stack = malloc((machine->alloced_reset = 128) * sizeof(heap_alloc_t*)));
+	ESCAPE_ON_FAIL(machine->mark_stack = malloc((machine->alloced_marks = 128) * sizeof(heap_alloc_t*)));
+	ESCAPE_ON_FAIL(machine->inc_marked = malloc((machine->alloced_inc_marked = 128) * sizeof(heap_alloc_t*)));
 	ESCAPE_ON_FAIL(init_ffi(&machine->ffi_table));
 	ESCAPE_ON_FAIL(dynamic_library_init(machine->dynamic_library_table));
 	return 1;
 }
 
 void free_machine(machine_t* machine) {
-	for (uint_fast16_t i = 0; i < machine->freed_heap_count; i++)
+	free_reclaimer(machine);
+	for (uint_fast32_t i = 0; i < machine->freed_heap_count; i++)
 		free(machine->freed_heap_allocs[i]);
-	for (uint_fast16_t i = 0; i < machine->defined_sig_count; i++)
-		free_type_signature(&machine->defined_signatures[i]);
+	while (machine->slabs) {
+		void* slab = machine->slabs;
+		machine->slabs = *(void**)slab;
+		free(slab);
+	}
+	free_typesig_table(machine);
 	free(machine->freed_heap_allocs);
 	free_ffi(&machine->ffi_table);
 	dynamic_library_free(machine->dynamic_library_table);
 	free(machine->dynamic_library_table);
-	free(machine->stack);
+	release_stack(machine);
 	free(machine->positions);
 	free(machine->heap_allocs);
 	free(machine->heap_frame_bounds);
 	free(machine->heap_traces);
 	free(machine->trace_frame_bounds);
+	free(machine->region_marks);
 	free(machine->type_table);
 	free(machine->defined_signatures);
 	free(machine->reset_stack);
+	free(machine->mark_stack);
+	free_gc_markers(machine);
+	free(machine->gc_stats);
+	free(machine->inc_marked);
 }
 
 static machine_type_sig_t* new_type_sig(machine_t* machine, int no_realloc) {
@@ -365,37 +894,78 @@ static machine_type_sig_t* new_type_sig(machine_t* machine, int no_realloc) {
 	return &machine->defined_signatures[machine->defined_sig_count++];
 }
 
-static int type_sigs_eq(machine_type_sig_t a, machine_type_sig_t b) {
-	if (a.super_signature != b.super_signature)
-		return 0;
-	ESCAPE_ON_FAIL(a.sub_type_count == b.sub_type_count);
-
-	if (a.super_signature != TYPE_TYPEARG && a.sub_type_count) {
-		for (uint_fast8_t i = 0; i < a.sub_type_count; i++)
-			if (!type_sigs_eq(a.sub_types[i], b.sub_types[i]))
-				return 0;
-	}
-	return 1;
-}
-
-machine_type_sig_t* machine_get_typesig(machine_t* machine, machine_type_sig_t* t, int optimize_common) {
+machine_type_sig_t* machine_get_typesig(machine_t* machine, const machine_type_sig_t* t, int optimize_common) {
+	machine_type_sig_t sig;
+	ESCAPE_ON_FAIL(typesig_intern_tree(machine, t, &sig));
 	if (optimize_common) {
-		for (uint_fast16_t i = 0; i < machine->defined_sig_count; i++)
-			if (type_sigs_eq(machine->defined_signatures[i], *t)) {
-				//free_type_signature(t);
-				return &machine->defined_signatures[i];
-			}
+		machine_type_sig_t* existing = typesig_find_defined(machine, sig);
+		if (existing)
+			return existing;
 	}
 
 	machine_type_sig_t* new_sig = new_type_sig(machine, 0);
 	PANIC_ON_FAIL(new_sig, machine, ERROR_MEMORY);
-	*new_sig = *t;
+	*new_sig = sig;
+	ESCAPE_ON_FAIL(typesig_add_defined(machine, machine->defined_sig_count - 1));
 	return new_sig;
 }
 
 #define MACHINE_PANIC_COND(COND, ERR) {if(!(COND)) { machine->last_err_ip = ip - instructions; PANIC(machine, ERR); }}
 #define MACHINE_ESCAPE_COND(COND) {if(!(COND)) { machine->last_err_ip = ip - instructions; return 0; }}
 #define MACHINE_PANIC(ERR) {machine->last_err_ip = ip - instructions; PANIC(machine, ERR); }
+
+#ifdef CISH_PAUSABLE
+#define MACHINE_HALT_CHECK if (machine->halt_flag) { machine->last_err_ip = ip; machine->halted = 1; return 1; }
+#else
+#define MACHINE_HALT_CHECK
+#endif // CISH_PAUSABLE
+
+#ifdef CISH_COUNT_DISPATCHES
+#define MACHINE_COUNT_DISPATCH machine->dispatch_count++
+#else
+#define MACHINE_COUNT_DISPATCH
+#endif // CISH_COUNT_DISPATCHES
+
+//the threaded engine jumps straight from one handler to the next through a label table; the switch is only entered once. Halts are only checked on control transfers.
+#ifdef CISH_THREADED_DISPATCH
+#define MACHINE_CASE(OPCODE) case MACHINE_OP_CODE_##OPCODE: do_##OPCODE
+#define MACHINE_DISPATCH { MACHINE_COUNT_DISPATCH; goto *dispatch_table[ip->op_code]; }
+#define MACHINE_NEXT { ip++; MACHINE_DISPATCH; }
+#define MACHINE_JUMP { MACHINE_HALT_CHECK; MACHINE_DISPATCH; }
+#else
+#define MACHINE_CASE(OPCODE) case MACHINE_OP_CODE_##OPCODE
+#define MACHINE_NEXT break
+#define MACHINE_JUMP continue
+#endif // CISH_THREADED_DISPATCH
+
+//superinstructions take the slot of the first instruction of their pair, and skip over the second when they fall through
+#define MACHINE_SKIP_FUSED { ip++; MACHINE_NEXT; }
+#define MACHINE_COMPARE_JUMP_CHECK(OPCODE, TYPE, OP) \
+		MACHINE_CASE(OPCODE##_JUMP_CHECK_LL): \
+			if (!(frame[ip->a].TYPE OP frame[ip->b].TYPE)) { ip = &instructions[ip->c]; MACHINE_JUMP; } \
+			MACHINE_SKIP_FUSED; \
+		MACHINE_CASE(OPCODE##_JUMP_CHECK_LG): \
+			if (!(frame[ip->a].TYPE OP stack[ip->b].TYPE)) { ip = &instructions[ip->c]; MACHINE_JUMP; } \
+			MACHINE_SKIP_FUSED; \
+		MACHINE_CASE(OPCODE##_JUMP_CHECK_GL): \
+			if (!(stack[ip->a].TYPE OP frame[ip->b].TYPE)) { ip = &instructions[ip->c]; MACHINE_JUMP; } \
+			MACHINE_SKIP_FUSED; \
+		MACHINE_CASE(OPCODE##_JUMP_CHECK_GG): \
+			if (!(stack[ip->a].TYPE OP stack[ip->b].TYPE)) { ip = &instructions[ip->c]; MACHINE_JUMP; } \
+			MACHINE_SKIP_FUSED;
+#define MACHINE_STEP_COMPARE_JUMP(OPCODE, STEP, OP) \
+		MACHINE_CASE(OPCODE##_LL): \
+			if (STEP frame[ip->a].long_int OP frame[ip->b].long_int) { ip = &instructions[ip->c]; MACHINE_JUMP; } \
+			MACHINE_SKIP_FUSED; \
+		MACHINE_CASE(OPCODE##_LG): \
+			if (STEP frame[ip->a].long_int OP stack[ip->b].long_int) { ip = &instructions[ip->c]; MACHINE_JUMP; } \
+			MACHINE_SKIP_FUSED; \
+		MACHINE_CASE(OPCODE##_GL): \
+			if (STEP stack[ip->a].long_int OP frame[ip->b].long_int) { ip = &instructions[ip->c]; MACHINE_JUMP; } \
+			MACHINE_SKIP_FUSED; \
+		MACHINE_CASE(OPCODE##_GG): \
+			if (STEP stack[ip->a].long_int OP stack[ip->b].long_int) { ip = &instructions[ip->c]; MACHINE_JUMP; } \
+			MACHINE_SKIP_FUSED;
 int machine_execute(machine_t* machine, machine_ins_t* instructions, machine_ins_t* continue_instructions, int first_run) {
 	machine_ins_t* ip = continue_instructions;
 	machine->last_err = ERROR_NONE;
@@ -413,1114 +983,1269 @@ int machine_execute(machine_t* machine, machine_ins_t* instructions, machine_ins
 	machine->halted = 0;
 #endif // CISH_PAUSABLE
 
+	machine_reg_t* stack = machine->stack;
+	machine_reg_t* frame = stack + machine->global_offset;
+
+#ifdef CISH_THREADED_DISPATCH
+#define DECLOP(OPCODE) &&do_##OPCODE,
+	static const void* dispatch_table[] = {
+		MACHINE_OP_CODES(DECLOP)
+	};
+#undef DECLOP
+#endif // CISH_THREADED_DISPATCH
+
 	for (;;) {
-#ifdef CISH_PAUSABLE
-		if (machine->halt_flag) {
-			machine->last_err_ip = ip;
-			machine->halted = 1;
-			return 1;
-		}
-#endif // CISH_PAUSABLE
+		MACHINE_HALT_CHECK;
+		MACHINE_COUNT_DISPATCH;
 		switch (ip->op_code) {
-		case MACHINE_OP_CODE_SET_EXTRA_ARGS:
+		MACHINE_CASE(SET_EXTRA_ARGS):
 			machine->extra_a = ip->a;
 			machine->extra_b = ip->b;
 			machine->extra_c = ip->c;
-			break;
-		case MACHINE_OP_CODE_MOVE_LL:
-			machine->stack[ip->a + machine->global_offset] = machine->stack[ip->b + machine->global_offset];
-			break;
-		case MACHINE_OP_CODE_MOVE_LG:
-			machine->stack[ip->a + machine->global_offset] = machine->stack[ip->b];
-			break;
-		case MACHINE_OP_CODE_MOVE_GL:
-			machine->stack[ip->a] = machine->stack[ip->b + machine->global_offset];
-			break;
-		case MACHINE_OP_CODE_MOVE_GG:
-			machine->stack[ip->a] = machine->stack[ip->b];
-			break;
-		case MACHINE_OP_CODE_SET_L:
+			MACHINE_NEXT;
+		MACHINE_CASE(MOVE_LL):
+			frame[ip->a] = frame[ip->b];
+			MACHINE_NEXT;
+		MACHINE_CASE(MOVE_LG):
+			frame[ip->a] = stack[ip->b];
+			MACHINE_NEXT;
+		MACHINE_CASE(MOVE_GL):
+			stack[ip->a] = frame[ip->b];
+			MACHINE_NEXT;
+		MACHINE_CASE(MOVE_GG):
+			stack[ip->a] = stack[ip->b];
+			MACHINE_NEXT;
+		MACHINE_CASE(SET_L):
 			if (ip->c) {
-				machine->stack[ip->a + machine->global_offset].long_int = machine->defined_sig_count;
+				frame[ip->a].long_int = machine->defined_sig_count;
 				machine_type_sig_t* type_sig = new_type_sig(machine, 1);
 				MACHINE_PANIC_COND(type_sig, ERROR_STACK_OVERFLOW);
 				MACHINE_ESCAPE_COND(atomize_heap_type_sig(machine, machine->defined_signatures[ip->b], type_sig, 1));
 			}
 			else
-				machine->stack[ip->a + machine->global_offset].long_int = ip->b;
-			break;
-		case MACHINE_OP_CODE_POP_ATOM_TYPESIGS: {
+				frame[ip->a].long_int = ip->b;
+			MACHINE_NEXT;
+		MACHINE_CASE(POP_ATOM_TYPESIGS): {
 			if (ip->a > machine->defined_sig_count)
 				MACHINE_PANIC(ERROR_STACK_OVERFLOW);
-			machine_type_sig_t* end = &machine->defined_signatures[machine->defined_sig_count - ip->a];
-			for (machine_type_sig_t* begin = &machine->defined_signatures[machine->defined_sig_count - 1]; begin >= end; --begin)
-				free_type_signature(begin);
-			machine->defined_sig_count -= ip->a;
-			break;
+			machine->defined_sig_count -= ip->a; //atoms are interned, so there's nothing to free
+			MACHINE_NEXT;
 		}
-		case MACHINE_OP_CODE_JUMP:
+		MACHINE_CASE(JUMP):
 			ip = &instructions[ip->a];
-			continue;
-		case MACHINE_OP_CODE_JUMP_CHECK_L:
-			if (!machine->stack[ip->a + machine->global_offset].bool_flag) {
+			MACHINE_JUMP;
+		MACHINE_CASE(JUMP_CHECK_L):
+			if (!frame[ip->a].bool_flag) {
 				ip = &instructions[ip->b];
-				continue;
+				MACHINE_JUMP;
 			}
-			break;
-		case MACHINE_OP_CODE_JUMP_CHECK_G:
-			if (!machine->stack[ip->a].bool_flag) {
+			MACHINE_NEXT;
+		MACHINE_CASE(JUMP_CHECK_G):
+			if (!stack[ip->a].bool_flag) {
 				ip = &instructions[ip->b];
-				continue;
+				MACHINE_JUMP;
 			}
-			break;
-		case MACHINE_OP_CODE_CALL_L: {
-			MACHINE_PANIC_COND(machine->position_count != machine->frame_limit, ERROR_STACK_OVERFLOW);
+			MACHINE_NEXT;
+		MACHINE_CASE(CALL_L):
+			if (machine->position_count == machine->frame_limit)
+				MACHINE_ESCAPE_COND(machine_grow_frames(machine));
 			machine->positions[machine->position_count++] = ip;
-			uint16_t prev_a = ip->a + machine->global_offset;
 			machine->global_offset += ip->b;
-			ip = machine->stack[prev_a].ip;
-			continue;
-		}
-		case MACHINE_OP_CODE_CALL_G:
-			MACHINE_PANIC_COND(machine->position_count != machine->frame_limit, ERROR_STACK_OVERFLOW);
+			ip = frame[ip->a].ip;
+			frame = stack + machine->global_offset;
+			MACHINE_JUMP;
+		MACHINE_CASE(CALL_G):
+			if (machine->position_count == machine->frame_limit)
+				MACHINE_ESCAPE_COND(machine_grow_frames(machine));
 			machine->positions[machine->position_count++] = ip;
-			machine->global_offset += ip->b;
-			ip = machine->stack[ip->a].ip;
-			continue;
-		case MACHINE_OP_CODE_LABEL_L:
-			machine->stack[ip->a + machine->global_offset].ip = &instructions[ip->b];
-			break;
-		case MACHINE_OP_CODE_LABEL_G:
-			machine->stack[ip->a].ip = &instructions[ip->b];
-			break;
-		case MACHINE_OP_CODE_RETURN:
+			frame = stack + (machine->global_offset += ip->b);
+			ip = stack[ip->a].ip;
+			MACHINE_JUMP;
+		MACHINE_CASE(CALL_DIRECT):
+			if (machine->position_count == machine->frame_limit)
+				MACHINE_ESCAPE_COND(machine_grow_frames(machine));
+			machine->positions[machine->position_count++] = ip;
+			frame = stack + (machine->global_offset += ip->b);
+			ip = &instructions[ip->a];
+			MACHINE_JUMP;
+		MACHINE_CASE(TAIL_CALL): //slides the arguments down onto the current frame
+			memmove(&frame[1], &frame[ip->b + 1], ip->c * sizeof(machine_reg_t));
+			ip = &instructions[ip->a];
+			MACHINE_JUMP;
+		MACHINE_CASE(LABEL_L):
+			frame[ip->a].ip = &instructions[ip->b];
+			MACHINE_NEXT;
+		MACHINE_CASE(LABEL_G):
+			stack[ip->a].ip = &instructions[ip->b];
+			MACHINE_NEXT;
+		MACHINE_CASE(RETURN):
 			ip = machine->positions[--machine->position_count];
-			break;
-		case MACHINE_OP_CODE_STACK_VALIDATE:
-			if (machine->global_offset + ip->a >= machine->stack_size)
-				MACHINE_PANIC(ERROR_STACK_OVERFLOW);
-			break;
+			MACHINE_NEXT;
+		MACHINE_CASE(STACK_VALIDATE):
+			if ((uint64_t)machine->global_offset + ip->a >= machine->stack_size)
+				MACHINE_ESCAPE_COND(machine_grow_stack(machine, (uint64_t)machine->global_offset + ip->a + 1));
+			MACHINE_NEXT;
 		{
 			heap_alloc_t* array_register;
 			int64_t index_register;
 			machine_reg_t* dest_reg;
-		case MACHINE_OP_CODE_LOAD_ALLOC_LLL:
-			array_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
-			index_register = machine->stack[ip->b + +machine->global_offset].long_int;
-			dest_reg = &machine->stack[ip->c + machine->global_offset];
+		MACHINE_CASE(LOAD_ALLOC_LLL):
+			array_register = frame[ip->a].heap_alloc;
+			index_register = frame[ip->b].long_int;
+			dest_reg = &frame[ip->c];
 			goto load_alloc_bounds;
-		case MACHINE_OP_CODE_LOAD_ALLOC_LLG:
-			array_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
-			index_register = machine->stack[ip->b + +machine->global_offset].long_int;
-			dest_reg = &machine->stack[ip->c];
+		MACHINE_CASE(LOAD_ALLOC_LLG):
+			array_register = frame[ip->a].heap_alloc;
+			index_register = frame[ip->b].long_int;
+			dest_reg = &stack[ip->c];
 			goto load_alloc_bounds;
-		case MACHINE_OP_CODE_LOAD_ALLOC_LGL:
-			array_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
-			index_register = machine->stack[ip->b].long_int;
-			dest_reg = &machine->stack[ip->c + machine->global_offset];
+		MACHINE_CASE(LOAD_ALLOC_LGL):
+			array_register = frame[ip->a].heap_alloc;
+			index_register = stack[ip->b].long_int;
+			dest_reg = &frame[ip->c];
 			goto load_alloc_bounds;
-		case MACHINE_OP_CODE_LOAD_ALLOC_LGG:
-			array_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
-			index_register = machine->stack[ip->b].long_int;
-			dest_reg = &machine->stack[ip->c];
+		MACHINE_CASE(LOAD_ALLOC_LGG):
+			array_register = frame[ip->a].heap_alloc;
+			index_register = stack[ip->b].long_int;
+			dest_reg = &stack[ip->c];
 			goto load_alloc_bounds;
-		case MACHINE_OP_CODE_LOAD_ALLOC_GLL:
-			array_register = machine->stack[ip->a].heap_alloc;
-			index_register = machine->stack[ip->b + +machine->global_offset].long_int;
-			dest_reg = &machine->stack[ip->c + machine->global_offset];
+		MACHINE_CASE(LOAD_ALLOC_GLL):
+			array_register = stack[ip->a].heap_alloc;
+			index_register = frame[ip->b].long_int;
+			dest_reg = &frame[ip->c];
 			goto load_alloc_bounds;
-		case MACHINE_OP_CODE_LOAD_ALLOC_GLG:
-			array_register = machine->stack[ip->a].heap_alloc;
-			index_register = machine->stack[ip->b + +machine->global_offset].long_int;
-			dest_reg = &machine->stack[ip->c];
+		MACHINE_CASE(LOAD_ALLOC_GLG):
+			array_register = stack[ip->a].heap_alloc;
+			index_register = frame[ip->b].long_int;
+			dest_reg = &stack[ip->c];
 			goto load_alloc_bounds;
-		case MACHINE_OP_CODE_LOAD_ALLOC_GGL:
-			array_register = machine->stack[ip->a].heap_alloc;
-			index_register = machine->stack[ip->b].long_int;
-			dest_reg = &machine->stack[ip->c + machine->global_offset];
+		MACHINE_CASE(LOAD_ALLOC_GGL):
+			array_register = stack[ip->a].heap_alloc;
+			index_register = stack[ip->b].long_int;
+			dest_reg = &frame[ip->c];
 			goto load_alloc_bounds;
-		case MACHINE_OP_CODE_LOAD_ALLOC_GGG:
-			array_register = machine->stack[ip->a].heap_alloc;
-			index_register = machine->stack[ip->b].long_int;
-			dest_reg = &machine->stack[ip->c];
+		MACHINE_CASE(LOAD_ALLOC_GGG):
+			array_register = stack[ip->a].heap_alloc;
+			index_register = stack[ip->b].long_int;
+			dest_reg = &stack[ip->c];
 			goto load_alloc_bounds;
-		case MACHINE_OP_CODE_LOAD_ALLOC_I_LL:
-			array_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
+		MACHINE_CASE(LOAD_ALLOC_I_LL):
+			array_register = frame[ip->a].heap_alloc;
 			index_register = ip->c;
-			dest_reg = &machine->stack[ip->b + machine->global_offset];
+			dest_reg = &frame[ip->b];
 			goto load_alloc_unbounded;
-		case MACHINE_OP_CODE_LOAD_ALLOC_I_LG:
-			array_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
+		MACHINE_CASE(LOAD_ALLOC_I_LG):
+			array_register = frame[ip->a].heap_alloc;
 			index_register = ip->c;
-			dest_reg = &machine->stack[ip->b];
+			dest_reg = &stack[ip->b];
 			goto load_alloc_unbounded;
-		case MACHINE_OP_CODE_LOAD_ALLOC_I_GL:
-			array_register = machine->stack[ip->a].heap_alloc;
+		MACHINE_CASE(LOAD_ALLOC_I_GL):
+			array_register = stack[ip->a].heap_alloc;
 			index_register = ip->c;
-			dest_reg = &machine->stack[ip->b + machine->global_offset];
+			dest_reg = &frame[ip->b];
 			goto load_alloc_unbounded;
-		case MACHINE_OP_CODE_LOAD_ALLOC_I_GG:
-			array_register = machine->stack[ip->a].heap_alloc;
+		MACHINE_CASE(LOAD_ALLOC_I_GG):
+			array_register = stack[ip->a].heap_alloc;
 			index_register = ip->c;
-			dest_reg = &machine->stack[ip->b];
+			dest_reg = &stack[ip->b];
 			goto load_alloc_unbounded;
-		case MACHINE_OP_CODE_LOAD_ALLOC_I_BOUND_LL:
-			array_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
+		MACHINE_CASE(LOAD_ALLOC_I_BOUND_LL):
+			array_register = frame[ip->a].heap_alloc;
 			index_register = ip->c;
-			dest_reg = &machine->stack[ip->b + machine->global_offset];
+			dest_reg = &frame[ip->b];
 			goto load_alloc_bounds;
-		case MACHINE_OP_CODE_LOAD_ALLOC_I_BOUND_LG:
-			array_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
+		MACHINE_CASE(LOAD_ALLOC_I_BOUND_LG):
+			array_register = frame[ip->a].heap_alloc;
 			index_register = ip->c;
-			dest_reg = &machine->stack[ip->b];
+			dest_reg = &stack[ip->b];
 			goto load_alloc_bounds;
-		case MACHINE_OP_CODE_LOAD_ALLOC_I_BOUND_GL:
-			array_register = machine->stack[ip->a].heap_alloc;
+		MACHINE_CASE(LOAD_ALLOC_I_BOUND_GL):
+			array_register = stack[ip->a].heap_alloc;
 			index_register = ip->c;
-			dest_reg = &machine->stack[ip->b + machine->global_offset];
+			dest_reg = &frame[ip->b];
 			goto load_alloc_bounds;
-		case MACHINE_OP_CODE_LOAD_ALLOC_I_BOUND_GG:
-			array_register = machine->stack[ip->a].heap_alloc;
+		MACHINE_CASE(LOAD_ALLOC_I_BOUND_GG):
+			array_register = stack[ip->a].heap_alloc;
 			index_register = ip->c;
-			dest_reg = &machine->stack[ip->b];
+			dest_reg = &stack[ip->b];
 			goto load_alloc_bounds;
+		MACHINE_CASE(LOAD_ALLOC_UNCHECKED_LLL):
+			array_register = frame[ip->a].heap_alloc;
+			index_register = frame[ip->b].long_int;
+			dest_reg = &frame[ip->c];
+			goto load_alloc_unbounded;
+		MACHINE_CASE(LOAD_ALLOC_UNCHECKED_LLG):
+			array_register = frame[ip->a].heap_alloc;
+			index_register = frame[ip->b].long_int;
+			dest_reg = &stack[ip->c];
+			goto load_alloc_unbounded;
+		MACHINE_CASE(LOAD_ALLOC_UNCHECKED_LGL):
+			array_register = frame[ip->a].heap_alloc;
+			index_register = stack[ip->b].long_int;
+			dest_reg = &frame[ip->c];
+			goto load_alloc_unbounded;
+		MACHINE_CASE(LOAD_ALLOC_UNCHECKED_LGG):
+			array_register = frame[ip->a].heap_alloc;
+			index_register = stack[ip->b].long_int;
+			dest_reg = &stack[ip->c];
+			goto load_alloc_unbounded;
+		MACHINE_CASE(LOAD_ALLOC_UNCHECKED_GLL):
+			array_register = stack[ip->a].heap_alloc;
+			index_register = frame[ip->b].long_int;
+			dest_reg = &frame[ip->c];
+			goto load_alloc_unbounded;
+		MACHINE_CASE(LOAD_ALLOC_UNCHECKED_GLG):
+			array_register = stack[ip->a].heap_alloc;
+			index_register = frame[ip->b].long_int;
+			dest_reg = &stack[ip->c];
+			goto load_alloc_unbounded;
+		MACHINE_CASE(LOAD_ALLOC_UNCHECKED_GGL):
+			array_register = stack[ip->a].heap_alloc;
+			index_register = stack[ip->b].long_int;
+			dest_reg = &frame[ip->c];
+			goto load_alloc_unbounded;
+		MACHINE_CASE(LOAD_ALLOC_UNCHECKED_GGG):
+			array_register = stack[ip->a].heap_alloc;
+			index_register = stack[ip->b].long_int;
+			dest_reg = &stack[ip->c];
+			goto load_alloc_unbounded;
 		load_alloc_bounds:
 			if (index_register < 0 || index_register >= array_register->limit)
 				MACHINE_PANIC(ERROR_INDEX_OUT_OF_RANGE);
 		load_alloc_unbounded:
-			if (!array_register->init_stat[index_register])
+			if (!HEAP_BIT(array_register->init_stat, index_register))
 				MACHINE_PANIC(ERROR_READ_UNINIT);
 			*dest_reg = array_register->registers[index_register];
-			break;
+			MACHINE_NEXT;
 		}
 		{
 			heap_alloc_t* array_register;
 			int64_t index_register;
 			machine_reg_t store_reg;
-		case MACHINE_OP_CODE_STORE_ALLOC_LLL:
-			array_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
-			index_register = machine->stack[ip->b + machine->global_offset].long_int;
-			store_reg = machine->stack[ip->c + machine->global_offset];
+		MACHINE_CASE(STORE_ALLOC_LLL):
+			array_register = frame[ip->a].heap_alloc;
+			index_register = frame[ip->b].long_int;
+			store_reg = frame[ip->c];
 			goto store_alloc_bounds;
-		case MACHINE_OP_CODE_STORE_ALLOC_LLG:
-			array_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
-			index_register = machine->stack[ip->b + machine->global_offset].long_int;
-			store_reg = machine->stack[ip->c];
+		MACHINE_CASE(STORE_ALLOC_LLG):
+			array_register = frame[ip->a].heap_alloc;
+			index_register = frame[ip->b].long_int;
+			store_reg = stack[ip->c];
 			goto store_alloc_bounds;
-		case MACHINE_OP_CODE_STORE_ALLOC_LGL:
-			array_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
-			index_register = machine->stack[ip->b].long_int;
-			store_reg = machine->stack[ip->c + machine->global_offset];
+		MACHINE_CASE(STORE_ALLOC_LGL):
+			array_register = frame[ip->a].heap_alloc;
+			index_register = stack[ip->b].long_int;
+			store_reg = frame[ip->c];
 			goto store_alloc_bounds;
-		case MACHINE_OP_CODE_STORE_ALLOC_LGG:
-			array_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
-			index_register = machine->stack[ip->b].long_int;
-			store_reg = machine->stack[ip->c];
+		MACHINE_CASE(STORE_ALLOC_LGG):
+			array_register = frame[ip->a].heap_alloc;
+			index_register = stack[ip->b].long_int;
+			store_reg = stack[ip->c];
 			goto store_alloc_bounds;
-		case MACHINE_OP_CODE_STORE_ALLOC_GLL:
-			array_register = machine->stack[ip->a].heap_alloc;
-			index_register = machine->stack[ip->b + machine->global_offset].long_int;
-			store_reg = machine->stack[ip->c + machine->global_offset];
+		MACHINE_CASE(STORE_ALLOC_GLL):
+			array_register = stack[ip->a].heap_alloc;
+			index_register = frame[ip->b].long_int;
+			store_reg = frame[ip->c];
 			goto store_alloc_bounds;
-		case MACHINE_OP_CODE_STORE_ALLOC_GLG:
-			array_register = machine->stack[ip->a].heap_alloc;
-			index_register = machine->stack[ip->b + machine->global_offset].long_int;
-			store_reg = machine->stack[ip->c];
+		MACHINE_CASE(STORE_ALLOC_GLG):
+			array_register = stack[ip->a].heap_alloc;
+			index_register = frame[ip->b].long_int;
+			store_reg = stack[ip->c];
 			goto store_alloc_bounds;
-		case MACHINE_OP_CODE_STORE_ALLOC_GGL:
-			array_register = machine->stack[ip->a].heap_alloc;
-			index_register = machine->stack[ip->b].long_int;
-			store_reg = machine->stack[ip->c + machine->global_offset];
+		MACHINE_CASE(STORE_ALLOC_GGL):
+			array_register = stack[ip->a].heap_alloc;
+			index_register = stack[ip->b].long_int;
+			store_reg = frame[ip->c];
 			goto store_alloc_bounds;
-		case MACHINE_OP_CODE_STORE_ALLOC_GGG:
-			array_register = machine->stack[ip->a].heap_alloc;
-			index_register = machine->stack[ip->b].long_int;
-			store_reg = machine->stack[ip->c + machine->global_offset];
+		MACHINE_CASE(STORE_ALLOC_GGG):
+			array_register = stack[ip->a].heap_alloc;
+			index_register = stack[ip->b].long_int;
+			store_reg = stack[ip->c];
 			goto store_alloc_bounds;
-		case MACHINE_OP_CODE_STORE_ALLOC_I_LL:
-			array_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
+		MACHINE_CASE(STORE_ALLOC_I_LL):
+			array_register = frame[ip->a].heap_alloc;
 			index_register = ip->c;
-			store_reg = machine->stack[ip->b + machine->global_offset];
+			store_reg = frame[ip->b];
 			goto store_alloc_unbounded;
-		case MACHINE_OP_CODE_STORE_ALLOC_I_LG:
-			array_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
+		MACHINE_CASE(STORE_ALLOC_I_LG):
+			array_register = frame[ip->a].heap_alloc;
 			index_register = ip->c;
-			store_reg = machine->stack[ip->b];
+			store_reg = stack[ip->b];
 			goto store_alloc_unbounded;
-		case MACHINE_OP_CODE_STORE_ALLOC_I_GL:
-			array_register = machine->stack[ip->a].heap_alloc;
+		MACHINE_CASE(STORE_ALLOC_I_GL):
+			array_register = stack[ip->a].heap_alloc;
 			index_register = ip->c;
-			store_reg = machine->stack[ip->b + machine->global_offset];
+			store_reg = frame[ip->b];
 			goto store_alloc_unbounded;
-		case MACHINE_OP_CODE_STORE_ALLOC_I_GG:
-			array_register = machine->stack[ip->a].heap_alloc;
+		MACHINE_CASE(STORE_ALLOC_I_GG):
+			array_register = stack[ip->a].heap_alloc;
 			index_register = ip->c;
-			store_reg = machine->stack[ip->b];
+			store_reg = stack[ip->b];
 			goto store_alloc_unbounded;
-		case MACHINE_OP_CODE_STORE_ALLOC_I_BOUND_LL:
-			array_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
+		MACHINE_CASE(STORE_ALLOC_I_BOUND_LL):
+			array_register = frame[ip->a].heap_alloc;
 			index_register = ip->c;
-			store_reg = machine->stack[ip->b + machine->global_offset];
+			store_reg = frame[ip->b];
 			goto store_alloc_bounds;
-		case MACHINE_OP_CODE_STORE_ALLOC_I_BOUND_LG:
-			array_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
+		MACHINE_CASE(STORE_ALLOC_I_BOUND_LG):
+			array_register = frame[ip->a].heap_alloc;
 			index_register = ip->c;
-			store_reg = machine->stack[ip->b];
+			store_reg = stack[ip->b];
 			goto store_alloc_bounds;
-		case MACHINE_OP_CODE_STORE_ALLOC_I_BOUND_GL:
-			array_register = machine->stack[ip->a].heap_alloc;
+		MACHINE_CASE(STORE_ALLOC_I_BOUND_GL):
+			array_register = stack[ip->a].heap_alloc;
 			index_register = ip->c;
-			store_reg = machine->stack[ip->b + machine->global_offset];
+			store_reg = frame[ip->b];
 			goto store_alloc_bounds;
-		case MACHINE_OP_CODE_STORE_ALLOC_I_BOUND_GG:
-			array_register = machine->stack[ip->a].heap_alloc;
+		MACHINE_CASE(STORE_ALLOC_I_BOUND_GG):
+			array_register = stack[ip->a].heap_alloc;
 			index_register = ip->c;
-			store_reg = machine->stack[ip->b];
+			store_reg = stack[ip->b];
 			goto store_alloc_bounds;
+		MACHINE_CASE(STORE_ALLOC_UNCHECKED_LLL):
+			array_register = frame[ip->a].heap_alloc;
+			index_register = frame[ip->b].long_int;
+			store_reg = frame[ip->c];
+			goto store_alloc_unbounded;
+		MACHINE_CASE(STORE_ALLOC_UNCHECKED_LLG):
+			array_register = frame[ip->a].heap_alloc;
+			index_register = frame[ip->b].long_int;
+			store_reg = stack[ip->c];
+			goto store_alloc_unbounded;
+		MACHINE_CASE(STORE_ALLOC_UNCHECKED_LGL):
+			array_register = frame[ip->a].heap_alloc;
+			index_register = stack[ip->b].long_int;
+			store_reg = frame[ip->c];
+			goto store_alloc_unbounded;
+		MACHINE_CASE(STORE_ALLOC_UNCHECKED_LGG):
+			array_register = frame[ip->a].heap_alloc;
+			index_register = stack[ip->b].long_int;
+			store_reg = stack[ip->c];
+			goto store_alloc_unbounded;
+		MACHINE_CASE(STORE_ALLOC_UNCHECKED_GLL):
+			array_register = stack[ip->a].heap_alloc;
+			index_register = frame[ip->b].long_int;
+			store_reg = frame[ip->c];
+			goto store_alloc_unbounded;
+		MACHINE_CASE(STORE_ALLOC_UNCHECKED_GLG):
+			array_register = stack[ip->a].heap_alloc;
+			index_register = frame[ip->b].long_int;
+			store_reg = stack[ip->c];
+			goto store_alloc_unbounded;
+		MACHINE_CASE(STORE_ALLOC_UNCHECKED_GGL):
+			array_register = stack[ip->a].heap_alloc;
+			index_register = stack[ip->b].long_int;
+			store_reg = frame[ip->c];
+			goto store_alloc_unbounded;
+		MACHINE_CASE(STORE_ALLOC_UNCHECKED_GGG):
+			array_register = stack[ip->a].heap_alloc;
+			index_register = stack[ip->b].long_int;
+			store_reg = stack[ip->c];
+			goto store_alloc_unbounded;
 		store_alloc_bounds:
 			if (index_register < 0 || index_register >= array_register->limit)
 				MACHINE_PANIC(ERROR_INDEX_OUT_OF_RANGE);
 		store_alloc_unbounded:
+			if (machine->gc_phase == GC_PHASE_MARK)
+				MACHINE_ESCAPE_COND(machine_gc_barrier(machine, array_register, index_register));
 			array_register->registers[index_register] = store_reg;
-			array_register->init_stat[index_register] = 1;
-			break;
+			HEAP_SET_BIT(array_register->init_stat, index_register);
+			MACHINE_NEXT;
 		}
-		case MACHINE_OP_CODE_DYNAMIC_CONF_LL:
-			machine->stack[ip->a + machine->global_offset].heap_alloc->trace_stat[ip->b] = machine->defined_signatures[machine->stack[ip->c + machine->global_offset].long_int].super_signature >= TYPE_SUPER_ARRAY;
-			break;
-		case MACHINE_OP_CODE_DYNAMIC_CONF_ALL_LL:
-			machine->stack[ip->a + machine->global_offset].heap_alloc->trace_mode = machine->defined_signatures[machine->stack[ip->b + machine->global_offset].long_int].super_signature >= TYPE_SUPER_ARRAY;
-			break;
-		case MACHINE_OP_CODE_CONF_TRACE_L:
-			machine->stack[ip->a + machine->global_offset].heap_alloc->trace_stat[ip->b] = ip->c;
-			break;
-		case MACHINE_OP_CODE_CONF_TRACE_G:
-			machine->stack[ip->a].heap_alloc->trace_stat[ip->b] = ip->c;
-			break;
-		case MACHINE_OP_CODE_STACK_OFFSET:
-			machine->global_offset += ip->a;
-			break;
-		case MACHINE_OP_CODE_STACK_DEOFFSET:
-			machine->global_offset -= ip->a;
-			break;
-		case MACHINE_OP_CODE_ALLOC_LL:
-			MACHINE_ESCAPE_COND(machine->stack[ip->a + machine->global_offset].heap_alloc = machine_alloc(machine, machine->stack[ip->b + machine->global_offset].long_int, ip->c));
-			break;
-		case MACHINE_OP_CODE_ALLOC_LG:
-			MACHINE_ESCAPE_COND(machine->stack[ip->a + machine->global_offset].heap_alloc = machine_alloc(machine, machine->stack[ip->b].long_int, ip->c));
-			break;
-		case MACHINE_OP_CODE_ALLOC_GL:
-			MACHINE_ESCAPE_COND(machine->stack[ip->a].heap_alloc = machine_alloc(machine, machine->stack[ip->b + machine->global_offset].long_int, ip->c));
-			break;
-		case MACHINE_OP_CODE_ALLOC_GG:
-			MACHINE_ESCAPE_COND(machine->stack[ip->a].heap_alloc = machine_alloc(machine, machine->stack[ip->b].long_int, ip->c));
-			break;
-		case MACHINE_OP_CODE_ALLOC_I_L:
-			MACHINE_ESCAPE_COND(machine->stack[ip->a + machine->global_offset].heap_alloc = machine_alloc(machine, ip->b, ip->c));
-			break;
-		case MACHINE_OP_CODE_ALLOC_I_G:
-			MACHINE_ESCAPE_COND(machine->stack[ip->a].heap_alloc = machine_alloc(machine, ip->b, ip->c));
-			break;
-		case MACHINE_OP_CODE_DYNAMIC_FREE_LL:
-			if (!(machine->defined_signatures[machine->stack[ip->b + machine->global_offset].long_int].super_signature >= TYPE_SUPER_ARRAY))
-				break;
-		case MACHINE_OP_CODE_FREE_L: {
-			MACHINE_ESCAPE_COND(free_alloc(machine, machine->stack[ip->a + machine->global_offset].heap_alloc));
-			break; 
+		MACHINE_CASE(LOAD_ALLOC_I_INIT_LL):
+			frame[ip->b] = frame[ip->a].heap_alloc->registers[ip->c];
+			MACHINE_NEXT;
+		MACHINE_CASE(LOAD_ALLOC_I_INIT_LG):
+			stack[ip->b] = frame[ip->a].heap_alloc->registers[ip->c];
+			MACHINE_NEXT;
+		MACHINE_CASE(LOAD_ALLOC_I_INIT_GL):
+			frame[ip->b] = stack[ip->a].heap_alloc->registers[ip->c];
+			MACHINE_NEXT;
+		MACHINE_CASE(LOAD_ALLOC_I_INIT_GG):
+			stack[ip->b] = stack[ip->a].heap_alloc->registers[ip->c];
+			MACHINE_NEXT;
+		{
+			heap_alloc_t* heap_alloc;
+			machine_reg_t store_reg;
+		MACHINE_CASE(STORE_ALLOC_I_INIT_LL):
+			heap_alloc = frame[ip->a].heap_alloc;
+			store_reg = frame[ip->b];
+			goto store_alloc_init;
+		MACHINE_CASE(STORE_ALLOC_I_INIT_LG):
+			heap_alloc = frame[ip->a].heap_alloc;
+			store_reg = stack[ip->b];
+			goto store_alloc_init;
+		MACHINE_CASE(STORE_ALLOC_I_INIT_GL):
+			heap_alloc = stack[ip->a].heap_alloc;
+			store_reg = frame[ip->b];
+			goto store_alloc_init;
+		MACHINE_CASE(STORE_ALLOC_I_INIT_GG):
+			heap_alloc = stack[ip->a].heap_alloc;
+			store_reg = stack[ip->b];
+		store_alloc_init:
+			if (machine->gc_phase == GC_PHASE_MARK)
+				MACHINE_ESCAPE_COND(machine_gc_barrier(machine, heap_alloc, ip->c));
+			heap_alloc->registers[ip->c] = store_reg;
+			MACHINE_NEXT;
 		}
-		case MACHINE_OP_CODE_FREE_G:
-			MACHINE_ESCAPE_COND(free_alloc(machine, machine->stack[ip->a].heap_alloc));
-			break;
-		case MACHINE_OP_CODE_GC_NEW_FRAME:
+		{
+			heap_alloc_t* heap_alloc;
+		MACHINE_CASE(CONF_INIT_ALL_L):
+			heap_alloc = frame[ip->a].heap_alloc;
+			goto conf_init_all;
+		MACHINE_CASE(CONF_INIT_ALL_G):
+			heap_alloc = stack[ip->a].heap_alloc;
+		conf_init_all:
+			memset(heap_alloc->init_stat, 0xFF, (ip->b / 64) * sizeof(uint64_t));
+			if (ip->b % 64)
+				heap_alloc->init_stat[ip->b / 64] |= (UINT64_C(1) << (ip->b % 64)) - 1;
+			MACHINE_NEXT;
+		}
+		MACHINE_CASE(DYNAMIC_CONF_LL):
+			HEAP_ASSIGN_BIT(HEAP_TRACE_STAT(frame[ip->a].heap_alloc), ip->b, machine->defined_signatures[frame[ip->c].long_int].super_signature >= TYPE_SUPER_ARRAY);
+			MACHINE_NEXT;
+		MACHINE_CASE(DYNAMIC_CONF_ALL_LL):
+			frame[ip->a].heap_alloc->trace_mode = machine->defined_signatures[frame[ip->b].long_int].super_signature >= TYPE_SUPER_ARRAY;
+			MACHINE_NEXT;
+		MACHINE_CASE(CONF_TRACE_L):
+			HEAP_ASSIGN_BIT(HEAP_TRACE_STAT(frame[ip->a].heap_alloc), ip->b, ip->c);
+			MACHINE_NEXT;
+		MACHINE_CASE(CONF_TRACE_G):
+			HEAP_ASSIGN_BIT(HEAP_TRACE_STAT(stack[ip->a].heap_alloc), ip->b, ip->c);
+			MACHINE_NEXT;
+		MACHINE_CASE(STACK_OFFSET):
+			frame = stack + (machine->global_offset += ip->a);
+			MACHINE_NEXT;
+		MACHINE_CASE(STACK_DEOFFSET):
+			frame = stack + (machine->global_offset -= ip->a);
+			MACHINE_NEXT;
+		MACHINE_CASE(ALLOC_LL):
+			MACHINE_ESCAPE_COND(frame[ip->a].heap_alloc = machine_alloc(machine, frame[ip->b].long_int, ip->c));
+			MACHINE_NEXT;
+		MACHINE_CASE(ALLOC_LG):
+			MACHINE_ESCAPE_COND(frame[ip->a].heap_alloc = machine_alloc(machine, stack[ip->b].long_int, ip->c));
+			MACHINE_NEXT;
+		MACHINE_CASE(ALLOC_GL):
+			MACHINE_ESCAPE_COND(stack[ip->a].heap_alloc = machine_alloc(machine, frame[ip->b].long_int, ip->c));
+			MACHINE_NEXT;
+		MACHINE_CASE(ALLOC_GG):
+			MACHINE_ESCAPE_COND(stack[ip->a].heap_alloc = machine_alloc(machine, stack[ip->b].long_int, ip->c));
+			MACHINE_NEXT;
+		MACHINE_CASE(ALLOC_I_L):
+			MACHINE_ESCAPE_COND(frame[ip->a].heap_alloc = machine_alloc(machine, ip->b, ip->c));
+			MACHINE_NEXT;
+		MACHINE_CASE(ALLOC_I_G):
+			MACHINE_ESCAPE_COND(stack[ip->a].heap_alloc = machine_alloc(machine, ip->b, ip->c));
+			MACHINE_NEXT;
+		MACHINE_CASE(ALLOC_I_INIT_L):
+			MACHINE_ESCAPE_COND(frame[ip->a].heap_alloc = machine_alloc_initialized(machine, ip->b, ip->c));
+			MACHINE_NEXT;
+		MACHINE_CASE(ALLOC_I_INIT_G):
+			MACHINE_ESCAPE_COND(stack[ip->a].heap_alloc = machine_alloc_initialized(machine, ip->b, ip->c));
+			MACHINE_NEXT;
+		MACHINE_CASE(DYNAMIC_FREE_LL):
+			if (!(machine->defined_signatures[frame[ip->b].long_int].super_signature >= TYPE_SUPER_ARRAY))
+				MACHINE_NEXT;
+		MACHINE_CASE(FREE_L): {
+			MACHINE_ESCAPE_COND(free_alloc(machine, frame[ip->a].heap_alloc));
+			MACHINE_NEXT; 
+		}
+		MACHINE_CASE(FREE_G):
+			MACHINE_ESCAPE_COND(free_alloc(machine, stack[ip->a].heap_alloc));
+			MACHINE_NEXT;
+		MACHINE_CASE(GC_NEW_FRAME):
 			if (machine->heap_frame == machine->frame_limit)
-				MACHINE_PANIC(ERROR_STACK_OVERFLOW);
+				MACHINE_ESCAPE_COND(machine_grow_frames(machine));
 			machine->heap_frame_bounds[machine->heap_frame] = machine->heap_count;
 			machine->trace_frame_bounds[machine->heap_frame] = machine->trace_count;
+			machine->region_marks[machine->heap_frame] = machine->slab_top;
 			machine->heap_frame++;
-			break; 
+			MACHINE_NEXT; 
 		{
 			int super_traced;
 			heap_alloc_t* heap_alloc;
-		case MACHINE_OP_CODE_DYNAMIC_TRACE_LL:
-			if (!(machine->defined_signatures[machine->stack[ip->b + machine->global_offset].long_int].super_signature >= TYPE_SUPER_ARRAY))
-				break;
+		MACHINE_CASE(DYNAMIC_TRACE_LL):
+			if (!(machine->defined_signatures[frame[ip->b].long_int].super_signature >= TYPE_SUPER_ARRAY))
+				MACHINE_NEXT;
 			super_traced = 0;
-			heap_alloc = machine->stack[ip->a + machine->global_offset].heap_alloc;
+			heap_alloc = frame[ip->a].heap_alloc;
 			goto do_trace;
-		case MACHINE_OP_CODE_GC_TRACE_L:
-			heap_alloc = machine->stack[ip->a + machine->global_offset].heap_alloc;
+		MACHINE_CASE(GC_TRACE_L):
+			heap_alloc = frame[ip->a].heap_alloc;
 			super_traced = ip->b;
 			goto do_trace;
-		case MACHINE_OP_CODE_GC_TRACE_G:
-			heap_alloc = machine->stack[ip->a].heap_alloc;
+		MACHINE_CASE(GC_TRACE_G):
+			heap_alloc = stack[ip->a].heap_alloc;
 			super_traced = ip->b;
 		do_trace:
 			if (machine->trace_count == machine->alloced_trace_allocs) {
-				heap_alloc_t** new_trace_stack = realloc(machine->heap_traces, (machine->alloced_trace_allocs += 10) * sizeof(heap_alloc_t*));
+				heap_alloc_t** new_trace_stack = realloc(machine->heap_traces, (machine->alloced_trace_allocs *= 2) * sizeof(heap_alloc_t*));
 				MACHINE_PANIC_COND(new_trace_stack, ERROR_MEMORY);
 				machine->heap_traces = new_trace_stack;
 			}
-			if (heap_alloc->gc_flag)
-				machine_heap_detrace(machine, heap_alloc);
-			(machine->heap_traces[machine->trace_count++] = heap_alloc)->gc_flag = super_traced;
-			break;
+			if (heap_alloc->flags & HEAP_ALLOC_GC_FLAG)
+				MACHINE_ESCAPE_COND(machine_heap_detrace(machine, heap_alloc));
+			machine->heap_traces[machine->trace_count++] = heap_alloc;
+			if (super_traced)
+				heap_alloc->flags |= HEAP_ALLOC_GC_FLAG;
+			MACHINE_NEXT;
 		}
-		case MACHINE_OP_CODE_GC_CLEAN:
-			machine_gc_clean(machine);
-			break;
-		case MACHINE_OP_CODE_AND_LLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].bool_flag && machine->stack[ip->b + machine->global_offset].bool_flag;
-			break;
-		case MACHINE_OP_CODE_AND_LLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].bool_flag && machine->stack[ip->b + machine->global_offset].bool_flag;
-			break;
-		case MACHINE_OP_CODE_AND_LGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].bool_flag && machine->stack[ip->b].bool_flag;
-			break;
-		case MACHINE_OP_CODE_AND_LGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].bool_flag && machine->stack[ip->b].bool_flag;
-			break;
-		case MACHINE_OP_CODE_AND_GLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].bool_flag && machine->stack[ip->b + machine->global_offset].bool_flag;
-			break;
-		case MACHINE_OP_CODE_AND_GLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].bool_flag && machine->stack[ip->b + machine->global_offset].bool_flag;
-			break;
-		case MACHINE_OP_CODE_AND_GGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].bool_flag && machine->stack[ip->b].bool_flag;
-			break;
-		case MACHINE_OP_CODE_AND_GGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].bool_flag && machine->stack[ip->b].bool_flag;
-			break;
-		case MACHINE_OP_CODE_OR_LLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].bool_flag || machine->stack[ip->b + machine->global_offset].bool_flag;
-			break;
-		case MACHINE_OP_CODE_OR_LLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].bool_flag || machine->stack[ip->b + machine->global_offset].bool_flag;
-			break;
-		case MACHINE_OP_CODE_OR_LGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].bool_flag || machine->stack[ip->b].bool_flag;
-			break;
-		case MACHINE_OP_CODE_OR_LGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].bool_flag || machine->stack[ip->b].bool_flag;
-			break;
-		case MACHINE_OP_CODE_OR_GLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].bool_flag || machine->stack[ip->b + machine->global_offset].bool_flag;
-			break;
-		case MACHINE_OP_CODE_OR_GLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].bool_flag || machine->stack[ip->b + machine->global_offset].bool_flag;
-			break;
-		case MACHINE_OP_CODE_OR_GGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].bool_flag || machine->stack[ip->b].bool_flag;
-			break;
-		case MACHINE_OP_CODE_OR_GGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].bool_flag || machine->stack[ip->b].bool_flag;
-			break;
-		case MACHINE_OP_CODE_NOT_LL:
-			machine->stack[ip->a + machine->global_offset].bool_flag = !machine->stack[ip->b + machine->global_offset].bool_flag;
-			break;
-		case MACHINE_OP_CODE_NOT_LG:
-			machine->stack[ip->a + machine->global_offset].bool_flag = !machine->stack[ip->b].bool_flag;
-			break;
-		case MACHINE_OP_CODE_NOT_GL:
-			machine->stack[ip->a].bool_flag = !machine->stack[ip->b + machine->global_offset].bool_flag;
-			break;
-		case MACHINE_OP_CODE_NOT_GG:
-			machine->stack[ip->a].bool_flag = !machine->stack[ip->b].bool_flag;
-			break;
-		case MACHINE_OP_CODE_LENGTH_LL:
-			machine->stack[ip->a + machine->global_offset].long_int = machine->stack[ip->b + machine->global_offset].heap_alloc->limit;
-			break;
-		case MACHINE_OP_CODE_LENGTH_LG:
-			machine->stack[ip->a + machine->global_offset].long_int= machine->stack[ip->b].heap_alloc->limit;
-			break;
-		case MACHINE_OP_CODE_LENGTH_GL:
-			machine->stack[ip->a].long_int= machine->stack[ip->b + machine->global_offset].heap_alloc->limit;
-			break;
-		case MACHINE_OP_CODE_LENGTH_GG:
-			machine->stack[ip->a].long_int= machine->stack[ip->b].heap_alloc->limit;
-			break;
-		case MACHINE_OP_CODE_PTR_EQUAL_LLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].ip == machine->stack[ip->b + machine->global_offset].ip; 
-			break;
-		case MACHINE_OP_CODE_PTR_EQUAL_LLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].ip == machine->stack[ip->b + machine->global_offset].ip; 
-			break;
-		case MACHINE_OP_CODE_PTR_EQUAL_LGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].ip == machine->stack[ip->b].ip; 
-			break;
-		case MACHINE_OP_CODE_PTR_EQUAL_LGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].ip == machine->stack[ip->b].ip; 
-			break;
-		case MACHINE_OP_CODE_PTR_EQUAL_GLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].ip == machine->stack[ip->b + machine->global_offset].ip; 
-			break;
-		case MACHINE_OP_CODE_PTR_EQUAL_GLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].ip == machine->stack[ip->b + machine->global_offset].ip; 
-			break;
-		case MACHINE_OP_CODE_PTR_EQUAL_GGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].ip == machine->stack[ip->b].ip; 
-			break;
-		case MACHINE_OP_CODE_PTR_EQUAL_GGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].ip == machine->stack[ip->b].ip; 
-			break;
-		case MACHINE_OP_CODE_BOOL_EQUAL_LLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].bool_flag == machine->stack[ip->b + machine->global_offset].bool_flag;
-			break;
-		case MACHINE_OP_CODE_BOOL_EQUAL_LLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].bool_flag == machine->stack[ip->b + machine->global_offset].bool_flag;
-			break;
-		case MACHINE_OP_CODE_BOOL_EQUAL_LGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].bool_flag == machine->stack[ip->b].bool_flag;
-			break;
-		case MACHINE_OP_CODE_BOOL_EQUAL_LGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].bool_flag == machine->stack[ip->b].bool_flag;
-			break;
-		case MACHINE_OP_CODE_BOOL_EQUAL_GLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].bool_flag == machine->stack[ip->b + machine->global_offset].bool_flag;
-			break;
-		case MACHINE_OP_CODE_BOOL_EQUAL_GLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].bool_flag == machine->stack[ip->b + machine->global_offset].bool_flag;
-			break;
-		case MACHINE_OP_CODE_BOOL_EQUAL_GGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].bool_flag == machine->stack[ip->b].bool_flag;
-			break;
-		case MACHINE_OP_CODE_BOOL_EQUAL_GGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].bool_flag == machine->stack[ip->b].bool_flag;
-			break;
-		case MACHINE_OP_CODE_CHAR_EQUAL_LLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].char_int == machine->stack[ip->b + machine->global_offset].char_int;
-			break;
-		case MACHINE_OP_CODE_CHAR_EQUAL_LLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].char_int == machine->stack[ip->b + machine->global_offset].char_int;
-			break;
-		case MACHINE_OP_CODE_CHAR_EQUAL_LGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].char_int == machine->stack[ip->b].char_int;
-			break;
-		case MACHINE_OP_CODE_CHAR_EQUAL_LGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].char_int == machine->stack[ip->b].char_int;
-			break;
-		case MACHINE_OP_CODE_CHAR_EQUAL_GLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].char_int == machine->stack[ip->b + machine->global_offset].char_int;
-			break;
-		case MACHINE_OP_CODE_CHAR_EQUAL_GLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].char_int == machine->stack[ip->b + machine->global_offset].char_int;
-			break;
-		case MACHINE_OP_CODE_CHAR_EQUAL_GGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].char_int == machine->stack[ip->b].char_int;
-			break;
-		case MACHINE_OP_CODE_CHAR_EQUAL_GGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].char_int == machine->stack[ip->b].char_int;
-			break;
-		case MACHINE_OP_CODE_LONG_EQUAL_LLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].long_int == machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_EQUAL_LLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].long_int == machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_EQUAL_LGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].long_int == machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_EQUAL_LGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].long_int == machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_EQUAL_GLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].long_int == machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_EQUAL_GLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].long_int == machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_EQUAL_GGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].long_int == machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_EQUAL_GGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].long_int == machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_EQUAL_LLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].float_int == machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_EQUAL_LLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].float_int == machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_EQUAL_LGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].float_int == machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_EQUAL_LGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].float_int == machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_EQUAL_GLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].float_int == machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_EQUAL_GLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].float_int == machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_EQUAL_GGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].float_int == machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_EQUAL_GGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].float_int == machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MORE_EQUAL_LLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].long_int >= machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MORE_EQUAL_LLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].long_int >= machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MORE_EQUAL_LGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].long_int >= machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MORE_EQUAL_LGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].long_int >= machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MORE_EQUAL_GLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].long_int >= machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MORE_EQUAL_GLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].long_int >= machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MORE_EQUAL_GGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].long_int >= machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MORE_EQUAL_GGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].long_int >= machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_LESS_EQUAL_LLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].long_int <= machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_LESS_EQUAL_LLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].long_int <= machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_LESS_EQUAL_LGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].long_int <= machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_LESS_EQUAL_LGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].long_int <= machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_LESS_EQUAL_GLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].long_int <= machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_LESS_EQUAL_GLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].long_int <= machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_LESS_EQUAL_GGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].long_int <= machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_LESS_EQUAL_GGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].long_int <= machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MORE_LLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].long_int > machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MORE_LLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].long_int > machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MORE_LGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].long_int > machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MORE_LGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].long_int > machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MORE_GLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].long_int > machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MORE_GLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].long_int > machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MORE_GGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].long_int > machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MORE_GGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].long_int > machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_LESS_LLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].long_int < machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_LESS_LLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].long_int < machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_LESS_LGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].long_int < machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_LESS_LGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].long_int < machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_LESS_GLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].long_int < machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_LESS_GLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].long_int < machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_LESS_GGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].long_int < machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_LESS_GGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].long_int < machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_ADD_LLL:
-			machine->stack[ip->c + machine->global_offset].long_int = machine->stack[ip->a + machine->global_offset].long_int + machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_ADD_LLG:
-			machine->stack[ip->c].long_int = machine->stack[ip->a + machine->global_offset].long_int + machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_ADD_LGL:
-			machine->stack[ip->c + machine->global_offset].long_int = machine->stack[ip->a + machine->global_offset].long_int + machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_ADD_LGG:
-			machine->stack[ip->c].long_int = machine->stack[ip->a + machine->global_offset].long_int + machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_ADD_GLL:
-			machine->stack[ip->c + machine->global_offset].long_int = machine->stack[ip->a].long_int + machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_ADD_GLG:
-			machine->stack[ip->c].long_int = machine->stack[ip->a].long_int + machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_ADD_GGL:
-			machine->stack[ip->c + machine->global_offset].long_int = machine->stack[ip->a].long_int + machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_ADD_GGG:
-			machine->stack[ip->c].long_int = machine->stack[ip->a].long_int + machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_SUBTRACT_LLL:
-			machine->stack[ip->c + machine->global_offset].long_int = machine->stack[ip->a + machine->global_offset].long_int - machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_SUBTRACT_LLG:
-			machine->stack[ip->c].long_int = machine->stack[ip->a + machine->global_offset].long_int - machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_SUBTRACT_LGL:
-			machine->stack[ip->c + machine->global_offset].long_int = machine->stack[ip->a + machine->global_offset].long_int - machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_SUBTRACT_LGG:
-			machine->stack[ip->c].long_int = machine->stack[ip->a + machine->global_offset].long_int - machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_SUBTRACT_GLL:
-			machine->stack[ip->c + machine->global_offset].long_int = machine->stack[ip->a].long_int - machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_SUBTRACT_GLG:
-			machine->stack[ip->c].long_int = machine->stack[ip->a].long_int - machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_SUBTRACT_GGL:
-			machine->stack[ip->c + machine->global_offset].long_int = machine->stack[ip->a].long_int - machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_SUBTRACT_GGG:
-			machine->stack[ip->c].long_int = machine->stack[ip->a].long_int - machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MULTIPLY_LLL:
-			machine->stack[ip->c + machine->global_offset].long_int = machine->stack[ip->a + machine->global_offset].long_int * machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MULTIPLY_LLG:
-			machine->stack[ip->c].long_int = machine->stack[ip->a + machine->global_offset].long_int * machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MULTIPLY_LGL:
-			machine->stack[ip->c + machine->global_offset].long_int = machine->stack[ip->a + machine->global_offset].long_int * machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MULTIPLY_LGG:
-			machine->stack[ip->c].long_int = machine->stack[ip->a + machine->global_offset].long_int * machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MULTIPLY_GLL:
-			machine->stack[ip->c + machine->global_offset].long_int = machine->stack[ip->a].long_int * machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MULTIPLY_GLG:
-			machine->stack[ip->c].long_int = machine->stack[ip->a].long_int * machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MULTIPLY_GGL:
-			machine->stack[ip->c + machine->global_offset].long_int = machine->stack[ip->a].long_int * machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MULTIPLY_GGG:
-			machine->stack[ip->c].long_int = machine->stack[ip->a].long_int * machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_DIVIDE_LLL: {
-			uint64_t d = machine->stack[ip->b + machine->global_offset].long_int;
+		MACHINE_CASE(GC_CLEAN):
+			MACHINE_ESCAPE_COND(machine_gc_clean(machine));
+			MACHINE_NEXT;
+		MACHINE_CASE(AND_LLL):
+			frame[ip->c].bool_flag = frame[ip->a].bool_flag && frame[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(AND_LLG):
+			stack[ip->c].bool_flag = frame[ip->a].bool_flag && frame[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(AND_LGL):
+			frame[ip->c].bool_flag = frame[ip->a].bool_flag && stack[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(AND_LGG):
+			stack[ip->c].bool_flag = frame[ip->a].bool_flag && stack[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(AND_GLL):
+			frame[ip->c].bool_flag = stack[ip->a].bool_flag && frame[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(AND_GLG):
+			stack[ip->c].bool_flag = stack[ip->a].bool_flag && frame[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(AND_GGL):
+			frame[ip->c].bool_flag = stack[ip->a].bool_flag && stack[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(AND_GGG):
+			stack[ip->c].bool_flag = stack[ip->a].bool_flag && stack[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(OR_LLL):
+			frame[ip->c].bool_flag = frame[ip->a].bool_flag || frame[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(OR_LLG):
+			stack[ip->c].bool_flag = frame[ip->a].bool_flag || frame[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(OR_LGL):
+			frame[ip->c].bool_flag = frame[ip->a].bool_flag || stack[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(OR_LGG):
+			stack[ip->c].bool_flag = frame[ip->a].bool_flag || stack[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(OR_GLL):
+			frame[ip->c].bool_flag = stack[ip->a].bool_flag || frame[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(OR_GLG):
+			stack[ip->c].bool_flag = stack[ip->a].bool_flag || frame[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(OR_GGL):
+			frame[ip->c].bool_flag = stack[ip->a].bool_flag || stack[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(OR_GGG):
+			stack[ip->c].bool_flag = stack[ip->a].bool_flag || stack[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(NOT_LL):
+			frame[ip->a].bool_flag = !frame[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(NOT_LG):
+			frame[ip->a].bool_flag = !stack[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(NOT_GL):
+			stack[ip->a].bool_flag = !frame[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(NOT_GG):
+			stack[ip->a].bool_flag = !stack[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(LENGTH_LL):
+			frame[ip->a].long_int = frame[ip->b].heap_alloc->limit;
+			MACHINE_NEXT;
+		MACHINE_CASE(LENGTH_LG):
+			frame[ip->a].long_int= stack[ip->b].heap_alloc->limit;
+			MACHINE_NEXT;
+		MACHINE_CASE(LENGTH_GL):
+			stack[ip->a].long_int= frame[ip->b].heap_alloc->limit;
+			MACHINE_NEXT;
+		MACHINE_CASE(LENGTH_GG):
+			stack[ip->a].long_int= stack[ip->b].heap_alloc->limit;
+			MACHINE_NEXT;
+		MACHINE_CASE(PTR_EQUAL_LLL):
+			frame[ip->c].bool_flag = frame[ip->a].ip == frame[ip->b].ip; 
+			MACHINE_NEXT;
+		MACHINE_CASE(PTR_EQUAL_LLG):
+			stack[ip->c].bool_flag = frame[ip->a].ip == frame[ip->b].ip; 
+			MACHINE_NEXT;
+		MACHINE_CASE(PTR_EQUAL_LGL):
+			frame[ip->c].bool_flag = frame[ip->a].ip == stack[ip->b].ip; 
+			MACHINE_NEXT;
+		MACHINE_CASE(PTR_EQUAL_LGG):
+			stack[ip->c].bool_flag = frame[ip->a].ip == stack[ip->b].ip; 
+			MACHINE_NEXT;
+		MACHINE_CASE(PTR_EQUAL_GLL):
+			frame[ip->c].bool_flag = stack[ip->a].ip == frame[ip->b].ip; 
+			MACHINE_NEXT;
+		MACHINE_CASE(PTR_EQUAL_GLG):
+			stack[ip->c].bool_flag = stack[ip->a].ip == frame[ip->b].ip; 
+			MACHINE_NEXT;
+		MACHINE_CASE(PTR_EQUAL_GGL):
+			frame[ip->c].bool_flag = stack[ip->a].ip == stack[ip->b].ip; 
+			MACHINE_NEXT;
+		MACHINE_CASE(PTR_EQUAL_GGG):
+			stack[ip->c].bool_flag = stack[ip->a].ip == stack[ip->b].ip; 
+			MACHINE_NEXT;
+		MACHINE_CASE(BOOL_EQUAL_LLL):
+			frame[ip->c].bool_flag = frame[ip->a].bool_flag == frame[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(BOOL_EQUAL_LLG):
+			stack[ip->c].bool_flag = frame[ip->a].bool_flag == frame[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(BOOL_EQUAL_LGL):
+			frame[ip->c].bool_flag = frame[ip->a].bool_flag == stack[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(BOOL_EQUAL_LGG):
+			stack[ip->c].bool_flag = frame[ip->a].bool_flag == stack[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(BOOL_EQUAL_GLL):
+			frame[ip->c].bool_flag = stack[ip->a].bool_flag == frame[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(BOOL_EQUAL_GLG):
+			stack[ip->c].bool_flag = stack[ip->a].bool_flag == frame[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(BOOL_EQUAL_GGL):
+			frame[ip->c].bool_flag = stack[ip->a].bool_flag == stack[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(BOOL_EQUAL_GGG):
+			stack[ip->c].bool_flag = stack[ip->a].bool_flag == stack[ip->b].bool_flag;
+			MACHINE_NEXT;
+		MACHINE_CASE(CHAR_EQUAL_LLL):
+			frame[ip->c].bool_flag = frame[ip->a].char_int == frame[ip->b].char_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(CHAR_EQUAL_LLG):
+			stack[ip->c].bool_flag = frame[ip->a].char_int == frame[ip->b].char_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(CHAR_EQUAL_LGL):
+			frame[ip->c].bool_flag = frame[ip->a].char_int == stack[ip->b].char_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(CHAR_EQUAL_LGG):
+			stack[ip->c].bool_flag = frame[ip->a].char_int == stack[ip->b].char_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(CHAR_EQUAL_GLL):
+			frame[ip->c].bool_flag = stack[ip->a].char_int == frame[ip->b].char_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(CHAR_EQUAL_GLG):
+			stack[ip->c].bool_flag = stack[ip->a].char_int == frame[ip->b].char_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(CHAR_EQUAL_GGL):
+			frame[ip->c].bool_flag = stack[ip->a].char_int == stack[ip->b].char_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(CHAR_EQUAL_GGG):
+			stack[ip->c].bool_flag = stack[ip->a].char_int == stack[ip->b].char_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_EQUAL_LLL):
+			frame[ip->c].bool_flag = frame[ip->a].long_int == frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_EQUAL_LLG):
+			stack[ip->c].bool_flag = frame[ip->a].long_int == frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_EQUAL_LGL):
+			frame[ip->c].bool_flag = frame[ip->a].long_int == stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_EQUAL_LGG):
+			stack[ip->c].bool_flag = frame[ip->a].long_int == stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_EQUAL_GLL):
+			frame[ip->c].bool_flag = stack[ip->a].long_int == frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_EQUAL_GLG):
+			stack[ip->c].bool_flag = stack[ip->a].long_int == frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_EQUAL_GGL):
+			frame[ip->c].bool_flag = stack[ip->a].long_int == stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_EQUAL_GGG):
+			stack[ip->c].bool_flag = stack[ip->a].long_int == stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_EQUAL_LLL):
+			frame[ip->c].bool_flag = frame[ip->a].float_int == frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_EQUAL_LLG):
+			stack[ip->c].bool_flag = frame[ip->a].float_int == frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_EQUAL_LGL):
+			frame[ip->c].bool_flag = frame[ip->a].float_int == stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_EQUAL_LGG):
+			stack[ip->c].bool_flag = frame[ip->a].float_int == stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_EQUAL_GLL):
+			frame[ip->c].bool_flag = stack[ip->a].float_int == frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_EQUAL_GLG):
+			stack[ip->c].bool_flag = stack[ip->a].float_int == frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_EQUAL_GGL):
+			frame[ip->c].bool_flag = stack[ip->a].float_int == stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_EQUAL_GGG):
+			stack[ip->c].bool_flag = stack[ip->a].float_int == stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MORE_EQUAL_LLL):
+			frame[ip->c].bool_flag = frame[ip->a].long_int >= frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MORE_EQUAL_LLG):
+			stack[ip->c].bool_flag = frame[ip->a].long_int >= frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MORE_EQUAL_LGL):
+			frame[ip->c].bool_flag = frame[ip->a].long_int >= stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MORE_EQUAL_LGG):
+			stack[ip->c].bool_flag = frame[ip->a].long_int >= stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MORE_EQUAL_GLL):
+			frame[ip->c].bool_flag = stack[ip->a].long_int >= frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MORE_EQUAL_GLG):
+			stack[ip->c].bool_flag = stack[ip->a].long_int >= frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MORE_EQUAL_GGL):
+			frame[ip->c].bool_flag = stack[ip->a].long_int >= stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MORE_EQUAL_GGG):
+			stack[ip->c].bool_flag = stack[ip->a].long_int >= stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_LESS_EQUAL_LLL):
+			frame[ip->c].bool_flag = frame[ip->a].long_int <= frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_LESS_EQUAL_LLG):
+			stack[ip->c].bool_flag = frame[ip->a].long_int <= frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_LESS_EQUAL_LGL):
+			frame[ip->c].bool_flag = frame[ip->a].long_int <= stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_LESS_EQUAL_LGG):
+			stack[ip->c].bool_flag = frame[ip->a].long_int <= stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_LESS_EQUAL_GLL):
+			frame[ip->c].bool_flag = stack[ip->a].long_int <= frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_LESS_EQUAL_GLG):
+			stack[ip->c].bool_flag = stack[ip->a].long_int <= frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_LESS_EQUAL_GGL):
+			frame[ip->c].bool_flag = stack[ip->a].long_int <= stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_LESS_EQUAL_GGG):
+			stack[ip->c].bool_flag = stack[ip->a].long_int <= stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MORE_LLL):
+			frame[ip->c].bool_flag = frame[ip->a].long_int > frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MORE_LLG):
+			stack[ip->c].bool_flag = frame[ip->a].long_int > frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MORE_LGL):
+			frame[ip->c].bool_flag = frame[ip->a].long_int > stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MORE_LGG):
+			stack[ip->c].bool_flag = frame[ip->a].long_int > stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MORE_GLL):
+			frame[ip->c].bool_flag = stack[ip->a].long_int > frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MORE_GLG):
+			stack[ip->c].bool_flag = stack[ip->a].long_int > frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MORE_GGL):
+			frame[ip->c].bool_flag = stack[ip->a].long_int > stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MORE_GGG):
+			stack[ip->c].bool_flag = stack[ip->a].long_int > stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_LESS_LLL):
+			frame[ip->c].bool_flag = frame[ip->a].long_int < frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_LESS_LLG):
+			stack[ip->c].bool_flag = frame[ip->a].long_int < frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_LESS_LGL):
+			frame[ip->c].bool_flag = frame[ip->a].long_int < stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_LESS_LGG):
+			stack[ip->c].bool_flag = frame[ip->a].long_int < stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_LESS_GLL):
+			frame[ip->c].bool_flag = stack[ip->a].long_int < frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_LESS_GLG):
+			stack[ip->c].bool_flag = stack[ip->a].long_int < frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_LESS_GGL):
+			frame[ip->c].bool_flag = stack[ip->a].long_int < stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_LESS_GGG):
+			stack[ip->c].bool_flag = stack[ip->a].long_int < stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_ADD_LLL):
+			frame[ip->c].long_int = frame[ip->a].long_int + frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_ADD_LLG):
+			stack[ip->c].long_int = frame[ip->a].long_int + frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_ADD_LGL):
+			frame[ip->c].long_int = frame[ip->a].long_int + stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_ADD_LGG):
+			stack[ip->c].long_int = frame[ip->a].long_int + stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_ADD_GLL):
+			frame[ip->c].long_int = stack[ip->a].long_int + frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_ADD_GLG):
+			stack[ip->c].long_int = stack[ip->a].long_int + frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_ADD_GGL):
+			frame[ip->c].long_int = stack[ip->a].long_int + stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_ADD_GGG):
+			stack[ip->c].long_int = stack[ip->a].long_int + stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_SUBTRACT_LLL):
+			frame[ip->c].long_int = frame[ip->a].long_int - frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_SUBTRACT_LLG):
+			stack[ip->c].long_int = frame[ip->a].long_int - frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_SUBTRACT_LGL):
+			frame[ip->c].long_int = frame[ip->a].long_int - stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_SUBTRACT_LGG):
+			stack[ip->c].long_int = frame[ip->a].long_int - stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_SUBTRACT_GLL):
+			frame[ip->c].long_int = stack[ip->a].long_int - frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_SUBTRACT_GLG):
+			stack[ip->c].long_int = stack[ip->a].long_int - frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_SUBTRACT_GGL):
+			frame[ip->c].long_int = stack[ip->a].long_int - stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_SUBTRACT_GGG):
+			stack[ip->c].long_int = stack[ip->a].long_int - stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MULTIPLY_LLL):
+			frame[ip->c].long_int = frame[ip->a].long_int * frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MULTIPLY_LLG):
+			stack[ip->c].long_int = frame[ip->a].long_int * frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MULTIPLY_LGL):
+			frame[ip->c].long_int = frame[ip->a].long_int * stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MULTIPLY_LGG):
+			stack[ip->c].long_int = frame[ip->a].long_int * stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MULTIPLY_GLL):
+			frame[ip->c].long_int = stack[ip->a].long_int * frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MULTIPLY_GLG):
+			stack[ip->c].long_int = stack[ip->a].long_int * frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MULTIPLY_GGL):
+			frame[ip->c].long_int = stack[ip->a].long_int * stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MULTIPLY_GGG):
+			stack[ip->c].long_int = stack[ip->a].long_int * stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_DIVIDE_LLL): {
+			uint64_t d = frame[ip->b].long_int;
 			MACHINE_PANIC_COND(d, ERROR_DIVIDE_BY_ZERO);
-			machine->stack[ip->c + machine->global_offset].long_int = machine->stack[ip->a + machine->global_offset].long_int / d;
-			break;
+			frame[ip->c].long_int = frame[ip->a].long_int / d;
+			MACHINE_NEXT;
 		}
-		case MACHINE_OP_CODE_LONG_DIVIDE_LLG: {
-			uint64_t d = machine->stack[ip->b + machine->global_offset].long_int;
+		MACHINE_CASE(LONG_DIVIDE_LLG): {
+			uint64_t d = frame[ip->b].long_int;
 			MACHINE_PANIC_COND(d, ERROR_DIVIDE_BY_ZERO);
-			machine->stack[ip->c].long_int = machine->stack[ip->a + machine->global_offset].long_int / d;
-			break;
+			stack[ip->c].long_int = frame[ip->a].long_int / d;
+			MACHINE_NEXT;
 		}
-		case MACHINE_OP_CODE_LONG_DIVIDE_LGL: {
-			uint64_t d = machine->stack[ip->b].long_int;
+		MACHINE_CASE(LONG_DIVIDE_LGL): {
+			uint64_t d = stack[ip->b].long_int;
 			MACHINE_PANIC_COND(d, ERROR_DIVIDE_BY_ZERO);
-			machine->stack[ip->c + machine->global_offset].long_int = machine->stack[ip->a + machine->global_offset].long_int / d;
-			break;
+			frame[ip->c].long_int = frame[ip->a].long_int / d;
+			MACHINE_NEXT;
 		}
-		case MACHINE_OP_CODE_LONG_DIVIDE_LGG: {
-			uint64_t d = machine->stack[ip->b].long_int;
+		MACHINE_CASE(LONG_DIVIDE_LGG): {
+			uint64_t d = stack[ip->b].long_int;
 			MACHINE_PANIC_COND(d, ERROR_DIVIDE_BY_ZERO);
-			machine->stack[ip->c].long_int = machine->stack[ip->a + machine->global_offset].long_int / d;
-			break;
+			stack[ip->c].long_int = frame[ip->a].long_int / d;
+			MACHINE_NEXT;
 		}
-		case MACHINE_OP_CODE_LONG_DIVIDE_GLL: {
-			uint64_t d = machine->stack[ip->b + machine->global_offset].long_int;
+		MACHINE_CASE(LONG_DIVIDE_GLL): {
+			uint64_t d = frame[ip->b].long_int;
 			MACHINE_PANIC_COND(d, ERROR_DIVIDE_BY_ZERO);
-			machine->stack[ip->c + machine->global_offset].long_int = machine->stack[ip->a].long_int / d;
-			break;
+			frame[ip->c].long_int = stack[ip->a].long_int / d;
+			MACHINE_NEXT;
 		}
-		case MACHINE_OP_CODE_LONG_DIVIDE_GLG: {
-			uint64_t d = machine->stack[ip->b + machine->global_offset].long_int;
+		MACHINE_CASE(LONG_DIVIDE_GLG): {
+			uint64_t d = frame[ip->b].long_int;
 			MACHINE_PANIC_COND(d, ERROR_DIVIDE_BY_ZERO);
-			machine->stack[ip->c].long_int = machine->stack[ip->a].long_int / d;
-			break;
+			stack[ip->c].long_int = stack[ip->a].long_int / d;
+			MACHINE_NEXT;
 		}
-		case MACHINE_OP_CODE_LONG_DIVIDE_GGL: {
-			uint64_t d = machine->stack[ip->b].long_int;
+		MACHINE_CASE(LONG_DIVIDE_GGL): {
+			uint64_t d = stack[ip->b].long_int;
 			MACHINE_PANIC_COND(d, ERROR_DIVIDE_BY_ZERO);
-			machine->stack[ip->c + machine->global_offset].long_int = machine->stack[ip->a].long_int / d;
-			break;
+			frame[ip->c].long_int = stack[ip->a].long_int / d;
+			MACHINE_NEXT;
 		}
-		case MACHINE_OP_CODE_LONG_DIVIDE_GGG: {
-			uint64_t d = machine->stack[ip->b].long_int;
+		MACHINE_CASE(LONG_DIVIDE_GGG): {
+			uint64_t d = stack[ip->b].long_int;
 			MACHINE_PANIC_COND(d, ERROR_DIVIDE_BY_ZERO);
-			machine->stack[ip->c].long_int = machine->stack[ip->a].long_int / d;
-			break;
+			stack[ip->c].long_int = stack[ip->a].long_int / d;
+			MACHINE_NEXT;
 		}
-		case MACHINE_OP_CODE_LONG_MODULO_LLL:
-			machine->stack[ip->c + machine->global_offset].long_int = machine->stack[ip->a + machine->global_offset].long_int % machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MODULO_LLG:
-			machine->stack[ip->c].long_int = machine->stack[ip->a + machine->global_offset].long_int % machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MODULO_LGL:
-			machine->stack[ip->c + machine->global_offset].long_int = machine->stack[ip->a + machine->global_offset].long_int % machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MODULO_LGG:
-			machine->stack[ip->c].long_int = machine->stack[ip->a + machine->global_offset].long_int % machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MODULO_GLL:
-			machine->stack[ip->c + machine->global_offset].long_int = machine->stack[ip->a].long_int % machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MODULO_GLG:
-			machine->stack[ip->c].long_int = machine->stack[ip->a].long_int % machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MODULO_GGL:
-			machine->stack[ip->c + machine->global_offset].long_int = machine->stack[ip->a].long_int % machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_MODULO_GGG:
-			machine->stack[ip->c].long_int = machine->stack[ip->a].long_int % machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_EXPONENTIATE_LLL:
-			machine->stack[ip->c + machine->global_offset].long_int = longpow(machine->stack[ip->a + machine->global_offset].long_int, machine->stack[ip->b + machine->global_offset].long_int);
-			break;
-		case MACHINE_OP_CODE_LONG_EXPONENTIATE_LLG:
-			machine->stack[ip->c].long_int = longpow(machine->stack[ip->a + machine->global_offset].long_int, machine->stack[ip->b + machine->global_offset].long_int);
-			break;
-		case MACHINE_OP_CODE_LONG_EXPONENTIATE_LGL:
-			machine->stack[ip->c + machine->global_offset].long_int = longpow(machine->stack[ip->a + machine->global_offset].long_int, machine->stack[ip->b].long_int);
-			break;
-		case MACHINE_OP_CODE_LONG_EXPONENTIATE_LGG:
-			machine->stack[ip->c].long_int = longpow(machine->stack[ip->a + machine->global_offset].long_int, machine->stack[ip->b].long_int);
-			break;
-		case MACHINE_OP_CODE_LONG_EXPONENTIATE_GLL:
-			machine->stack[ip->c + machine->global_offset].long_int = longpow(machine->stack[ip->a].long_int, machine->stack[ip->b + machine->global_offset].long_int);
-			break;
-		case MACHINE_OP_CODE_LONG_EXPONENTIATE_GLG:
-			machine->stack[ip->c].long_int = longpow(machine->stack[ip->a].long_int, machine->stack[ip->b + machine->global_offset].long_int);
-			break;
-		case MACHINE_OP_CODE_LONG_EXPONENTIATE_GGL:
-			machine->stack[ip->c + machine->global_offset].long_int = longpow(machine->stack[ip->a].long_int, machine->stack[ip->b].long_int);
-			break;
-		case MACHINE_OP_CODE_LONG_EXPONENTIATE_GGG:
-			machine->stack[ip->c].long_int = longpow(machine->stack[ip->a].long_int, machine->stack[ip->b].long_int);
-			break; 
-		case MACHINE_OP_CODE_FLOAT_MORE_EQUAL_LLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].float_int >= machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_MORE_EQUAL_LLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].float_int >= machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_MORE_EQUAL_LGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].float_int >= machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_MORE_EQUAL_LGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].float_int >= machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_MORE_EQUAL_GLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].float_int >= machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_MORE_EQUAL_GLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].float_int >= machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_MORE_EQUAL_GGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].float_int >= machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_MORE_EQUAL_GGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].float_int >= machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_LESS_EQUAL_LLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].float_int <= machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_LESS_EQUAL_LLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].float_int <= machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_LESS_EQUAL_LGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].float_int <= machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_LESS_EQUAL_LGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].float_int <= machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_LESS_EQUAL_GLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].float_int <= machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_LESS_EQUAL_GLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].float_int <= machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_LESS_EQUAL_GGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].float_int <= machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_LESS_EQUAL_GGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].float_int <= machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_MORE_LLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].float_int > machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_MORE_LLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].float_int > machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_MORE_LGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].float_int > machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_MORE_LGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].float_int > machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_MORE_GLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].float_int > machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_MORE_GLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].float_int > machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_MORE_GGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].float_int > machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_MORE_GGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].float_int > machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_LESS_LLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].float_int < machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_LESS_LLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].float_int < machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_LESS_LGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a + machine->global_offset].float_int < machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_LESS_LGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a + machine->global_offset].float_int < machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_LESS_GLL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].float_int < machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_LESS_GLG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].float_int < machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_LESS_GGL:
-			machine->stack[ip->c + machine->global_offset].bool_flag = machine->stack[ip->a].float_int < machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_LESS_GGG:
-			machine->stack[ip->c].bool_flag = machine->stack[ip->a].float_int < machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_ADD_LLL:
-			machine->stack[ip->c + machine->global_offset].float_int = machine->stack[ip->a + machine->global_offset].float_int + machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_ADD_LLG:
-			machine->stack[ip->c].float_int = machine->stack[ip->a + machine->global_offset].float_int + machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_ADD_LGL:
-			machine->stack[ip->c + machine->global_offset].float_int = machine->stack[ip->a + machine->global_offset].float_int + machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_ADD_LGG:
-			machine->stack[ip->c].float_int = machine->stack[ip->a + machine->global_offset].float_int + machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_ADD_GLL:
-			machine->stack[ip->c + machine->global_offset].float_int = machine->stack[ip->a].float_int + machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_ADD_GLG:
-			machine->stack[ip->c].float_int = machine->stack[ip->a].float_int + machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_ADD_GGL:
-			machine->stack[ip->c + machine->global_offset].float_int = machine->stack[ip->a].float_int + machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_ADD_GGG:
-			machine->stack[ip->c].float_int = machine->stack[ip->a].float_int + machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_SUBTRACT_LLL:
-			machine->stack[ip->c + machine->global_offset].float_int = machine->stack[ip->a + machine->global_offset].float_int - machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_SUBTRACT_LLG:
-			machine->stack[ip->c].float_int = machine->stack[ip->a + machine->global_offset].float_int - machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_SUBTRACT_LGL:
-			machine->stack[ip->c + machine->global_offset].float_int = machine->stack[ip->a + machine->global_offset].float_int - machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_SUBTRACT_LGG:
-			machine->stack[ip->c].float_int = machine->stack[ip->a + machine->global_offset].float_int - machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_SUBTRACT_GLL:
-			machine->stack[ip->c + machine->global_offset].float_int = machine->stack[ip->a].float_int - machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_SUBTRACT_GLG:
-			machine->stack[ip->c].float_int = machine->stack[ip->a].float_int - machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_SUBTRACT_GGL:
-			machine->stack[ip->c + machine->global_offset].float_int = machine->stack[ip->a].float_int - machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_SUBTRACT_GGG:
-			machine->stack[ip->c].float_int = machine->stack[ip->a].float_int - machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_MULTIPLY_LLL:
-			machine->stack[ip->c + machine->global_offset].float_int = machine->stack[ip->a + machine->global_offset].float_int * machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_MULTIPLY_LLG:
-			machine->stack[ip->c].float_int = machine->stack[ip->a + machine->global_offset].float_int * machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_MULTIPLY_LGL:
-			machine->stack[ip->c + machine->global_offset].float_int = machine->stack[ip->a + machine->global_offset].float_int * machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_MULTIPLY_LGG:
-			machine->stack[ip->c].float_int = machine->stack[ip->a + machine->global_offset].float_int * machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_MULTIPLY_GLL:
-			machine->stack[ip->c + machine->global_offset].float_int = machine->stack[ip->a].float_int * machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_MULTIPLY_GLG:
-			machine->stack[ip->c].float_int = machine->stack[ip->a].float_int * machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_MULTIPLY_GGL:
-			machine->stack[ip->c + machine->global_offset].float_int = machine->stack[ip->a].float_int * machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_MULTIPLY_GGG:
-			machine->stack[ip->c].float_int = machine->stack[ip->a].float_int * machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_DIVIDE_LLL: {
-			machine->stack[ip->c + machine->global_offset].float_int = machine->stack[ip->a + machine->global_offset].float_int / machine->stack[ip->b + machine->global_offset].float_int;
-			break;
+		MACHINE_CASE(LONG_MODULO_LLL):
+			frame[ip->c].long_int = frame[ip->a].long_int % frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MODULO_LLG):
+			stack[ip->c].long_int = frame[ip->a].long_int % frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MODULO_LGL):
+			frame[ip->c].long_int = frame[ip->a].long_int % stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MODULO_LGG):
+			stack[ip->c].long_int = frame[ip->a].long_int % stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MODULO_GLL):
+			frame[ip->c].long_int = stack[ip->a].long_int % frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MODULO_GLG):
+			stack[ip->c].long_int = stack[ip->a].long_int % frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MODULO_GGL):
+			frame[ip->c].long_int = stack[ip->a].long_int % stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_MODULO_GGG):
+			stack[ip->c].long_int = stack[ip->a].long_int % stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_EXPONENTIATE_LLL):
+			frame[ip->c].long_int = longpow(frame[ip->a].long_int, frame[ip->b].long_int);
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_EXPONENTIATE_LLG):
+			stack[ip->c].long_int = longpow(frame[ip->a].long_int, frame[ip->b].long_int);
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_EXPONENTIATE_LGL):
+			frame[ip->c].long_int = longpow(frame[ip->a].long_int, stack[ip->b].long_int);
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_EXPONENTIATE_LGG):
+			stack[ip->c].long_int = longpow(frame[ip->a].long_int, stack[ip->b].long_int);
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_EXPONENTIATE_GLL):
+			frame[ip->c].long_int = longpow(stack[ip->a].long_int, frame[ip->b].long_int);
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_EXPONENTIATE_GLG):
+			stack[ip->c].long_int = longpow(stack[ip->a].long_int, frame[ip->b].long_int);
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_EXPONENTIATE_GGL):
+			frame[ip->c].long_int = longpow(stack[ip->a].long_int, stack[ip->b].long_int);
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_EXPONENTIATE_GGG):
+			stack[ip->c].long_int = longpow(stack[ip->a].long_int, stack[ip->b].long_int);
+			MACHINE_NEXT; 
+		MACHINE_CASE(FLOAT_MORE_EQUAL_LLL):
+			frame[ip->c].bool_flag = frame[ip->a].float_int >= frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MORE_EQUAL_LLG):
+			stack[ip->c].bool_flag = frame[ip->a].float_int >= frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MORE_EQUAL_LGL):
+			frame[ip->c].bool_flag = frame[ip->a].float_int >= stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MORE_EQUAL_LGG):
+			stack[ip->c].bool_flag = frame[ip->a].float_int >= stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MORE_EQUAL_GLL):
+			frame[ip->c].bool_flag = stack[ip->a].float_int >= frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MORE_EQUAL_GLG):
+			stack[ip->c].bool_flag = stack[ip->a].float_int >= frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MORE_EQUAL_GGL):
+			frame[ip->c].bool_flag = stack[ip->a].float_int >= stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MORE_EQUAL_GGG):
+			stack[ip->c].bool_flag = stack[ip->a].float_int >= stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_LESS_EQUAL_LLL):
+			frame[ip->c].bool_flag = frame[ip->a].float_int <= frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_LESS_EQUAL_LLG):
+			stack[ip->c].bool_flag = frame[ip->a].float_int <= frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_LESS_EQUAL_LGL):
+			frame[ip->c].bool_flag = frame[ip->a].float_int <= stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_LESS_EQUAL_LGG):
+			stack[ip->c].bool_flag = frame[ip->a].float_int <= stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_LESS_EQUAL_GLL):
+			frame[ip->c].bool_flag = stack[ip->a].float_int <= frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_LESS_EQUAL_GLG):
+			stack[ip->c].bool_flag = stack[ip->a].float_int <= frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_LESS_EQUAL_GGL):
+			frame[ip->c].bool_flag = stack[ip->a].float_int <= stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_LESS_EQUAL_GGG):
+			stack[ip->c].bool_flag = stack[ip->a].float_int <= stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MORE_LLL):
+			frame[ip->c].bool_flag = frame[ip->a].float_int > frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MORE_LLG):
+			stack[ip->c].bool_flag = frame[ip->a].float_int > frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MORE_LGL):
+			frame[ip->c].bool_flag = frame[ip->a].float_int > stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MORE_LGG):
+			stack[ip->c].bool_flag = frame[ip->a].float_int > stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MORE_GLL):
+			frame[ip->c].bool_flag = stack[ip->a].float_int > frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MORE_GLG):
+			stack[ip->c].bool_flag = stack[ip->a].float_int > frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MORE_GGL):
+			frame[ip->c].bool_flag = stack[ip->a].float_int > stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MORE_GGG):
+			stack[ip->c].bool_flag = stack[ip->a].float_int > stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_LESS_LLL):
+			frame[ip->c].bool_flag = frame[ip->a].float_int < frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_LESS_LLG):
+			stack[ip->c].bool_flag = frame[ip->a].float_int < frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_LESS_LGL):
+			frame[ip->c].bool_flag = frame[ip->a].float_int < stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_LESS_LGG):
+			stack[ip->c].bool_flag = frame[ip->a].float_int < stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_LESS_GLL):
+			frame[ip->c].bool_flag = stack[ip->a].float_int < frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_LESS_GLG):
+			stack[ip->c].bool_flag = stack[ip->a].float_int < frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_LESS_GGL):
+			frame[ip->c].bool_flag = stack[ip->a].float_int < stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_LESS_GGG):
+			stack[ip->c].bool_flag = stack[ip->a].float_int < stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_ADD_LLL):
+			frame[ip->c].float_int = frame[ip->a].float_int + frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_ADD_LLG):
+			stack[ip->c].float_int = frame[ip->a].float_int + frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_ADD_LGL):
+			frame[ip->c].float_int = frame[ip->a].float_int + stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_ADD_LGG):
+			stack[ip->c].float_int = frame[ip->a].float_int + stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_ADD_GLL):
+			frame[ip->c].float_int = stack[ip->a].float_int + frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_ADD_GLG):
+			stack[ip->c].float_int = stack[ip->a].float_int + frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_ADD_GGL):
+			frame[ip->c].float_int = stack[ip->a].float_int + stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_ADD_GGG):
+			stack[ip->c].float_int = stack[ip->a].float_int + stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_SUBTRACT_LLL):
+			frame[ip->c].float_int = frame[ip->a].float_int - frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_SUBTRACT_LLG):
+			stack[ip->c].float_int = frame[ip->a].float_int - frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_SUBTRACT_LGL):
+			frame[ip->c].float_int = frame[ip->a].float_int - stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_SUBTRACT_LGG):
+			stack[ip->c].float_int = frame[ip->a].float_int - stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_SUBTRACT_GLL):
+			frame[ip->c].float_int = stack[ip->a].float_int - frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_SUBTRACT_GLG):
+			stack[ip->c].float_int = stack[ip->a].float_int - frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_SUBTRACT_GGL):
+			frame[ip->c].float_int = stack[ip->a].float_int - stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_SUBTRACT_GGG):
+			stack[ip->c].float_int = stack[ip->a].float_int - stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MULTIPLY_LLL):
+			frame[ip->c].float_int = frame[ip->a].float_int * frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MULTIPLY_LLG):
+			stack[ip->c].float_int = frame[ip->a].float_int * frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MULTIPLY_LGL):
+			frame[ip->c].float_int = frame[ip->a].float_int * stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MULTIPLY_LGG):
+			stack[ip->c].float_int = frame[ip->a].float_int * stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MULTIPLY_GLL):
+			frame[ip->c].float_int = stack[ip->a].float_int * frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MULTIPLY_GLG):
+			stack[ip->c].float_int = stack[ip->a].float_int * frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MULTIPLY_GGL):
+			frame[ip->c].float_int = stack[ip->a].float_int * stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MULTIPLY_GGG):
+			stack[ip->c].float_int = stack[ip->a].float_int * stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_DIVIDE_LLL): {
+			frame[ip->c].float_int = frame[ip->a].float_int / frame[ip->b].float_int;
+			MACHINE_NEXT;
 		}
-		case MACHINE_OP_CODE_FLOAT_DIVIDE_LLG: {
-			machine->stack[ip->c].float_int = machine->stack[ip->a + machine->global_offset].float_int / machine->stack[ip->b + machine->global_offset].float_int;
-			break;
+		MACHINE_CASE(FLOAT_DIVIDE_LLG): {
+			stack[ip->c].float_int = frame[ip->a].float_int / frame[ip->b].float_int;
+			MACHINE_NEXT;
 		}
-		case MACHINE_OP_CODE_FLOAT_DIVIDE_LGL: {
-			machine->stack[ip->c + machine->global_offset].float_int = machine->stack[ip->a + machine->global_offset].float_int / machine->stack[ip->b].float_int;
-			break;
+		MACHINE_CASE(FLOAT_DIVIDE_LGL): {
+			frame[ip->c].float_int = frame[ip->a].float_int / stack[ip->b].float_int;
+			MACHINE_NEXT;
 		}
-		case MACHINE_OP_CODE_FLOAT_DIVIDE_LGG: {
-			machine->stack[ip->c].float_int = machine->stack[ip->a + machine->global_offset].float_int / machine->stack[ip->b].float_int;
-			break;
+		MACHINE_CASE(FLOAT_DIVIDE_LGG): {
+			stack[ip->c].float_int = frame[ip->a].float_int / stack[ip->b].float_int;
+			MACHINE_NEXT;
 		}
-		case MACHINE_OP_CODE_FLOAT_DIVIDE_GLL: {
-			machine->stack[ip->c + machine->global_offset].float_int = machine->stack[ip->a].float_int / machine->stack[ip->b + machine->global_offset].float_int;
-			break;
+		MACHINE_CASE(FLOAT_DIVIDE_GLL): {
+			frame[ip->c].float_int = stack[ip->a].float_int / frame[ip->b].float_int;
+			MACHINE_NEXT;
 		}
-		case MACHINE_OP_CODE_FLOAT_DIVIDE_GLG: {
-			machine->stack[ip->c].float_int = machine->stack[ip->a].float_int / machine->stack[ip->b + machine->global_offset].float_int;
-			break;
+		MACHINE_CASE(FLOAT_DIVIDE_GLG): {
+			stack[ip->c].float_int = stack[ip->a].float_int / frame[ip->b].float_int;
+			MACHINE_NEXT;
 		}
-		case MACHINE_OP_CODE_FLOAT_DIVIDE_GGL: {
-			machine->stack[ip->c + machine->global_offset].float_int = machine->stack[ip->a].float_int / machine->stack[ip->b].float_int;
-			break;
+		MACHINE_CASE(FLOAT_DIVIDE_GGL): {
+			frame[ip->c].float_int = stack[ip->a].float_int / stack[ip->b].float_int;
+			MACHINE_NEXT;
 		}
-		case MACHINE_OP_CODE_FLOAT_DIVIDE_GGG: {
-			machine->stack[ip->c].float_int = machine->stack[ip->a].float_int / machine->stack[ip->b].float_int;
-			break;
+		MACHINE_CASE(FLOAT_DIVIDE_GGG): {
+			stack[ip->c].float_int = stack[ip->a].float_int / stack[ip->b].float_int;
+			MACHINE_NEXT;
 		}
-		case MACHINE_OP_CODE_FLOAT_MODULO_LLL:
-			machine->stack[ip->c + machine->global_offset].float_int = fmod(machine->stack[ip->a + machine->global_offset].float_int, machine->stack[ip->b + machine->global_offset].float_int);
-			break;
-		case MACHINE_OP_CODE_FLOAT_MODULO_LLG:
-			machine->stack[ip->c].float_int = fmod(machine->stack[ip->a + machine->global_offset].float_int, machine->stack[ip->b + machine->global_offset].float_int);
-			break;
-		case MACHINE_OP_CODE_FLOAT_MODULO_LGL:
-			machine->stack[ip->c + machine->global_offset].float_int = fmod(machine->stack[ip->a + machine->global_offset].float_int, machine->stack[ip->b].float_int);
-			break;
-		case MACHINE_OP_CODE_FLOAT_MODULO_LGG:
-			machine->stack[ip->c].float_int = fmod(machine->stack[ip->a + machine->global_offset].float_int, machine->stack[ip->b].float_int);
-			break;
-		case MACHINE_OP_CODE_FLOAT_MODULO_GLL:
-			machine->stack[ip->c + machine->global_offset].float_int = fmod(machine->stack[ip->a].float_int, machine->stack[ip->b + machine->global_offset].float_int);
-			break;
-		case MACHINE_OP_CODE_FLOAT_MODULO_GLG:
-			machine->stack[ip->c].float_int = fmod(machine->stack[ip->a].float_int, machine->stack[ip->b + machine->global_offset].float_int);
-			break;
-		case MACHINE_OP_CODE_FLOAT_MODULO_GGL:
-			machine->stack[ip->c + machine->global_offset].float_int = fmod(machine->stack[ip->a].float_int, machine->stack[ip->b].float_int);
-			break;
-		case MACHINE_OP_CODE_FLOAT_MODULO_GGG:
-			machine->stack[ip->c].float_int = fmod(machine->stack[ip->a].float_int, machine->stack[ip->b].float_int);
-			break;
-		case MACHINE_OP_CODE_FLOAT_EXPONENTIATE_LLL:
-			machine->stack[ip->c + machine->global_offset].float_int = pow(machine->stack[ip->a + machine->global_offset].float_int, machine->stack[ip->b + machine->global_offset].float_int);
-			break;
-		case MACHINE_OP_CODE_FLOAT_EXPONENTIATE_LLG:
-			machine->stack[ip->c].float_int = pow(machine->stack[ip->a + machine->global_offset].float_int, machine->stack[ip->b + machine->global_offset].float_int);
-			break;
-		case MACHINE_OP_CODE_FLOAT_EXPONENTIATE_LGL:
-			machine->stack[ip->c + machine->global_offset].float_int = pow(machine->stack[ip->a + machine->global_offset].float_int, machine->stack[ip->b].float_int);
-			break;
-		case MACHINE_OP_CODE_FLOAT_EXPONENTIATE_LGG:
-			machine->stack[ip->c].float_int = pow(machine->stack[ip->a + machine->global_offset].float_int, machine->stack[ip->b].float_int);
-			break;
-		case MACHINE_OP_CODE_FLOAT_EXPONENTIATE_GLL:
-			machine->stack[ip->c + machine->global_offset].float_int = pow(machine->stack[ip->a].float_int, machine->stack[ip->b + machine->global_offset].float_int);
-			break;
-		case MACHINE_OP_CODE_FLOAT_EXPONENTIATE_GLG:
-			machine->stack[ip->c].float_int = pow(machine->stack[ip->a].float_int, machine->stack[ip->b + machine->global_offset].float_int);
-			break;
-		case MACHINE_OP_CODE_FLOAT_EXPONENTIATE_GGL:
-			machine->stack[ip->c + machine->global_offset].float_int = pow(machine->stack[ip->a].float_int, machine->stack[ip->b].float_int);
-			break;
-		case MACHINE_OP_CODE_FLOAT_EXPONENTIATE_GGG:
-			machine->stack[ip->c].float_int = pow(machine->stack[ip->a].float_int, machine->stack[ip->b].float_int);
-			break;
-		case MACHINE_OP_CODE_LONG_NEGATE_LL:
-			machine->stack[ip->a + machine->global_offset].long_int = -machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_NEGATE_LG:
-			machine->stack[ip->a + machine->global_offset].long_int = -machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_NEGATE_GL:
-			machine->stack[ip->a].long_int = -machine->stack[ip->b + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_NEGATE_GG:
-			machine->stack[ip->a].long_int = -machine->stack[ip->b].long_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_NEGATE_LL:
-			machine->stack[ip->a + machine->global_offset].float_int = -machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_NEGATE_LG:
-			machine->stack[ip->a + machine->global_offset].float_int = -machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_NEGATE_GL:
-			machine->stack[ip->a].float_int = -machine->stack[ip->b + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_NEGATE_GG:
-			machine->stack[ip->a].float_int = -machine->stack[ip->b].float_int;
-			break;
-		case MACHINE_OP_CODE_LONG_INCREMENT_L:
-			++machine->stack[ip->a + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_INCREMENT_G:
-			++machine->stack[ip->a].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_DECREMENT_L:
-			--machine->stack[ip->a + machine->global_offset].long_int;
-			break;
-		case MACHINE_OP_CODE_LONG_DECREMENT_G:
-			--machine->stack[ip->a].long_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_INCREMENT_L:
-			++machine->stack[ip->a + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_INCREMENT_G:
-			++machine->stack[ip->a].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_DECREMENT_L:
-			--machine->stack[ip->a + machine->global_offset].float_int;
-			break;
-		case MACHINE_OP_CODE_FLOAT_DECREMENT_G:
-			--machine->stack[ip->a].float_int;
-			break;
-		case MACHINE_OP_CODE_ABORT:
+		MACHINE_CASE(FLOAT_MODULO_LLL):
+			frame[ip->c].float_int = fmod(frame[ip->a].float_int, frame[ip->b].float_int);
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MODULO_LLG):
+			stack[ip->c].float_int = fmod(frame[ip->a].float_int, frame[ip->b].float_int);
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MODULO_LGL):
+			frame[ip->c].float_int = fmod(frame[ip->a].float_int, stack[ip->b].float_int);
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MODULO_LGG):
+			stack[ip->c].float_int = fmod(frame[ip->a].float_int, stack[ip->b].float_int);
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MODULO_GLL):
+			frame[ip->c].float_int = fmod(stack[ip->a].float_int, frame[ip->b].float_int);
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MODULO_GLG):
+			stack[ip->c].float_int = fmod(stack[ip->a].float_int, frame[ip->b].float_int);
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MODULO_GGL):
+			frame[ip->c].float_int = fmod(stack[ip->a].float_int, stack[ip->b].float_int);
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_MODULO_GGG):
+			stack[ip->c].float_int = fmod(stack[ip->a].float_int, stack[ip->b].float_int);
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_EXPONENTIATE_LLL):
+			frame[ip->c].float_int = pow(frame[ip->a].float_int, frame[ip->b].float_int);
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_EXPONENTIATE_LLG):
+			stack[ip->c].float_int = pow(frame[ip->a].float_int, frame[ip->b].float_int);
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_EXPONENTIATE_LGL):
+			frame[ip->c].float_int = pow(frame[ip->a].float_int, stack[ip->b].float_int);
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_EXPONENTIATE_LGG):
+			stack[ip->c].float_int = pow(frame[ip->a].float_int, stack[ip->b].float_int);
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_EXPONENTIATE_GLL):
+			frame[ip->c].float_int = pow(stack[ip->a].float_int, frame[ip->b].float_int);
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_EXPONENTIATE_GLG):
+			stack[ip->c].float_int = pow(stack[ip->a].float_int, frame[ip->b].float_int);
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_EXPONENTIATE_GGL):
+			frame[ip->c].float_int = pow(stack[ip->a].float_int, stack[ip->b].float_int);
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_EXPONENTIATE_GGG):
+			stack[ip->c].float_int = pow(stack[ip->a].float_int, stack[ip->b].float_int);
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_NEGATE_LL):
+			frame[ip->a].long_int = -frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_NEGATE_LG):
+			frame[ip->a].long_int = -stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_NEGATE_GL):
+			stack[ip->a].long_int = -frame[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_NEGATE_GG):
+			stack[ip->a].long_int = -stack[ip->b].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_NEGATE_LL):
+			frame[ip->a].float_int = -frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_NEGATE_LG):
+			frame[ip->a].float_int = -stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_NEGATE_GL):
+			stack[ip->a].float_int = -frame[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_NEGATE_GG):
+			stack[ip->a].float_int = -stack[ip->b].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_INCREMENT_L):
+			++frame[ip->a].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_INCREMENT_G):
+			++stack[ip->a].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_DECREMENT_L):
+			--frame[ip->a].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(LONG_DECREMENT_G):
+			--stack[ip->a].long_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_INCREMENT_L):
+			++frame[ip->a].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_INCREMENT_G):
+			++stack[ip->a].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_DECREMENT_L):
+			--frame[ip->a].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(FLOAT_DECREMENT_G):
+			--stack[ip->a].float_int;
+			MACHINE_NEXT;
+		MACHINE_CASE(ABORT):
 			if (ip->a == ERROR_NONE)
 				return 1;
 			else
@@ -1529,45 +2254,45 @@ int machine_execute(machine_t* machine, machine_ins_t* instructions, machine_ins
 			machine_reg_t* a;
 			machine_reg_t* b;
 			machine_reg_t* c;
-		case MACHINE_OP_CODE_FOREIGN_LLL:
-			a = &machine->stack[ip->a + machine->global_offset];
-			b = &machine->stack[ip->b + machine->global_offset];
-			c = &machine->stack[ip->c + machine->global_offset];
+		MACHINE_CASE(FOREIGN_LLL):
+			a = &frame[ip->a];
+			b = &frame[ip->b];
+			c = &frame[ip->c];
 			goto invoke_foreign;
-		case MACHINE_OP_CODE_FOREIGN_LLG:
-			a = &machine->stack[ip->a + machine->global_offset];
-			b = &machine->stack[ip->b + machine->global_offset];
-			c = &machine->stack[ip->c];
+		MACHINE_CASE(FOREIGN_LLG):
+			a = &frame[ip->a];
+			b = &frame[ip->b];
+			c = &stack[ip->c];
 			goto invoke_foreign;
-		case MACHINE_OP_CODE_FOREIGN_LGL:
-			a = &machine->stack[ip->a + machine->global_offset];
-			b = &machine->stack[ip->b];
-			c = &machine->stack[ip->c + machine->global_offset];
+		MACHINE_CASE(FOREIGN_LGL):
+			a = &frame[ip->a];
+			b = &stack[ip->b];
+			c = &frame[ip->c];
 			goto invoke_foreign;
-		case MACHINE_OP_CODE_FOREIGN_LGG:
-			a = &machine->stack[ip->a + machine->global_offset];
-			b = &machine->stack[ip->b];
-			c = &machine->stack[ip->c];
+		MACHINE_CASE(FOREIGN_LGG):
+			a = &frame[ip->a];
+			b = &stack[ip->b];
+			c = &stack[ip->c];
 			goto invoke_foreign;
-		case MACHINE_OP_CODE_FOREIGN_GLL:
-			a = &machine->stack[ip->a];
-			b = &machine->stack[ip->b + machine->global_offset];
-			c = &machine->stack[ip->c + machine->global_offset];
+		MACHINE_CASE(FOREIGN_GLL):
+			a = &stack[ip->a];
+			b = &frame[ip->b];
+			c = &frame[ip->c];
 			goto invoke_foreign;
-		case MACHINE_OP_CODE_FOREIGN_GLG:
-			a = &machine->stack[ip->a];
-			b = &machine->stack[ip->b + machine->global_offset];
-			c = &machine->stack[ip->c];
+		MACHINE_CASE(FOREIGN_GLG):
+			a = &stack[ip->a];
+			b = &frame[ip->b];
+			c = &stack[ip->c];
 			goto invoke_foreign;
-		case MACHINE_OP_CODE_FOREIGN_GGL:
-			a = &machine->stack[ip->a];
-			b = &machine->stack[ip->b];
-			c = &machine->stack[ip->c + machine->global_offset];
+		MACHINE_CASE(FOREIGN_GGL):
+			a = &stack[ip->a];
+			b = &stack[ip->b];
+			c = &frame[ip->c];
 			goto invoke_foreign;
-		case MACHINE_OP_CODE_FOREIGN_GGG:
-			a = &machine->stack[ip->a];
-			b = &machine->stack[ip->b];
-			c = &machine->stack[ip->c];
+		MACHINE_CASE(FOREIGN_GGG):
+			a = &stack[ip->a];
+			b = &stack[ip->b];
+			c = &stack[ip->c];
 			goto invoke_foreign;
 		invoke_foreign:
 			if (!ffi_invoke(&machine->ffi_table, machine, a, b, c)) {
@@ -1576,276 +2301,342 @@ int machine_execute(machine_t* machine, machine_ins_t* instructions, machine_ins
 				else
 					MACHINE_PANIC(machine->last_err);
 			}
-			break;
+			MACHINE_NEXT;
 		}
 		{
 			heap_alloc_t* heap_alloc;
-		case MACHINE_OP_CODE_CONFIG_TYPESIG_L:
-			heap_alloc = machine->stack[ip->a + machine->global_offset].heap_alloc;
+		MACHINE_CASE(CONFIG_TYPESIG_L):
+			heap_alloc = frame[ip->a].heap_alloc;
 			goto final_config_typesig;
-		case MACHINE_OP_CODE_CONFIG_TYPESIG_G:
-			heap_alloc = machine->stack[ip->a].heap_alloc;
+		MACHINE_CASE(CONFIG_TYPESIG_G):
+			heap_alloc = stack[ip->a].heap_alloc;
 		final_config_typesig:
 			if (ip->c) {
-				MACHINE_PANIC_COND(heap_alloc->type_sig = malloc(sizeof(machine_type_sig_t)), ERROR_MEMORY);
-				MACHINE_ESCAPE_COND(atomize_heap_type_sig(machine, machine->defined_signatures[ip->b], heap_alloc->type_sig, 1));
+				machine_type_sig_t type_sig;
+				MACHINE_ESCAPE_COND(atomize_heap_type_sig(machine, machine->defined_signatures[ip->b], &type_sig, 1));
+				MACHINE_ESCAPE_COND(heap_alloc->type_sig = typesig_intern(machine, &type_sig, 1));
 			}
 			else
 				heap_alloc->type_sig = &machine->defined_signatures[ip->b];
-			break; 
+			MACHINE_NEXT; 
 		}
 
-		case MACHINE_OP_CODE_RUNTIME_TYPECHECK_LL:
-			machine->stack[ip->b + machine->global_offset].bool_flag = type_signature_match(machine, *machine->stack[ip->a + machine->global_offset].heap_alloc->type_sig, machine->defined_signatures[ip->c]);
-			break;
-		case MACHINE_OP_CODE_RUNTIME_TYPECHECK_LG:
-			machine->stack[ip->b].bool_flag = type_signature_match(machine, *machine->stack[ip->a + machine->global_offset].heap_alloc->type_sig, machine->defined_signatures[ip->c]);
-			break;
-		case MACHINE_OP_CODE_RUNTIME_TYPECHECK_GL:
-			machine->stack[ip->b + machine->global_offset].bool_flag = type_signature_match(machine, *machine->stack[ip->a].heap_alloc->type_sig, machine->defined_signatures[ip->c]);
-			break;
-		case MACHINE_OP_CODE_RUNTIME_TYPECHECK_GG:
-			machine->stack[ip->b].bool_flag = type_signature_match(machine, *machine->stack[ip->a].heap_alloc->type_sig, machine->defined_signatures[ip->c]);
-			break;
-		case MACHINE_OP_CODE_RUNTIME_TYPECAST_LL:
-			MACHINE_PANIC_COND(type_signature_match(machine, *machine->stack[ip->a + machine->global_offset].heap_alloc->type_sig, machine->defined_signatures[ip->c]), ERROR_UNEXPECTED_TYPE);
-			machine->stack[ip->b + machine->global_offset].heap_alloc = machine->stack[ip->a + machine->global_offset].heap_alloc;
-			break;
-		case MACHINE_OP_CODE_RUNTIME_TYPECAST_LG:
-			MACHINE_PANIC_COND(type_signature_match(machine, *machine->stack[ip->a + machine->global_offset].heap_alloc->type_sig, machine->defined_signatures[ip->c]), ERROR_UNEXPECTED_TYPE);
-			machine->stack[ip->b].heap_alloc = machine->stack[ip->a + machine->global_offset].heap_alloc;
-			break;
-		case MACHINE_OP_CODE_RUNTIME_TYPECAST_GL:
-			MACHINE_PANIC_COND(type_signature_match(machine, *machine->stack[ip->a].heap_alloc->type_sig, machine->defined_signatures[ip->c]), ERROR_UNEXPECTED_TYPE);
-			machine->stack[ip->b + machine->global_offset].heap_alloc = machine->stack[ip->a].heap_alloc;
-			break;
-		case MACHINE_OP_CODE_RUNTIME_TYPECAST_GG:
-			MACHINE_PANIC_COND(type_signature_match(machine, *machine->stack[ip->a].heap_alloc->type_sig, machine->defined_signatures[ip->c]), ERROR_UNEXPECTED_TYPE);
-			machine->stack[ip->b].heap_alloc = machine->stack[ip->a].heap_alloc;
-			break;
-		case MACHINE_OP_CODE_DYNAMIC_TYPECHECK_DD_L:
-			machine->stack[ip->a + machine->global_offset].bool_flag = type_signature_match(machine, 
+		MACHINE_CASE(RUNTIME_TYPECHECK_LL):
+			frame[ip->b].bool_flag = type_signature_match(machine, *frame[ip->a].heap_alloc->type_sig, machine->defined_signatures[ip->c]);
+			MACHINE_NEXT;
+		MACHINE_CASE(RUNTIME_TYPECHECK_LG):
+			stack[ip->b].bool_flag = type_signature_match(machine, *frame[ip->a].heap_alloc->type_sig, machine->defined_signatures[ip->c]);
+			MACHINE_NEXT;
+		MACHINE_CASE(RUNTIME_TYPECHECK_GL):
+			frame[ip->b].bool_flag = type_signature_match(machine, *stack[ip->a].heap_alloc->type_sig, machine->defined_signatures[ip->c]);
+			MACHINE_NEXT;
+		MACHINE_CASE(RUNTIME_TYPECHECK_GG):
+			stack[ip->b].bool_flag = type_signature_match(machine, *stack[ip->a].heap_alloc->type_sig, machine->defined_signatures[ip->c]);
+			MACHINE_NEXT;
+		MACHINE_CASE(RUNTIME_TYPECAST_LL):
+			MACHINE_PANIC_COND(type_signature_match(machine, *frame[ip->a].heap_alloc->type_sig, machine->defined_signatures[ip->c]), ERROR_UNEXPECTED_TYPE);
+			frame[ip->b].heap_alloc = frame[ip->a].heap_alloc;
+			MACHINE_NEXT;
+		MACHINE_CASE(RUNTIME_TYPECAST_LG):
+			MACHINE_PANIC_COND(type_signature_match(machine, *frame[ip->a].heap_alloc->type_sig, machine->defined_signatures[ip->c]), ERROR_UNEXPECTED_TYPE);
+			stack[ip->b].heap_alloc = frame[ip->a].heap_alloc;
+			MACHINE_NEXT;
+		MACHINE_CASE(RUNTIME_TYPECAST_GL):
+			MACHINE_PANIC_COND(type_signature_match(machine, *stack[ip->a].heap_alloc->type_sig, machine->defined_signatures[ip->c]), ERROR_UNEXPECTED_TYPE);
+			frame[ip->b].heap_alloc = stack[ip->a].heap_alloc;
+			MACHINE_NEXT;
+		MACHINE_CASE(RUNTIME_TYPECAST_GG):
+			MACHINE_PANIC_COND(type_signature_match(machine, *stack[ip->a].heap_alloc->type_sig, machine->defined_signatures[ip->c]), ERROR_UNEXPECTED_TYPE);
+			stack[ip->b].heap_alloc = stack[ip->a].heap_alloc;
+			MACHINE_NEXT;
+		MACHINE_CASE(DYNAMIC_TYPECHECK_DD_L):
+			frame[ip->a].bool_flag = type_signature_match(machine, 
 
-			machine->defined_signatures[machine->stack[ip->b + machine->global_offset].long_int].super_signature >= TYPE_SUPER_ARRAY ? 
-			*machine->stack[ip->a + machine->global_offset].heap_alloc->type_sig :
-			machine->defined_signatures[machine->stack[ip->b + machine->global_offset].long_int], 
+			machine->defined_signatures[frame[ip->b].long_int].super_signature >= TYPE_SUPER_ARRAY ? 
+			*frame[ip->a].heap_alloc->type_sig :
+			machine->defined_signatures[frame[ip->b].long_int], 
 				
-			machine->defined_signatures[machine->stack[ip->c + machine->global_offset].long_int]);
-			break;
-		case MACHINE_OP_CODE_DYNAMIC_TYPECHECK_DD_G:
-			machine->stack[ip->a].bool_flag = type_signature_match(machine,
+			machine->defined_signatures[frame[ip->c].long_int]);
+			MACHINE_NEXT;
+		MACHINE_CASE(DYNAMIC_TYPECHECK_DD_G):
+			stack[ip->a].bool_flag = type_signature_match(machine,
 
-			machine->defined_signatures[machine->stack[ip->b + machine->global_offset].long_int].super_signature >= TYPE_SUPER_ARRAY ?
-			*machine->stack[ip->a].heap_alloc->type_sig :
-			machine->defined_signatures[machine->stack[ip->b + machine->global_offset].long_int],
+			machine->defined_signatures[frame[ip->b].long_int].super_signature >= TYPE_SUPER_ARRAY ?
+			*stack[ip->a].heap_alloc->type_sig :
+			machine->defined_signatures[frame[ip->b].long_int],
 
-			machine->defined_signatures[machine->stack[ip->c + machine->global_offset].long_int]);
-			break;
-		case MACHINE_OP_CODE_DYNAMIC_TYPECHECK_DR_L:
-			machine->stack[ip->a + machine->global_offset].bool_flag = type_signature_match(machine,
+			machine->defined_signatures[frame[ip->c].long_int]);
+			MACHINE_NEXT;
+		MACHINE_CASE(DYNAMIC_TYPECHECK_DR_L):
+			frame[ip->a].bool_flag = type_signature_match(machine,
 
-			machine->defined_signatures[machine->stack[ip->b + machine->global_offset].long_int].super_signature >= TYPE_SUPER_ARRAY ?
-			*machine->stack[ip->a + machine->global_offset].heap_alloc->type_sig :
-			machine->defined_signatures[machine->stack[ip->b + machine->global_offset].long_int],
+			machine->defined_signatures[frame[ip->b].long_int].super_signature >= TYPE_SUPER_ARRAY ?
+			*frame[ip->a].heap_alloc->type_sig :
+			machine->defined_signatures[frame[ip->b].long_int],
 
 			machine->defined_signatures[ip->c]);
-			break;
-		case MACHINE_OP_CODE_DYNAMIC_TYPECHECK_DR_G:
-			machine->stack[ip->a].bool_flag = type_signature_match(machine,
+			MACHINE_NEXT;
+		MACHINE_CASE(DYNAMIC_TYPECHECK_DR_G):
+			stack[ip->a].bool_flag = type_signature_match(machine,
 
-			machine->defined_signatures[machine->stack[ip->b + machine->global_offset].long_int].super_signature >= TYPE_SUPER_ARRAY ?
-			*machine->stack[ip->a].heap_alloc->type_sig :
-			machine->defined_signatures[machine->stack[ip->b + machine->global_offset].long_int],
+			machine->defined_signatures[frame[ip->b].long_int].super_signature >= TYPE_SUPER_ARRAY ?
+			*stack[ip->a].heap_alloc->type_sig :
+			machine->defined_signatures[frame[ip->b].long_int],
 
 			machine->defined_signatures[ip->c]);
-			break;
-		case MACHINE_OP_CODE_DYNAMIC_TYPECHECK_RD_L:
-			machine->stack[ip->a + machine->global_offset].bool_flag = type_signature_match(machine, *machine->stack[ip->a + machine->global_offset].heap_alloc->type_sig, machine->defined_signatures[machine->stack[ip->b + machine->global_offset].long_int]);
-			break;
-		case MACHINE_OP_CODE_DYNAMIC_TYPECHECK_RD_G:
-			machine->stack[ip->a].bool_flag = type_signature_match(machine, *machine->stack[ip->a].heap_alloc->type_sig, machine->defined_signatures[machine->stack[ip->b + machine->global_offset].long_int]);
-			break;
-		case MACHINE_OP_CODE_DYNAMIC_TYPECAST_DD_L:
+			MACHINE_NEXT;
+		MACHINE_CASE(DYNAMIC_TYPECHECK_RD_L):
+			frame[ip->a].bool_flag = type_signature_match(machine, *frame[ip->a].heap_alloc->type_sig, machine->defined_signatures[frame[ip->b].long_int]);
+			MACHINE_NEXT;
+		MACHINE_CASE(DYNAMIC_TYPECHECK_RD_G):
+			stack[ip->a].bool_flag = type_signature_match(machine, *stack[ip->a].heap_alloc->type_sig, machine->defined_signatures[frame[ip->b].long_int]);
+			MACHINE_NEXT;
+		MACHINE_CASE(DYNAMIC_TYPECAST_DD_L):
 			MACHINE_PANIC_COND(type_signature_match(machine,
 
-			machine->defined_signatures[machine->stack[ip->b + machine->global_offset].long_int].super_signature >= TYPE_SUPER_ARRAY ?
-			*machine->stack[ip->a + machine->global_offset].heap_alloc->type_sig :
-			machine->defined_signatures[machine->stack[ip->b + machine->global_offset].long_int],
+			machine->defined_signatures[frame[ip->b].long_int].super_signature >= TYPE_SUPER_ARRAY ?
+			*frame[ip->a].heap_alloc->type_sig :
+			machine->defined_signatures[frame[ip->b].long_int],
 
-			machine->defined_signatures[machine->stack[ip->c + machine->global_offset].long_int]), ERROR_UNEXPECTED_TYPE);
-			break;
-		case MACHINE_OP_CODE_DYNAMIC_TYPECAST_DD_G:
+			machine->defined_signatures[frame[ip->c].long_int]), ERROR_UNEXPECTED_TYPE);
+			MACHINE_NEXT;
+		MACHINE_CASE(DYNAMIC_TYPECAST_DD_G):
 			MACHINE_PANIC_COND(type_signature_match(machine,
 
-			machine->defined_signatures[machine->stack[ip->b + machine->global_offset].long_int].super_signature >= TYPE_SUPER_ARRAY ?
-			*machine->stack[ip->a].heap_alloc->type_sig :
-			machine->defined_signatures[machine->stack[ip->b + machine->global_offset].long_int],
+			machine->defined_signatures[frame[ip->b].long_int].super_signature >= TYPE_SUPER_ARRAY ?
+			*stack[ip->a].heap_alloc->type_sig :
+			machine->defined_signatures[frame[ip->b].long_int],
 
-			machine->defined_signatures[machine->stack[ip->c + machine->global_offset].long_int]), ERROR_UNEXPECTED_TYPE);
-			break;
-		case MACHINE_OP_CODE_DYNAMIC_TYPECAST_DR_L:
+			machine->defined_signatures[frame[ip->c].long_int]), ERROR_UNEXPECTED_TYPE);
+			MACHINE_NEXT;
+		MACHINE_CASE(DYNAMIC_TYPECAST_DR_L):
 			MACHINE_PANIC_COND(type_signature_match(machine,
 
-			machine->defined_signatures[machine->stack[ip->b + machine->global_offset].long_int].super_signature >= TYPE_SUPER_ARRAY ?
-			*machine->stack[ip->a + machine->global_offset].heap_alloc->type_sig :
-			machine->defined_signatures[machine->stack[ip->b + machine->global_offset].long_int],
+			machine->defined_signatures[frame[ip->b].long_int].super_signature >= TYPE_SUPER_ARRAY ?
+			*frame[ip->a].heap_alloc->type_sig :
+			machine->defined_signatures[frame[ip->b].long_int],
 
 			machine->defined_signatures[ip->c]), ERROR_UNEXPECTED_TYPE);
-			break;
-		case MACHINE_OP_CODE_DYNAMIC_TYPECAST_DR_G:
+			MACHINE_NEXT;
+		MACHINE_CASE(DYNAMIC_TYPECAST_DR_G):
 			MACHINE_PANIC_COND(type_signature_match(machine,
 
-			machine->defined_signatures[machine->stack[ip->b + machine->global_offset].long_int].super_signature >= TYPE_SUPER_ARRAY ?
-			*machine->stack[ip->a].heap_alloc->type_sig :
-			machine->defined_signatures[machine->stack[ip->b + machine->global_offset].long_int],
+			machine->defined_signatures[frame[ip->b].long_int].super_signature >= TYPE_SUPER_ARRAY ?
+			*stack[ip->a].heap_alloc->type_sig :
+			machine->defined_signatures[frame[ip->b].long_int],
 
 			machine->defined_signatures[ip->c]), ERROR_UNEXPECTED_TYPE);
-			break;
-		case MACHINE_OP_CODE_DYNAMIC_TYPECAST_RD_L:
-			MACHINE_PANIC_COND(type_signature_match(machine, *machine->stack[ip->a + machine->global_offset].heap_alloc->type_sig, machine->defined_signatures[machine->stack[ip->b + machine->global_offset].long_int]), ERROR_UNEXPECTED_TYPE);
-			break;
-		case MACHINE_OP_CODE_DYNAMIC_TYPECAST_RD_G:
-			MACHINE_PANIC_COND(type_signature_match(machine, *machine->stack[ip->a].heap_alloc->type_sig, machine->defined_signatures[machine->stack[ip->b + machine->global_offset].long_int]), ERROR_UNEXPECTED_TYPE);
-			break;
+			MACHINE_NEXT;
+		MACHINE_CASE(DYNAMIC_TYPECAST_RD_L):
+			MACHINE_PANIC_COND(type_signature_match(machine, *frame[ip->a].heap_alloc->type_sig, machine->defined_signatures[frame[ip->b].long_int]), ERROR_UNEXPECTED_TYPE);
+			MACHINE_NEXT;
+		MACHINE_CASE(DYNAMIC_TYPECAST_RD_G):
+			MACHINE_PANIC_COND(type_signature_match(machine, *stack[ip->a].heap_alloc->type_sig, machine->defined_signatures[frame[ip->b].long_int]), ERROR_UNEXPECTED_TYPE);
+			MACHINE_NEXT;
 		{
 			heap_alloc_t* array_register;
 			heap_alloc_t* assign_value;
-		case MACHINE_OP_CODE_TYPEGUARD_PROTECT_ARRAY_LL:
-			array_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
-			assign_value = machine->stack[ip->b + machine->global_offset].heap_alloc;
+		MACHINE_CASE(TYPEGUARD_PROTECT_ARRAY_LL):
+			array_register = frame[ip->a].heap_alloc;
+			assign_value = frame[ip->b].heap_alloc;
 			goto typeguard_protect_array;
-		case MACHINE_OP_CODE_TYPEGUARD_PROTECT_ARRAY_LG:
-			array_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
-			assign_value = machine->stack[ip->b].heap_alloc;
+		MACHINE_CASE(TYPEGUARD_PROTECT_ARRAY_LG):
+			array_register = frame[ip->a].heap_alloc;
+			assign_value = stack[ip->b].heap_alloc;
 			goto typeguard_protect_array;
-		case MACHINE_OP_CODE_TYPEGUARD_PROTECT_ARRAY_GL:
-			array_register = machine->stack[ip->a].heap_alloc;
-			assign_value = machine->stack[ip->b + machine->global_offset].heap_alloc;
+		MACHINE_CASE(TYPEGUARD_PROTECT_ARRAY_GL):
+			array_register = stack[ip->a].heap_alloc;
+			assign_value = frame[ip->b].heap_alloc;
 			goto typeguard_protect_array;
-		case MACHINE_OP_CODE_TYPEGUARD_PROTECT_ARRAY_GG:
-			array_register = machine->stack[ip->a].heap_alloc;
-			assign_value = machine->stack[ip->b].heap_alloc;
+		MACHINE_CASE(TYPEGUARD_PROTECT_ARRAY_GG):
+			array_register = stack[ip->a].heap_alloc;
+			assign_value = stack[ip->b].heap_alloc;
 		typeguard_protect_array:
 			if(array_register->type_sig->sub_types->super_signature >= TYPE_SUPER_ARRAY)
 				MACHINE_PANIC_COND(type_signature_match(machine, *assign_value->type_sig, *array_register->type_sig->sub_types), ERROR_UNEXPECTED_TYPE);
-			break;
+			MACHINE_NEXT;
 		}
 		{
 			heap_alloc_t* record_register;
 			heap_alloc_t* assign_value;
-		case MACHINE_OP_CODE_TYPEGUARD_PROTECT_TYPEARG_PROPERTY_LL:
-			record_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
-			assign_value = machine->stack[ip->b + machine->global_offset].heap_alloc;
+		MACHINE_CASE(TYPEGUARD_PROTECT_TYPEARG_PROPERTY_LL):
+			record_register = frame[ip->a].heap_alloc;
+			assign_value = frame[ip->b].heap_alloc;
 			goto typeguard_protect_typearg_property;
-		case MACHINE_OP_CODE_TYPEGUARD_PROTECT_TYPEARG_PROPERTY_LG:
-			record_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
-			assign_value = machine->stack[ip->b].heap_alloc;
+		MACHINE_CASE(TYPEGUARD_PROTECT_TYPEARG_PROPERTY_LG):
+			record_register = frame[ip->a].heap_alloc;
+			assign_value = stack[ip->b].heap_alloc;
 			goto typeguard_protect_typearg_property;
-		case MACHINE_OP_CODE_TYPEGUARD_PROTECT_TYPEARG_PROPERTY_GL:
-			record_register = machine->stack[ip->a].heap_alloc;
-			assign_value = machine->stack[ip->b + machine->global_offset].heap_alloc;
+		MACHINE_CASE(TYPEGUARD_PROTECT_TYPEARG_PROPERTY_GL):
+			record_register = stack[ip->a].heap_alloc;
+			assign_value = frame[ip->b].heap_alloc;
 			goto typeguard_protect_typearg_property;
-		case MACHINE_OP_CODE_TYPEGUARD_PROTECT_TYPEARG_PROPERTY_GG:
-			record_register = machine->stack[ip->a].heap_alloc;
-			assign_value = machine->stack[ip->b].heap_alloc;
+		MACHINE_CASE(TYPEGUARD_PROTECT_TYPEARG_PROPERTY_GG):
+			record_register = stack[ip->a].heap_alloc;
+			assign_value = stack[ip->b].heap_alloc;
 		typeguard_protect_typearg_property:
 			if(record_register->type_sig->sub_types[ip->c].super_signature >= TYPE_SUPER_ARRAY)
 				MACHINE_PANIC_COND(type_signature_match(machine, *assign_value->type_sig, record_register->type_sig->sub_types[ip->c]), ERROR_UNEXPECTED_TYPE);
-			break;
+			MACHINE_NEXT;
 		}
 		{
 			heap_alloc_t* record_register;
 			heap_alloc_t* assign_value;
 			machine_type_sig_t req_sig;
-		case MACHINE_OP_CODE_TYPEGUARD_PROTECT_TYPEARG_PROPERTY_DOWNCAST_LL:
-			record_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
-			assign_value = machine->stack[ip->b + machine->global_offset].heap_alloc;
+		MACHINE_CASE(TYPEGUARD_PROTECT_TYPEARG_PROPERTY_DOWNCAST_LL):
+			record_register = frame[ip->a].heap_alloc;
+			assign_value = frame[ip->b].heap_alloc;
 			goto typeguard_protect_typearg_property_downcast;
-		case MACHINE_OP_CODE_TYPEGUARD_PROTECT_TYPEARG_PROPERTY_DOWNCAST_LG:
-			record_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
-			assign_value = machine->stack[ip->b].heap_alloc;
+		MACHINE_CASE(TYPEGUARD_PROTECT_TYPEARG_PROPERTY_DOWNCAST_LG):
+			record_register = frame[ip->a].heap_alloc;
+			assign_value = stack[ip->b].heap_alloc;
 			goto typeguard_protect_typearg_property_downcast;
-		case MACHINE_OP_CODE_TYPEGUARD_PROTECT_TYPEARG_PROPERTY_DOWNCAST_GL:
-			record_register = machine->stack[ip->a].heap_alloc;
-			assign_value = machine->stack[ip->b + machine->global_offset].heap_alloc;
+		MACHINE_CASE(TYPEGUARD_PROTECT_TYPEARG_PROPERTY_DOWNCAST_GL):
+			record_register = stack[ip->a].heap_alloc;
+			assign_value = frame[ip->b].heap_alloc;
 			goto typeguard_protect_typearg_property_downcast;
-		case MACHINE_OP_CODE_TYPEGUARD_PROTECT_TYPEARG_PROPERTY_DOWNCAST_GG:
-			record_register = machine->stack[ip->a].heap_alloc;
-			assign_value = machine->stack[ip->b].heap_alloc;
+		MACHINE_CASE(TYPEGUARD_PROTECT_TYPEARG_PROPERTY_DOWNCAST_GG):
+			record_register = stack[ip->a].heap_alloc;
+			assign_value = stack[ip->b].heap_alloc;
 		typeguard_protect_typearg_property_downcast:
 			MACHINE_PANIC_COND(atomize_heap_type_sig(machine, *record_register->type_sig, &req_sig, 1), ERROR_MEMORY);
 			MACHINE_PANIC_COND(downcast_type_signature(machine, &req_sig, machine->extra_a), ERROR_MEMORY);
 
-			if (req_sig.sub_types[ip->c].super_signature >= TYPE_SUPER_ARRAY && !type_signature_match(machine, *assign_value->type_sig, req_sig.sub_types[ip->c])) {
-				free_type_signature(&req_sig);
+			if (req_sig.sub_types[ip->c].super_signature >= TYPE_SUPER_ARRAY && !type_signature_match(machine, *assign_value->type_sig, req_sig.sub_types[ip->c]))
 				MACHINE_PANIC(ERROR_UNEXPECTED_TYPE);
-			}
-			free_type_signature(&req_sig);
-			break;
+			MACHINE_NEXT;
 		}
 		{
 			heap_alloc_t* record_register;
 			heap_alloc_t* assign_value;
 			machine_type_sig_t property_type_sig;
-		case MACHINE_OP_CODE_TYPEGUARD_PROTECT_SUB_PROPERTY_LL:
-			record_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
-			assign_value = machine->stack[ip->b + machine->global_offset].heap_alloc;
+		MACHINE_CASE(TYPEGUARD_PROTECT_SUB_PROPERTY_LL):
+			record_register = frame[ip->a].heap_alloc;
+			assign_value = frame[ip->b].heap_alloc;
 			goto typearg_protect_sub_property;
-		case MACHINE_OP_CODE_TYPEGUARD_PROTECT_SUB_PROPERTY_LG:
-			record_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
-			assign_value = machine->stack[ip->b].heap_alloc;
+		MACHINE_CASE(TYPEGUARD_PROTECT_SUB_PROPERTY_LG):
+			record_register = frame[ip->a].heap_alloc;
+			assign_value = stack[ip->b].heap_alloc;
 			goto typearg_protect_sub_property;
-		case MACHINE_OP_CODE_TYPEGUARD_PROTECT_SUB_PROPERTY_GL:
-			record_register = machine->stack[ip->a].heap_alloc;
-			assign_value = machine->stack[ip->b + machine->global_offset].heap_alloc;
+		MACHINE_CASE(TYPEGUARD_PROTECT_SUB_PROPERTY_GL):
+			record_register = stack[ip->a].heap_alloc;
+			assign_value = frame[ip->b].heap_alloc;
 			goto typearg_protect_sub_property;
-		case MACHINE_OP_CODE_TYPEGUARD_PROTECT_SUB_PROPERTY_GG:
-			record_register = machine->stack[ip->a].heap_alloc;
-			assign_value = machine->stack[ip->b].heap_alloc;
+		MACHINE_CASE(TYPEGUARD_PROTECT_SUB_PROPERTY_GG):
+			record_register = stack[ip->a].heap_alloc;
+			assign_value = stack[ip->b].heap_alloc;
 		typearg_protect_sub_property:
-			MACHINE_PANIC_COND(atomize_heap_type_sig(machine, machine->defined_signatures[ip->c], &property_type_sig, 0), ERROR_MEMORY);
-			MACHINE_PANIC_COND(get_super_type(machine, record_register->type_sig->sub_types, &property_type_sig), ERROR_MEMORY);
-			if (!type_signature_match(machine, *assign_value->type_sig, property_type_sig)) {
-				free_type_signature(&property_type_sig);
+			MACHINE_PANIC_COND(get_super_type(machine, record_register->type_sig->sub_types, machine->defined_signatures[ip->c], &property_type_sig), ERROR_MEMORY);
+			if (!type_signature_match(machine, *assign_value->type_sig, property_type_sig))
 				MACHINE_PANIC(ERROR_UNEXPECTED_TYPE);
-			}
-			free_type_signature(&property_type_sig);
-			break;
+			MACHINE_NEXT;
 		}
 		{
 			heap_alloc_t* record_register;
 			heap_alloc_t* assign_value;
 			machine_type_sig_t property_type_sig;
 			machine_type_sig_t req_sig;
-		case MACHINE_OP_CODE_TYPEGUARD_PROTECT_SUB_PROPERTY_DOWNCAST_LL:
-			record_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
-			assign_value = machine->stack[ip->b + machine->global_offset].heap_alloc;
+		MACHINE_CASE(TYPEGUARD_PROTECT_SUB_PROPERTY_DOWNCAST_LL):
+			record_register = frame[ip->a].heap_alloc;
+			assign_value = frame[ip->b].heap_alloc;
 			goto typearg_protect_sub_property_downcast;
-		case MACHINE_OP_CODE_TYPEGUARD_PROTECT_SUB_PROPERTY_DOWNCAST_LG:
-			record_register = machine->stack[ip->a + machine->global_offset].heap_alloc;
-			assign_value = machine->stack[ip->b].heap_alloc;
+		MACHINE_CASE(TYPEGUARD_PROTECT_SUB_PROPERTY_DOWNCAST_LG):
+			record_register = frame[ip->a].heap_alloc;
+			assign_value = stack[ip->b].heap_alloc;
 			goto typearg_protect_sub_property_downcast;
-		case MACHINE_OP_CODE_TYPEGUARD_PROTECT_SUB_PROPERTY_DOWNCAST_GL:
-			record_register = machine->stack[ip->a].heap_alloc;
-			assign_value = machine->stack[ip->b + machine->global_offset].heap_alloc;
+		MACHINE_CASE(TYPEGUARD_PROTECT_SUB_PROPERTY_DOWNCAST_GL):
+			record_register = stack[ip->a].heap_alloc;
+			assign_value = frame[ip->b].heap_alloc;
 			goto typearg_protect_sub_property_downcast;
-		case MACHINE_OP_CODE_TYPEGUARD_PROTECT_SUB_PROPERTY_DOWNCAST_GG:
-			record_register = machine->stack[ip->a].heap_alloc;
-			assign_value = machine->stack[ip->b].heap_alloc;
+		MACHINE_CASE(TYPEGUARD_PROTECT_SUB_PROPERTY_DOWNCAST_GG):
+			record_register = stack[ip->a].heap_alloc;
+			assign_value = stack[ip->b].heap_alloc;
 		typearg_protect_sub_property_downcast:
 			MACHINE_PANIC_COND(atomize_heap_type_sig(machine, *record_register->type_sig, &req_sig, 1), ERROR_MEMORY);
 			MACHINE_PANIC_COND(downcast_type_signature(machine, &req_sig, machine->extra_a), ERROR_MEMORY);
 
-			MACHINE_PANIC_COND(atomize_heap_type_sig(machine, machine->defined_signatures[ip->c], &property_type_sig, 0), ERROR_MEMORY);
-			MACHINE_PANIC_COND(get_super_type(machine, req_sig.sub_types, &property_type_sig), ERROR_MEMORY);
-			if (!type_signature_match(machine, *assign_value->type_sig, property_type_sig)) {
-				free_type_signature(&property_type_sig);
-				free_type_signature(&req_sig);
+			MACHINE_PANIC_COND(get_super_type(machine, req_sig.sub_types, machine->defined_signatures[ip->c], &property_type_sig), ERROR_MEMORY);
+			if (!type_signature_match(machine, *assign_value->type_sig, property_type_sig))
 				MACHINE_PANIC(ERROR_UNEXPECTED_TYPE);
-			}
-			free_type_signature(&property_type_sig);
-			free_type_signature(&req_sig);
-			break;
+			MACHINE_NEXT;
+		}
+
+		MACHINE_COMPARE_JUMP_CHECK(LONG_EQUAL, long_int, ==)
+		MACHINE_COMPARE_JUMP_CHECK(FLOAT_EQUAL, float_int, ==)
+		MACHINE_COMPARE_JUMP_CHECK(LONG_MORE, long_int, >)
+		MACHINE_COMPARE_JUMP_CHECK(LONG_LESS, long_int, <)
+		MACHINE_COMPARE_JUMP_CHECK(LONG_MORE_EQUAL, long_int, >=)
+		MACHINE_COMPARE_JUMP_CHECK(LONG_LESS_EQUAL, long_int, <=)
+		MACHINE_COMPARE_JUMP_CHECK(FLOAT_MORE, float_int, >)
+		MACHINE_COMPARE_JUMP_CHECK(FLOAT_LESS, float_int, <)
+		MACHINE_COMPARE_JUMP_CHECK(FLOAT_MORE_EQUAL, float_int, >=)
+		MACHINE_COMPARE_JUMP_CHECK(FLOAT_LESS_EQUAL, float_int, <=)
+
+		MACHINE_STEP_COMPARE_JUMP(LONG_INCREMENT_LESS_JUMP, ++, <)
+		MACHINE_STEP_COMPARE_JUMP(LONG_INCREMENT_LESS_EQUAL_JUMP, ++, <=)
+		MACHINE_STEP_COMPARE_JUMP(LONG_DECREMENT_MORE_JUMP, --, >)
+		MACHINE_STEP_COMPARE_JUMP(LONG_DECREMENT_MORE_EQUAL_JUMP, --, >=)
+		{
+			heap_alloc_t* array_register;
+			int64_t index_register;
+			machine_reg_t* dest_reg;
+		MACHINE_CASE(LOAD_ALLOC_LONG_ADD_LLL):
+		MACHINE_CASE(LOAD_ALLOC_FLOAT_ADD_LLL):
+			array_register = frame[ip->a].heap_alloc;
+			index_register = frame[ip->b].long_int;
+			dest_reg = &frame[ip->c];
+			goto load_alloc_add;
+		MACHINE_CASE(LOAD_ALLOC_LONG_ADD_LLG):
+		MACHINE_CASE(LOAD_ALLOC_FLOAT_ADD_LLG):
+			array_register = frame[ip->a].heap_alloc;
+			index_register = frame[ip->b].long_int;
+			dest_reg = &stack[ip->c];
+			goto load_alloc_add;
+		MACHINE_CASE(LOAD_ALLOC_LONG_ADD_LGL):
+		MACHINE_CASE(LOAD_ALLOC_FLOAT_ADD_LGL):
+			array_register = frame[ip->a].heap_alloc;
+			index_register = stack[ip->b].long_int;
+			dest_reg = &frame[ip->c];
+			goto load_alloc_add;
+		MACHINE_CASE(LOAD_ALLOC_LONG_ADD_LGG):
+		MACHINE_CASE(LOAD_ALLOC_FLOAT_ADD_LGG):
+			array_register = frame[ip->a].heap_alloc;
+			index_register = stack[ip->b].long_int;
+			dest_reg = &stack[ip->c];
+			goto load_alloc_add;
+		MACHINE_CASE(LOAD_ALLOC_LONG_ADD_GLL):
+		MACHINE_CASE(LOAD_ALLOC_FLOAT_ADD_GLL):
+			array_register = stack[ip->a].heap_alloc;
+			index_register = frame[ip->b].long_int;
+			dest_reg = &frame[ip->c];
+			goto load_alloc_add;
+		MACHINE_CASE(LOAD_ALLOC_LONG_ADD_GLG):
+		MACHINE_CASE(LOAD_ALLOC_FLOAT_ADD_GLG):
+			array_register = stack[ip->a].heap_alloc;
+			index_register = frame[ip->b].long_int;
+			dest_reg = &stack[ip->c];
+			goto load_alloc_add;
+		MACHINE_CASE(LOAD_ALLOC_LONG_ADD_GGL):
+		MACHINE_CASE(LOAD_ALLOC_FLOAT_ADD_GGL):
+			array_register = stack[ip->a].heap_alloc;
+			index_register = stack[ip->b].long_int;
+			dest_reg = &frame[ip->c];
+			goto load_alloc_add;
+		MACHINE_CASE(LOAD_ALLOC_LONG_ADD_GGG):
+		MACHINE_CASE(LOAD_ALLOC_FLOAT_ADD_GGG):
+			array_register = stack[ip->a].heap_alloc;
+			index_register = stack[ip->b].long_int;
+			dest_reg = &stack[ip->c];
+		load_alloc_add:
+			if (index_register < 0 || index_register >= array_register->limit)
+				MACHINE_PANIC(ERROR_INDEX_OUT_OF_RANGE);
+			if (!HEAP_BIT(array_register->init_stat, index_register))
+				MACHINE_PANIC(ERROR_READ_UNINIT);
+			if (ip->op_code >= MACHINE_OP_CODE_LOAD_ALLOC_FLOAT_ADD_LLL)
+				dest_reg->float_int += array_register->registers[index_register].float_int;
+			else
+				dest_reg->long_int += array_register->registers[index_register].long_int;
+			MACHINE_SKIP_FUSED;
 		}
 
 		}
@@ -1855,4 +2646,13 @@ int machine_execute(machine_t* machine, machine_ins_t* instructions, machine_ins
 }
 #undef MACHINE_PANIC_COND
 #undef MACHINE_PANIC
+#undef MACHINE_HALT_CHECK
+#undef MACHINE_CASE
+#undef MACHINE_DISPATCH
+#undef MACHINE_NEXT
+#undef MACHINE_JUMP
+#undef MACHINE_COUNT_DISPATCH
+#undef MACHINE_SKIP_FUSED
+#undef MACHINE_COMPARE_JUMP_CHECK
+#undef MACHINE_STEP_COMPARE_JUMP
 #undef MACHINE_ESCAPE_COND
\ No newline at end of file
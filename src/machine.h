@@ -9,101 +9,131 @@
 
 typedef union machine_register machine_reg_t;
 
-#define DECL3OP(OPCODE) MACHINE_OP_CODE_##OPCODE##_LLL,MACHINE_OP_CODE_##OPCODE##_LLG,MACHINE_OP_CODE_##OPCODE##_LGL,MACHINE_OP_CODE_##OPCODE##_LGG,MACHINE_OP_CODE_##OPCODE##_GLL,MACHINE_OP_CODE_##OPCODE##_GLG,MACHINE_OP_CODE_##OPCODE##_GGL, MACHINE_OP_CODE_##OPCODE##_GGG
+//default limits on the registers the stack may grow to and on how deep calls may nest. Both grow on demand up to these
+#define MACHINE_DEFAULT_STACK_SIZE (1 << 22)
+#define MACHINE_DEFAULT_FRAME_LIMIT (1 << 16)
+#define MACHINE_INITIAL_FRAME_LIMIT 1000
+//native stack left over for the runtime and natives when code that makes a native call per Cish call runs on its own stack
+#define MACHINE_NATIVE_STACK_RESERVE (1 << 23)
 
-#define DECL2OP(OPCODE) MACHINE_OP_CODE_##OPCODE##_LL, MACHINE_OP_CODE_##OPCODE##_LG, MACHINE_OP_CODE_##OPCODE##_GL, MACHINE_OP_CODE_##OPCODE##_GG
+#define MACHINE_DECL3OP(DECLOP, OPCODE) DECLOP(OPCODE##_LLL) DECLOP(OPCODE##_LLG) DECLOP(OPCODE##_LGL) DECLOP(OPCODE##_LGG) DECLOP(OPCODE##_GLL) DECLOP(OPCODE##_GLG) DECLOP(OPCODE##_GGL) DECLOP(OPCODE##_GGG)
 
-#define DECL1OP(OPCODE) MACHINE_OP_CODE_##OPCODE##_L, MACHINE_OP_CODE_##OPCODE##_G
+#define MACHINE_DECL2OP(DECLOP, OPCODE) DECLOP(OPCODE##_LL) DECLOP(OPCODE##_LG) DECLOP(OPCODE##_GL) DECLOP(OPCODE##_GG)
 
+#define MACHINE_DECL1OP(DECLOP, OPCODE) DECLOP(OPCODE##_L) DECLOP(OPCODE##_G)
+
+//every opcode, in encoding order. DECLOP is applied to each opcode name (without the MACHINE_OP_CODE_ prefix)
+#define MACHINE_OP_CODES(DECLOP) \
+	DECLOP(ABORT) \
+	MACHINE_DECL3OP(DECLOP, FOREIGN) \
+	MACHINE_DECL2OP(DECLOP, MOVE) \
+	DECLOP(SET_L) \
+	DECLOP(POP_ATOM_TYPESIGS) \
+	DECLOP(JUMP) \
+	MACHINE_DECL1OP(DECLOP, JUMP_CHECK) \
+	MACHINE_DECL1OP(DECLOP, CALL) \
+	DECLOP(RETURN) \
+	DECLOP(STACK_VALIDATE) \
+	MACHINE_DECL1OP(DECLOP, LABEL) \
+	MACHINE_DECL3OP(DECLOP, LOAD_ALLOC) \
+	MACHINE_DECL2OP(DECLOP, LOAD_ALLOC_I) \
+	MACHINE_DECL2OP(DECLOP, LOAD_ALLOC_I_BOUND) \
+	MACHINE_DECL3OP(DECLOP, STORE_ALLOC) \
+	MACHINE_DECL2OP(DECLOP, STORE_ALLOC_I) \
+	MACHINE_DECL2OP(DECLOP, STORE_ALLOC_I_BOUND) \
+	MACHINE_DECL1OP(DECLOP, CONF_TRACE) \
+	DECLOP(DYNAMIC_CONF_LL) \
+	DECLOP(DYNAMIC_CONF_ALL_LL) \
+	DECLOP(STACK_OFFSET) \
+	DECLOP(STACK_DEOFFSET) \
+	MACHINE_DECL2OP(DECLOP, ALLOC) \
+	MACHINE_DECL1OP(DECLOP, ALLOC_I) \
+	MACHINE_DECL1OP(DECLOP, FREE) \
+	DECLOP(DYNAMIC_FREE_LL) \
+	DECLOP(GC_NEW_FRAME) \
+	MACHINE_DECL1OP(DECLOP, GC_TRACE) \
+	DECLOP(DYNAMIC_TRACE_LL) \
+	DECLOP(GC_CLEAN) \
+	MACHINE_DECL3OP(DECLOP, AND) \
+	MACHINE_DECL3OP(DECLOP, OR) \
+	MACHINE_DECL2OP(DECLOP, NOT) \
+	MACHINE_DECL2OP(DECLOP, LENGTH) \
+	MACHINE_DECL3OP(DECLOP, PTR_EQUAL) \
+	MACHINE_DECL3OP(DECLOP, BOOL_EQUAL) \
+	MACHINE_DECL3OP(DECLOP, CHAR_EQUAL) \
+	MACHINE_DECL3OP(DECLOP, LONG_EQUAL) \
+	MACHINE_DECL3OP(DECLOP, FLOAT_EQUAL) \
+	MACHINE_DECL3OP(DECLOP, LONG_MORE) \
+	MACHINE_DECL3OP(DECLOP, LONG_LESS) \
+	MACHINE_DECL3OP(DECLOP, LONG_MORE_EQUAL) \
+	MACHINE_DECL3OP(DECLOP, LONG_LESS_EQUAL) \
+	MACHINE_DECL3OP(DECLOP, LONG_ADD) \
+	MACHINE_DECL3OP(DECLOP, LONG_SUBTRACT) \
+	MACHINE_DECL3OP(DECLOP, LONG_MULTIPLY) \
+	MACHINE_DECL3OP(DECLOP, LONG_DIVIDE) \
+	MACHINE_DECL3OP(DECLOP, LONG_MODULO) \
+	MACHINE_DECL3OP(DECLOP, LONG_EXPONENTIATE) \
+	MACHINE_DECL3OP(DECLOP, FLOAT_MORE) \
+	MACHINE_DECL3OP(DECLOP, FLOAT_LESS) \
+	MACHINE_DECL3OP(DECLOP, FLOAT_MORE_EQUAL) \
+	MACHINE_DECL3OP(DECLOP, FLOAT_LESS_EQUAL) \
+	MACHINE_DECL3OP(DECLOP, FLOAT_ADD) \
+	MACHINE_DECL3OP(DECLOP, FLOAT_SUBTRACT) \
+	MACHINE_DECL3OP(DECLOP, FLOAT_MULTIPLY) \
+	MACHINE_DECL3OP(DECLOP, FLOAT_DIVIDE) \
+	MACHINE_DECL3OP(DECLOP, FLOAT_MODULO) \
+	MACHINE_DECL3OP(DECLOP, FLOAT_EXPONENTIATE) \
+	MACHINE_DECL2OP(DECLOP, LONG_NEGATE) \
+	MACHINE_DECL2OP(DECLOP, FLOAT_NEGATE) \
+	MACHINE_DECL1OP(DECLOP, LONG_INCREMENT) \
+	MACHINE_DECL1OP(DECLOP, LONG_DECREMENT) \
+	MACHINE_DECL1OP(DECLOP, FLOAT_INCREMENT) \
+	MACHINE_DECL1OP(DECLOP, FLOAT_DECREMENT) \
+	MACHINE_DECL1OP(DECLOP, CONFIG_TYPESIG) \
+	MACHINE_DECL2OP(DECLOP, RUNTIME_TYPECHECK) \
+	MACHINE_DECL2OP(DECLOP, RUNTIME_TYPECAST) \
+	MACHINE_DECL1OP(DECLOP, DYNAMIC_TYPECHECK_DD) \
+	MACHINE_DECL1OP(DECLOP, DYNAMIC_TYPECHECK_DR) \
+	MACHINE_DECL1OP(DECLOP, DYNAMIC_TYPECHECK_RD) \
+	MACHINE_DECL1OP(DECLOP, DYNAMIC_TYPECAST_DD) \
+	MACHINE_DECL1OP(DECLOP, DYNAMIC_TYPECAST_DR) \
+	MACHINE_DECL1OP(DECLOP, DYNAMIC_TYPECAST_RD) \
+	MACHINE_DECL2OP(DECLOP, TYPEGUARD_PROTECT_ARRAY) \
+	MACHINE_DECL2OP(DECLOP, TYPEGUARD_PROTECT_TYPEARG_PROPERTY) \
+	MACHINE_DECL2OP(DECLOP, TYPEGUARD_PROTECT_TYPEARG_PROPERTY_DOWNCAST) \
+	MACHINE_DECL2OP(DECLOP, TYPEGUARD_PROTECT_SUB_PROPERTY) \
+	MACHINE_DECL2OP(DECLOP, TYPEGUARD_PROTECT_SUB_PROPERTY_DOWNCAST) \
+	DECLOP(SET_EXTRA_ARGS) \
+	MACHINE_DECL2OP(DECLOP, LONG_EQUAL_JUMP_CHECK) \
+	MACHINE_DECL2OP(DECLOP, FLOAT_EQUAL_JUMP_CHECK) \
+	MACHINE_DECL2OP(DECLOP, LONG_MORE_JUMP_CHECK) \
+	MACHINE_DECL2OP(DECLOP, LONG_LESS_JUMP_CHECK) \
+	MACHINE_DECL2OP(DECLOP, LONG_MORE_EQUAL_JUMP_CHECK) \
+	MACHINE_DECL2OP(DECLOP, LONG_LESS_EQUAL_JUMP_CHECK) \
+	MACHINE_DECL2OP(DECLOP, FLOAT_MORE_JUMP_CHECK) \
+	MACHINE_DECL2OP(DECLOP, FLOAT_LESS_JUMP_CHECK) \
+	MACHINE_DECL2OP(DECLOP, FLOAT_MORE_EQUAL_JUMP_CHECK) \
+	MACHINE_DECL2OP(DECLOP, FLOAT_LESS_EQUAL_JUMP_CHECK) \
+	MACHINE_DECL2OP(DECLOP, LONG_INCREMENT_LESS_JUMP) \
+	MACHINE_DECL2OP(DECLOP, LONG_INCREMENT_LESS_EQUAL_JUMP) \
+	MACHINE_DECL2OP(DECLOP, LONG_DECREMENT_MORE_JUMP) \
+	MACHINE_DECL2OP(DECLOP, LONG_DECREMENT_MORE_EQUAL_JUMP) \
+	MACHINE_DECL3OP(DECLOP, LOAD_ALLOC_LONG_ADD) \
+	MACHINE_DECL3OP(DECLOP, LOAD_ALLOC_FLOAT_ADD) \
+	DECLOP(CALL_DIRECT) \
+	DECLOP(TAIL_CALL) \
+	MACHINE_DECL3OP(DECLOP, LOAD_ALLOC_UNCHECKED) \
+	MACHINE_DECL3OP(DECLOP, STORE_ALLOC_UNCHECKED) \
+	MACHINE_DECL2OP(DECLOP, LOAD_ALLOC_I_INIT) \
+	MACHINE_DECL2OP(DECLOP, STORE_ALLOC_I_INIT) \
+	MACHINE_DECL1OP(DECLOP, ALLOC_I_INIT) \
+	MACHINE_DECL1OP(DECLOP, CONF_INIT_ALL)
+
+#define DECLOP(OPCODE) MACHINE_OP_CODE_##OPCODE,
 typedef enum machine_op_code {
-	MACHINE_OP_CODE_ABORT,
-	DECL3OP(FOREIGN),
-	DECL2OP(MOVE),
-	MACHINE_OP_CODE_SET_L,
-	MACHINE_OP_CODE_POP_ATOM_TYPESIGS,
-	MACHINE_OP_CODE_JUMP,
-	DECL1OP(JUMP_CHECK),
-	DECL1OP(CALL),
-	MACHINE_OP_CODE_RETURN,
-	MACHINE_OP_CODE_STACK_VALIDATE,
-	DECL1OP(LABEL),
-	DECL3OP(LOAD_ALLOC),
-	DECL2OP(LOAD_ALLOC_I),
-	DECL2OP(LOAD_ALLOC_I_BOUND),
-	DECL3OP(STORE_ALLOC),
-	DECL2OP(STORE_ALLOC_I),
-	DECL2OP(STORE_ALLOC_I_BOUND),
-	DECL1OP(CONF_TRACE),
-	MACHINE_OP_CODE_DYNAMIC_CONF_LL,
-	MACHINE_OP_CODE_DYNAMIC_CONF_ALL_LL,
-	MACHINE_OP_CODE_STACK_OFFSET,
-	MACHINE_OP_CODE_STACK_DEOFFSET,
-	DECL2OP(ALLOC),
-	DECL1OP(ALLOC_I),
-	DECL1OP(FREE),
-	MACHINE_OP_CODE_DYNAMIC_FREE_LL,
-	MACHINE_OP_CODE_GC_NEW_FRAME,
-	DECL1OP(GC_TRACE),
-	MACHINE_OP_CODE_DYNAMIC_TRACE_LL,
-	MACHINE_OP_CODE_GC_CLEAN,
-	DECL3OP(AND),
-	DECL3OP(OR),
-	DECL2OP(NOT),
-	DECL2OP(LENGTH),
-	DECL3OP(PTR_EQUAL),
-	DECL3OP(BOOL_EQUAL),
-	DECL3OP(CHAR_EQUAL),
-	DECL3OP(LONG_EQUAL),
-	DECL3OP(FLOAT_EQUAL),
-	DECL3OP(LONG_MORE),
-	DECL3OP(LONG_LESS),
-	DECL3OP(LONG_MORE_EQUAL),
-	DECL3OP(LONG_LESS_EQUAL),
-	DECL3OP(LONG_ADD),
-	DECL3OP(LONG_SUBTRACT),
-	DECL3OP(LONG_MULTIPLY),
-	DECL3OP(LONG_DIVIDE),
-	DECL3OP(LONG_MODULO),
-	DECL3OP(LONG_EXPONENTIATE),
-	DECL3OP(FLOAT_MORE),
-	DECL3OP(FLOAT_LESS),
-	DECL3OP(FLOAT_MORE_EQUAL),
-	DECL3OP(FLOAT_LESS_EQUAL),
-	DECL3OP(FLOAT_ADD),
-	DECL3OP(FLOAT_SUBTRACT),
-	DECL3OP(FLOAT_MULTIPLY),
-	DECL3OP(FLOAT_DIVIDE),
-	DECL3OP(FLOAT_MODULO),
-	DECL3OP(FLOAT_EXPONENTIATE),
-
-	DECL2OP(LONG_NEGATE),
-	DECL2OP(FLOAT_NEGATE),
-	DECL1OP(LONG_INCREMENT),
-	DECL1OP(LONG_DECREMENT),
-	DECL1OP(FLOAT_INCREMENT),
-	DECL1OP(FLOAT_DECREMENT),
-
-	DECL1OP(CONFIG_TYPESIG),
-	DECL2OP(RUNTIME_TYPECHECK),
-	DECL2OP(RUNTIME_TYPECAST),
-	DECL1OP(DYNAMIC_TYPECHECK_DD),
-	DECL1OP(DYNAMIC_TYPECHECK_DR),
-	DECL1OP(DYNAMIC_TYPECHECK_RD),
-	DECL1OP(DYNAMIC_TYPECAST_DD),
-	DECL1OP(DYNAMIC_TYPECAST_DR),
-	DECL1OP(DYNAMIC_TYPECAST_RD),
-
-	DECL2OP(TYPEGUARD_PROTECT_ARRAY),
-	DECL2OP(TYPEGUARD_PROTECT_TYPEARG_PROPERTY),
-	DECL2OP(TYPEGUARD_PROTECT_TYPEARG_PROPERTY_DOWNCAST),
-	DECL2OP(TYPEGUARD_PROTECT_SUB_PROPERTY),
-	DECL2OP(TYPEGUARD_PROTECT_SUB_PROPERTY_DOWNCAST),
-
-	MACHINE_OP_CODE_SET_EXTRA_ARGS
+	MACHINE_OP_CODES(DECLOP)
 } machine_op_code_t;
-#undef DECL1OP
-#undef DECL2OP
-#undef DECL3OP
+#undef DECLOP
 
 typedef struct machine_instruction {
 	machine_op_code_t op_code;
@@ -123,17 +153,64 @@ typedef enum gc_trace_mode {
 	GC_TRACE_MODE_SOME
 } gc_trace_mode_t;
 
-typedef struct machine_heap_alloc {
-	machine_reg_t* registers;
-	int* init_stat, *trace_stat;
-	uint16_t limit;
+//a large frame may be collected a slice at a time: its objects are marked from the roots it had when cleaned, swept, and finally unmarked
+typedef enum gc_phase {
+	GC_PHASE_IDLE,
+	GC_PHASE_MARK,
+	GC_PHASE_SWEEP,
+	GC_PHASE_UNMARK
+} gc_phase_t;
+
+//pause times are counted in power of two buckets of microseconds, the first holding pauses under a microsecond
+#define MACHINE_GC_PAUSE_BUCKETS 24
+
+#define GC_STATS_SIZE_BUCKETS 16
+#define GC_STATS_DEPTH_BUCKETS 16
 
-	int gc_flag, reg_with_table, pre_freed;
-	gc_trace_mode_t trace_mode;
+//what the allocator and collector have done, gathered while a machine's gc_stats is set
+typedef struct machine_gc_stats {
+	uint64_t allocs_by_size[GC_STATS_SIZE_BUCKETS]; //allocations by register count: none, 1, 2-3, 4-7 and so on, the last bucket holding everything larger
+	uint64_t recycled_blocks, fresh_blocks; //blocks taken from a free list, and blocks carved from a slab or malloc'd
 
+	uint64_t cleans_by_depth[GC_STATS_DEPTH_BUCKETS]; //GC_CLEANs by the depth of the frame cleaned, from the top-level frame down, the last bucket holding everything deeper
+	uint64_t traced, swept, freed, survived; //objects marked from cleaned frames' roots, objects in the frames cleaned, and how many of those were freed or kept
+	uint32_t reset_high_water; //the most objects the reset stack has held
+
+	uint64_t collections, total_collection_ns, max_collection_ns; //wall time of each GC_CLEAN and incremental slice
+} machine_gc_stats_t;
+
+#define HEAP_ALLOC_GC_FLAG 1
+#define HEAP_ALLOC_REG_WITH_TABLE 2
+#define HEAP_ALLOC_PRE_FREED 4
+#define HEAP_ALLOC_RESIZED 8 //the registers were moved out of the block by a realloc
+#define HEAP_ALLOC_TRACE_BITS 16 //the block has room for trace bits
+#define HEAP_ALLOC_INIT_BITS 32 //the block has room for init bits
+#define HEAP_ALLOC_INC_MARK 64 //reached by the incremental collection in progress, which keeps it alive until the collection ends
+
+//a heap object is a single block: this header, then its registers, then, for GC_TRACE_MODE_SOME, a bitset of which ones hold references, then a bitset of which registers are initialized
+//objects the compiler proves are written before they're read carry no init bitset, and have a NULL init_stat
+typedef struct machine_heap_alloc {
+	machine_reg_t* registers;
+	uint64_t* init_stat;
 	machine_type_sig_t* type_sig;
+
+	uint32_t limit, capacity;
+	uint8_t flags, trace_mode, size_class; //size_class is 0 for blocks that come from malloc
 } heap_alloc_t;
 
+//blocks up to HEAP_SLAB_MAX_SIZE bytes are carved from per-machine slabs, in size classes HEAP_SLAB_GRANULE bytes apart
+#define HEAP_SLAB_GRANULE 16
+#define HEAP_SLAB_MAX_SIZE 512
+#define HEAP_SLAB_CLASSES (HEAP_SLAB_MAX_SIZE / HEAP_SLAB_GRANULE + 1)
+#define HEAP_SLAB_SIZE 65536
+
+#define HEAP_BIT_WORDS(COUNT) (((uint64_t)(COUNT) + 63) / 64)
+#define HEAP_BIT(BITS, INDEX) (((BITS)[(INDEX) / 64] >> ((INDEX) % 64)) & 1)
+#define HEAP_SET_BIT(BITS, INDEX) ((BITS)[(INDEX) / 64] |= UINT64_C(1) << ((INDEX) % 64))
+#define HEAP_ASSIGN_BIT(BITS, INDEX, BIT) ((BITS)[(INDEX) / 64] = ((BITS)[(INDEX) / 64] & ~(UINT64_C(1) << ((INDEX) % 64))) | ((uint64_t)((BIT) != 0) << ((INDEX) % 64)))
+#define HEAP_IS_INIT(ALLOC, INDEX) (!(ALLOC)->init_stat || HEAP_BIT((ALLOC)->init_stat, INDEX))
+#define HEAP_TRACE_STAT(ALLOC) ((uint64_t*)((ALLOC)->registers + (ALLOC)->capacity))
+
 typedef union machine_register {
 	heap_alloc_t* heap_alloc;
 	int64_t long_int;
@@ -149,10 +226,10 @@ typedef struct machine {
 	machine_ins_t** positions;
 
 	heap_alloc_t** heap_allocs;
-	uint16_t* heap_frame_bounds;
+	uint32_t* heap_frame_bounds;
 
 	heap_alloc_t** heap_traces;
-	uint16_t* trace_frame_bounds;
+	uint32_t* trace_frame_bounds;
 	heap_alloc_t** reset_stack;
 
 	heap_alloc_t** freed_heap_allocs;
@@ -160,8 +237,8 @@ typedef struct machine {
 	uint64_t last_err_ip;
 	error_t last_err;
 	
-	uint16_t global_offset, position_count, heap_frame, frame_limit, 
-		heap_count, alloced_heap_allocs, 
+	uint32_t global_offset, position_count, heap_frame, frame_limit, max_frame_limit;
+	uint32_t heap_count, alloced_heap_allocs, 
 		trace_count, alloced_trace_allocs, 
 		freed_heap_count, alloc_freed_heaps, 
 		reset_count, alloced_reset;
@@ -174,19 +251,62 @@ typedef struct machine {
 	machine_type_sig_t* defined_signatures;
 	uint16_t defined_sig_count, alloced_sig_defs;
 
+	machine_gc_stats_t* gc_stats; //NULL unless statistics are being gathered, embedders may read it through cish.h
+
 #ifdef CISH_PAUSABLE
 	int halt_flag, halted;
 #endif // CISH_PAUSABLE
 
+#ifdef CISH_COUNT_DISPATCHES
+	uint64_t dispatch_count;
+#endif // CISH_COUNT_DISPATCHES
+
 	uint16_t extra_a, extra_b, extra_c;
-	uint16_t stack_size;
+	uint32_t stack_size, max_stack_size;
+
+	//freed slab blocks of each size class, linked through their registers pointer
+	heap_alloc_t* slab_free[HEAP_SLAB_CLASSES];
+	char* slab_top, *slab_end;
+	void* slabs; //every slab starts with a link to the one allocated before it
+
+	//where the current slab's bump pointer stood when each gc frame opened, and how far up its blocks have been put on free lists
+	char** region_marks;
+	char* slab_freed_top;
+
+	//objects still to be visited by the traversals that trace and free the heap
+	heap_alloc_t** mark_stack;
+	uint32_t mark_count, alloced_marks;
+	void* mark_pool; //the parallel markers' stacks, kept between cleans
+	uint16_t gc_threads; //markers used to trace a large frame, 1 traces on the calling thread only
+	void* reclaimer; //frees what dead objects owned on a helper thread when set, see reclaim.c
+	void* typesigs; //interned type signatures, see typesig.c
+
+	//the deferred frame's objects are heap_allocs[inc_start..inc_end), and the sweep moves the survivors down to inc_write
+	heap_alloc_t** inc_marked;
+	uint32_t inc_start, inc_end, inc_cursor, inc_write, inc_marked_count, alloced_inc_marked;
+	uint32_t gc_slice; //objects visited per slice of an incremental collection, 0 collects every frame at once
+	uint8_t gc_phase;
+
+	int record_pauses;
+	uint64_t gc_pauses[MACHINE_GC_PAUSE_BUCKETS];
+	uint64_t max_gc_pause;
 } machine_t;
 
-int init_machine(machine_t* machine, uint16_t stack_size, uint16_t frame_limit, uint16_t type_count);
+int init_machine(machine_t* machine, uint32_t max_stack_size, uint32_t max_frame_limit, uint16_t type_count);
 void free_machine(machine_t* machine);
 
+//commit enough of the reserved stack to hold required_size registers, or raise a stack overflow past max_stack_size
+int machine_grow_stack(machine_t* machine, uint64_t required_size);
+//double the call positions and gc frame bounds, or raise a stack overflow past max_frame_limit
+int machine_grow_frames(machine_t* machine);
+
 int machine_execute(machine_t* machine, machine_ins_t* instructions, machine_ins_t* continue_instructions, int first_run);
+//runs body on a native stack with room for max_frame_limit calls of frame_size bytes each, so code that makes a native call per Cish call overflows the call limit rather than the native stack
+int machine_run_native(machine_t* machine, uint64_t frame_size, int (*body)(machine_t* machine, void* arg), void* arg);
 
-heap_alloc_t* machine_alloc(machine_t* machine, uint16_t req_size, gc_trace_mode_t trace_mode);
-machine_type_sig_t* machine_get_typesig(machine_t* machine, machine_type_sig_t* t, int optimize_common);
+heap_alloc_t* machine_alloc(machine_t* machine, uint64_t req_size, gc_trace_mode_t trace_mode);
+//allocates an object without an init bitset, for one whose every register is written before it can be read
+heap_alloc_t* machine_alloc_initialized(machine_t* machine, uint64_t req_size, gc_trace_mode_t trace_mode);
+//defines a copy of a type signature, interned so that equal signatures share their sub types. optimize_common returns an equal signature that's already defined instead
+machine_type_sig_t* machine_get_typesig(machine_t* machine, const machine_type_sig_t* t, int optimize_common);
 #endif // !OPCODE_H
\ No newline at end of file
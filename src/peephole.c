@@ -0,0 +1,272 @@
+#include <stdlib.h>
+#include <string.h>
+#include "peephole.h"
+
+#define REGS_EQ(A, B) ((A).reg == (B).reg && (A).offset == (B).offset)
+
+typedef struct peephole {
+	compiler_ins_t* instructions;
+	uint16_t instruction_count;
+
+	uint8_t* removed;
+	uint8_t* is_target; //reached by a jump, label or call rather than only by falling through
+} peephole_t;
+
+//a pass looks at the window starting at a live instruction, and returns whether it changed anything
+typedef int (*peephole_pass_t)(peephole_t* peephole, uint16_t ip);
+
+//the operand holding the instruction an instruction transfers control to, or NULL
+static uint16_t* ins_target(compiler_ins_t* ins) {
+	switch (ins->op_code) {
+	case COMPILER_OP_CODE_JUMP:
+	case COMPILER_OP_CODE_CALL_DIRECT:
+	case COMPILER_OP_CODE_TAIL_CALL:
+		return &ins->regs[0].reg;
+	case COMPILER_OP_CODE_JUMP_CHECK:
+	case COMPILER_OP_CODE_LABEL:
+		return &ins->regs[1].reg;
+	default:
+		return NULL;
+	}
+}
+
+//the operand an instruction writes without any other effect, or -1
+static int pure_dest(compiler_ins_t ins) {
+	switch (ins.op_code) {
+	case COMPILER_OP_CODE_MOVE:
+	case COMPILER_OP_CODE_NOT:
+	case COMPILER_OP_CODE_LONG_NEGATE:
+	case COMPILER_OP_CODE_FLOAT_NEGATE:
+		return 0;
+	case COMPILER_OP_CODE_AND:
+	case COMPILER_OP_CODE_OR:
+	case COMPILER_OP_CODE_PTR_EQUAL:
+	case COMPILER_OP_CODE_BOOL_EQUAL:
+	case COMPILER_OP_CODE_CHAR_EQUAL:
+	case COMPILER_OP_CODE_LONG_EQUAL:
+	case COMPILER_OP_CODE_FLOAT_EQUAL:
+	case COMPILER_OP_CODE_LONG_MORE:
+	case COMPILER_OP_CODE_LONG_LESS:
+	case COMPILER_OP_CODE_LONG_MORE_EQUAL:
+	case COMPILER_OP_CODE_LONG_LESS_EQUAL:
+	case COMPILER_OP_CODE_LONG_ADD:
+	case COMPILER_OP_CODE_LONG_SUBTRACT:
+	case COMPILER_OP_CODE_LONG_MULTIPLY:
+	case COMPILER_OP_CODE_LONG_EXPONENTIATE:
+	case COMPILER_OP_CODE_FLOAT_MORE:
+	case COMPILER_OP_CODE_FLOAT_LESS:
+	case COMPILER_OP_CODE_FLOAT_MORE_EQUAL:
+	case COMPILER_OP_CODE_FLOAT_LESS_EQUAL:
+	case COMPILER_OP_CODE_FLOAT_ADD:
+	case COMPILER_OP_CODE_FLOAT_SUBTRACT:
+	case COMPILER_OP_CODE_FLOAT_MULTIPLY:
+	case COMPILER_OP_CODE_FLOAT_DIVIDE:
+	case COMPILER_OP_CODE_FLOAT_MODULO:
+	case COMPILER_OP_CODE_FLOAT_EXPONENTIATE:
+		return 2; //long division and modulo trap on zero, so they aren't pure
+	default:
+		return -1;
+	}
+}
+
+static int pure_reads(compiler_ins_t ins, int dest, compiler_reg_t reg) {
+	if (dest == 0)
+		return REGS_EQ(ins.regs[1], reg);
+	return REGS_EQ(ins.regs[0], reg) || REGS_EQ(ins.regs[1], reg);
+}
+
+static uint16_t next_live(peephole_t* peephole, uint16_t ip) {
+	while (ip < peephole->instruction_count && peephole->removed[ip])
+		ip++;
+	return ip;
+}
+
+static void remove_ins(peephole_t* peephole, uint16_t ip) {
+	peephole->removed[ip] = 1;
+	if (peephole->is_target[ip])
+		peephole->is_target[next_live(peephole, ip)] = 1;
+}
+
+static void mark_targets(peephole_t* peephole) {
+	memset(peephole->is_target, 0, peephole->instruction_count + 1);
+	peephole->is_target[0] = 1;
+	for (uint16_t ip = next_live(peephole, 0); ip < peephole->instruction_count; ip = next_live(peephole, ip + 1)) {
+		uint16_t* target = ins_target(&peephole->instructions[ip]);
+		if (target)
+			peephole->is_target[next_live(peephole, *target)] = 1;
+	}
+}
+
+//jumps that land on another jump go straight to its destination, and jumps that land on a return become one
+//conditional exits are left alone, so counted loops keep the layout their superinstructions expect
+static int thread_jump(peephole_t* peephole, uint16_t ip) {
+	compiler_ins_t* ins = &peephole->instructions[ip];
+	if (ins->op_code != COMPILER_OP_CODE_JUMP)
+		return 0;
+
+	uint16_t target = next_live(peephole, ins->regs[0].reg);
+	for (uint_fast16_t hops = 0; target < peephole->instruction_count && peephole->instructions[target].op_code == COMPILER_OP_CODE_JUMP && hops < peephole->instruction_count; hops++)
+		target = next_live(peephole, peephole->instructions[target].regs[0].reg);
+
+	if (target < peephole->instruction_count && peephole->instructions[target].op_code == COMPILER_OP_CODE_RETURN) {
+		*ins = peephole->instructions[target];
+		return 1;
+	}
+	if (target == ins->regs[0].reg)
+		return 0;
+	ins->regs[0].reg = target;
+	peephole->is_target[target] = 1;
+	return 1;
+}
+
+//jumps, taken or not, to the instruction that follows anyway
+static int remove_jump_to_next(peephole_t* peephole, uint16_t ip) {
+	compiler_ins_t* ins = &peephole->instructions[ip];
+	if (ins->op_code != COMPILER_OP_CODE_JUMP && ins->op_code != COMPILER_OP_CODE_JUMP_CHECK)
+		return 0;
+	if (next_live(peephole, *ins_target(ins)) != next_live(peephole, ip + 1))
+		return 0;
+	remove_ins(peephole, ip);
+	return 1;
+}
+
+//code after an unconditional transfer of control that nothing jumps to
+static int remove_unreachable(peephole_t* peephole, uint16_t ip) {
+	switch (peephole->instructions[ip].op_code) {
+	case COMPILER_OP_CODE_JUMP:
+	case COMPILER_OP_CODE_RETURN:
+	case COMPILER_OP_CODE_ABORT:
+	case COMPILER_OP_CODE_TAIL_CALL:
+		break;
+	default:
+		return 0;
+	}
+
+	int changes_made = 0;
+	for (uint16_t next = next_live(peephole, ip + 1); next < peephole->instruction_count && !peephole->is_target[next]; next = next_live(peephole, next + 1)) {
+		peephole->removed[next] = 1;
+		changes_made = 1;
+	}
+	return changes_made;
+}
+
+static int remove_self_move(peephole_t* peephole, uint16_t ip) {
+	compiler_ins_t* ins = &peephole->instructions[ip];
+	if (ins->op_code != COMPILER_OP_CODE_MOVE || !REGS_EQ(ins->regs[0], ins->regs[1]))
+		return 0;
+	remove_ins(peephole, ip);
+	return 1;
+}
+
+//a pure result that's only moved out of a dead temporary is written straight to the move's destination
+static int forward_temp(peephole_t* peephole, uint16_t ip) {
+	compiler_ins_t* ins = &peephole->instructions[ip];
+	int dest = pure_dest(*ins);
+	if (dest < 0)
+		return 0;
+
+	uint16_t next = next_live(peephole, ip + 1);
+	if (next == peephole->instruction_count || peephole->is_target[next])
+		return 0;
+	compiler_ins_t* move = &peephole->instructions[next];
+	if (move->op_code != COMPILER_OP_CODE_MOVE || !(move->dead_regs & 2) || !REGS_EQ(move->regs[1], ins->regs[dest]))
+		return 0;
+
+	ins->regs[dest] = move->regs[0];
+	remove_ins(peephole, next);
+	return 1;
+}
+
+//a pure write that the next instruction overwrites without reading
+static int remove_dead_store(peephole_t* peephole, uint16_t ip) {
+	compiler_ins_t* ins = &peephole->instructions[ip];
+	int dest = pure_dest(*ins);
+	if (dest < 0)
+		return 0;
+
+	uint16_t next = next_live(peephole, ip + 1);
+	if (next == peephole->instruction_count)
+		return 0;
+	compiler_ins_t overwrite = peephole->instructions[next];
+	int overwrite_dest = pure_dest(overwrite);
+	if (overwrite_dest < 0 || !REGS_EQ(overwrite.regs[overwrite_dest], ins->regs[dest]) || pure_reads(overwrite, overwrite_dest, ins->regs[dest]))
+		return 0;
+
+	remove_ins(peephole, ip);
+	return 1;
+}
+
+//stack offsets the next instruction undoes
+static int remove_offset_pair(peephole_t* peephole, uint16_t ip) {
+	if (peephole->instructions[ip].op_code != COMPILER_OP_CODE_STACK_OFFSET)
+		return 0;
+
+	uint16_t next = next_live(peephole, ip + 1);
+	if (next == peephole->instruction_count || peephole->is_target[next] || peephole->instructions[next].op_code != COMPILER_OP_CODE_STACK_DEOFFSET || peephole->instructions[next].regs[0].reg != peephole->instructions[ip].regs[0].reg)
+		return 0;
+
+	remove_ins(peephole, ip);
+	remove_ins(peephole, next);
+	return 1;
+}
+
+static const peephole_pass_t peephole_passes[] = {
+	thread_jump,
+	remove_jump_to_next,
+	remove_unreachable,
+	remove_self_move,
+	forward_temp,
+	remove_dead_store,
+	remove_offset_pair
+};
+
+int peephole_optimize(ins_builder_t* ins_builder, dbg_table_t* dbg_table) {
+	peephole_t peephole = {
+		.instructions = ins_builder->instructions,
+		.instruction_count = ins_builder->instruction_count
+	};
+	ESCAPE_ON_FAIL(peephole.removed = safe_calloc(ins_builder->safe_gc, peephole.instruction_count + 1, sizeof(uint8_t)));
+	ESCAPE_ON_FAIL(peephole.is_target = safe_malloc(ins_builder->safe_gc, (peephole.instruction_count + 1) * sizeof(uint8_t)));
+
+	int changes_made;
+	do {
+		changes_made = 0;
+		mark_targets(&peephole);
+		for (uint16_t ip = next_live(&peephole, 0); ip < peephole.instruction_count; ip = next_live(&peephole, ip + 1))
+			for (uint_fast8_t i = 0; i < sizeof(peephole_passes) / sizeof(peephole_pass_t) && !peephole.removed[ip]; i++)
+				if (peephole_passes[i](&peephole, ip))
+					changes_made = 1;
+	} while (changes_made);
+
+	//removed instructions map onto the next live one, which is where control flowing into them ends up
+	uint16_t* new_ips = safe_malloc(ins_builder->safe_gc, (peephole.instruction_count + 1) * sizeof(uint16_t));
+	ESCAPE_ON_FAIL(new_ips);
+	uint16_t live_count = 0;
+	for (uint_fast16_t ip = 0; ip <= peephole.instruction_count; ip++) {
+		new_ips[ip] = live_count;
+		if (ip < peephole.instruction_count && !peephole.removed[ip])
+			live_count++;
+	}
+
+	for (uint_fast16_t ip = 0; ip < peephole.instruction_count; ip++) {
+		if (peephole.removed[ip])
+			continue;
+		uint16_t* target = ins_target(&peephole.instructions[ip]);
+		if (target)
+			*target = new_ips[*target];
+		peephole.instructions[new_ips[ip]] = peephole.instructions[ip];
+	}
+	ins_builder->instruction_count = live_count;
+
+	for (uint_fast64_t i = 0; i < dbg_table->src_loc_count; i++) {
+		if (dbg_table->src_locations[i].min_ip <= peephole.instruction_count)
+			dbg_table->src_locations[i].min_ip = new_ips[dbg_table->src_locations[i].min_ip];
+		if (dbg_table->src_locations[i].max_ip <= peephole.instruction_count)
+			dbg_table->src_locations[i].max_ip = new_ips[dbg_table->src_locations[i].max_ip];
+	}
+
+	safe_free(ins_builder->safe_gc, peephole.removed);
+	safe_free(ins_builder->safe_gc, peephole.is_target);
+	safe_free(ins_builder->safe_gc, new_ips);
+	return 1;
+}
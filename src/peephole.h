@@ -0,0 +1,12 @@
+#pragma once
+
+#ifndef PEEPHOLE_H
+#define PEEPHOLE_H
+
+#include "compiler.h"
+#include "debug.h"
+
+//rewrites and removes redundant instructions in place, then compacts the builder, remapping jump targets and debug ranges
+int peephole_optimize(ins_builder_t* ins_builder, dbg_table_t* dbg_table);
+
+#endif // !PEEPHOLE_H
@@ -229,6 +229,9 @@ static int ast_postproc_value_affects_state(int affects_state, ast_value_t* valu
 			CHECK_AFFECTS_STATE(1, &value->data.proc_call->arguments[i]);
 		break;
 	}
+	//once one operand forces evaluation, every sibling operand needs registers too
+	if (!affects_state && value->affects_state && (value->value_type == AST_VALUE_BINARY_OP || value->value_type == AST_VALUE_GET_INDEX || value->value_type == AST_VALUE_ALLOC_RECORD || value->value_type == AST_VALUE_ARRAY_LITERAL))
+		return ast_postproc_value_affects_state(1, value, second_pass) || changes_made;
 	return changes_made;
 }
 #undef CHECK_AFFECTS_STATE
@@ -271,6 +274,124 @@ static int ast_postproc_codeblock_affects_state(ast_code_block_t* code_block, in
 }
 #undef CHECK_AFFECTS_STATE
 
+//a local that's initialized to a new final record, and only ever has its properties read or written, can keep them in registers
+static int is_scalar_candidate(ast_parser_t* ast_parser, ast_var_info_t* var_info, ast_value_t set_value) {
+	if (var_info->is_global || !var_info->is_used || set_value.value_type != AST_VALUE_ALLOC_RECORD || set_value.data.alloc_record.proto->use_reqs != AST_RECORD_FINAL)
+		return 0;
+	if (var_info->type.type != TYPE_SUPER_RECORD || var_info->type.type_id != set_value.type.type_id)
+		return 0;
+
+	//every property needs a value from the start, since there's no init bit to check a register against
+	//default values are shared by every allocation that uses them, along with their registers, so only allocations that set everything themselves qualify
+	for (ast_record_proto_t* proto = set_value.data.alloc_record.proto;; proto = ast_parser->ast->record_protos[proto->base_record->type_id]) {
+		for (uint_fast8_t i = 0; i < proto->property_count; i++)
+			if (proto->properties[i].maybe_uninit)
+				return 0;
+		for (uint_fast16_t i = 0; i < proto->default_value_count; i++)
+			for (uint_fast16_t j = 0; j < set_value.data.alloc_record.init_value_count; j++)
+				if (set_value.data.alloc_record.init_values[j].value.id == proto->default_values[i].value.id)
+					return 0;
+		if (!proto->base_record)
+			return 1;
+	}
+}
+
+static void find_codeblock_escapes(ast_parser_t* ast_parser, ast_code_block_t* code_block, int in_proc);
+
+//any use of a variable other than as the record of a property access lets it escape
+static void find_value_escapes(ast_parser_t* ast_parser, ast_value_t* value, int in_proc) {
+	switch (value->value_type) {
+	case AST_VALUE_ALLOC_ARRAY:
+		find_value_escapes(ast_parser, &value->data.alloc_array->size, in_proc);
+		break;
+	case AST_VALUE_ALLOC_RECORD:
+		for (uint_fast16_t i = 0; i < value->data.alloc_record.init_value_count; i++)
+			find_value_escapes(ast_parser, &value->data.alloc_record.init_values[i].value, in_proc);
+		break;
+	case AST_VALUE_ARRAY_LITERAL:
+		for (uint_fast16_t i = 0; i < value->data.array_literal.element_count; i++)
+			find_value_escapes(ast_parser, &value->data.array_literal.elements[i], in_proc);
+		break;
+	case AST_VALUE_PROC:
+		find_codeblock_escapes(ast_parser, &value->data.procedure->exec_block, 1);
+		break;
+	case AST_VALUE_VAR:
+		value->data.variable->is_scalar_replaced = 0;
+		break;
+	case AST_VALUE_SET_VAR:
+		value->data.set_var->var_info->is_scalar_replaced = 0;
+		find_value_escapes(ast_parser, &value->data.set_var->set_value, in_proc);
+		break;
+	case AST_VALUE_SET_INDEX:
+		find_value_escapes(ast_parser, &value->data.set_index->array, in_proc);
+		find_value_escapes(ast_parser, &value->data.set_index->index, in_proc);
+		find_value_escapes(ast_parser, &value->data.set_index->value, in_proc);
+		break;
+	case AST_VALUE_SET_PROP:
+		//a typeguarded store checks the value against the type arguments of an allocated record
+		if (value->data.set_prop->record.value_type != AST_VALUE_VAR || ((value->data.set_prop->property->do_typeguard || value->data.set_prop->property->do_sub_typeguard) && (IS_REF_TYPE(value->data.set_prop->value.type) || value->data.set_prop->value.type.type == TYPE_TYPEARG)))
+			find_value_escapes(ast_parser, &value->data.set_prop->record, in_proc);
+		find_value_escapes(ast_parser, &value->data.set_prop->value, in_proc);
+		break;
+	case AST_VALUE_GET_INDEX:
+		find_value_escapes(ast_parser, &value->data.get_index->array, in_proc);
+		find_value_escapes(ast_parser, &value->data.get_index->index, in_proc);
+		break;
+	case AST_VALUE_GET_PROP:
+		if (value->data.get_prop->record.value_type != AST_VALUE_VAR)
+			find_value_escapes(ast_parser, &value->data.get_prop->record, in_proc);
+		break;
+	case AST_VALUE_BINARY_OP:
+		find_value_escapes(ast_parser, &value->data.binary_op->lhs, in_proc);
+		find_value_escapes(ast_parser, &value->data.binary_op->rhs, in_proc);
+		break;
+	case AST_VALUE_UNARY_OP:
+		find_value_escapes(ast_parser, &value->data.unary_op->operand, in_proc);
+		break;
+	case AST_VALUE_TYPE_OP:
+		find_value_escapes(ast_parser, &value->data.type_op->operand, in_proc);
+		break;
+	case AST_VALUE_PROC_CALL:
+		find_value_escapes(ast_parser, &value->data.proc_call->procedure, in_proc);
+		for (uint_fast8_t i = 0; i < value->data.proc_call->argument_count; i++)
+			find_value_escapes(ast_parser, &value->data.proc_call->arguments[i], in_proc);
+		break;
+	case AST_VALUE_FOREIGN:
+		find_value_escapes(ast_parser, &value->data.foreign->op_id, in_proc);
+		if (value->data.foreign->input)
+			find_value_escapes(ast_parser, value->data.foreign->input, in_proc);
+		break;
+	default:
+		break;
+	}
+}
+
+//a declaration is a candidate until a later use lets it escape, which is always the case for top level code
+static void find_codeblock_escapes(ast_parser_t* ast_parser, ast_code_block_t* code_block, int in_proc) {
+	for (ast_statement_t* current_statement = code_block->instructions; current_statement != &code_block->instructions[code_block->instruction_count]; current_statement++) {
+		switch (current_statement->type)
+		{
+		case AST_STATEMENT_DECL_VAR:
+			find_value_escapes(ast_parser, &current_statement->data.var_decl.set_value, in_proc);
+			current_statement->data.var_decl.var_info->is_scalar_replaced = in_proc && is_scalar_candidate(ast_parser, current_statement->data.var_decl.var_info, current_statement->data.var_decl.set_value);
+			break;
+		case AST_STATEMENT_COND:
+			for (ast_cond_t* current_cond = current_statement->data.conditional; current_cond; current_cond = current_cond->next_if_false) {
+				if (current_cond->condition)
+					find_value_escapes(ast_parser, current_cond->condition, in_proc);
+				find_codeblock_escapes(ast_parser, &current_cond->exec_block, in_proc);
+			}
+			break;
+		case AST_STATEMENT_VALUE:
+		case AST_STATEMENT_RETURN_VALUE:
+			find_value_escapes(ast_parser, &current_statement->data.value, in_proc);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
 static int ast_postproc_value(ast_parser_t* ast_parser, ast_value_t* value, postproc_trace_status_t* typearg_traces, postproc_gc_status_t* global_gc_stats, postproc_gc_status_t* local_gc_stats, int* shared_globals, int* shared_locals, uint16_t local_scope_size, postproc_parent_status_t parent_stat, ast_proc_t* parent_proc, int mutates_var);
 
 static int ast_postproc_code_block(ast_parser_t* ast_parser, ast_code_block_t* code_block, postproc_trace_status_t* trace_stats, postproc_gc_status_t* global_gc_stats, postproc_gc_status_t* local_gc_stats, uint16_t local_scope_size, int* shared_globals, int* shared_locals, int is_top_level, ast_proc_t* parent_proc) {
@@ -282,6 +403,21 @@ static int ast_postproc_code_block(ast_parser_t* ast_parser, ast_code_block_t* c
 			var_info->has_mutated = 0;
 
 			ast_value_t* set_value = &code_block->instructions[i].data.var_decl.set_value;
+			if (var_info->is_scalar_replaced) {
+				//the record itself is never allocated, so only the values of its properties need analysis
+				set_value->free_status = POSTPROC_FREE_NONE;
+				set_value->trace_status = POSTPROC_TRACE_NONE;
+				set_value->gc_status = POSTPROC_GC_LOCAL_ALLOC;
+				set_value->from_var = 0;
+				for (uint_fast16_t j = 0; j < set_value->data.alloc_record.init_value_count; j++) {
+					ESCAPE_ON_FAIL(ast_postproc_value(ast_parser, &set_value->data.alloc_record.init_values[j].value, trace_stats, global_gc_stats, local_gc_stats, shared_globals, shared_locals, local_scope_size, POSTPROC_PARENT_LOCAL, parent_proc, 0));
+					if (set_value->data.alloc_record.init_values[j].value.from_var)
+						set_value->from_var = 1;
+				}
+				local_gc_stats[SANITIZE_SCOPE_ID(*var_info)] = set_value->gc_status;
+				shared_locals[SANITIZE_SCOPE_ID(*var_info)] = set_value->from_var;
+				break;
+			}
 			ESCAPE_ON_FAIL(ast_postproc_value(ast_parser, set_value, trace_stats, is_top_level ? ast_parser->top_level_global_gc_stats : global_gc_stats, local_gc_stats, is_top_level ? ast_parser->shared_globals : shared_globals, shared_locals, local_scope_size, POSTPROC_PARENT_LOCAL, parent_proc, 0));
 			if (var_info->is_global) {
 				ast_parser->top_level_global_gc_stats[SANITIZE_SCOPE_ID(*var_info)] = set_value->gc_status;
@@ -798,6 +934,9 @@ int ast_postproc(ast_parser_t* ast_parser) {
 	//mark_code_block_no_affects_state(&ast_parser->ast->exec_block);
 	while (ast_postproc_codeblock_affects_state(&ast_parser->ast->exec_block, 0)) {}
 
+	//records that never leave the procedure allocating them are kept in registers, which also spares it a gc frame
+	find_codeblock_escapes(ast_parser, &ast_parser->ast->exec_block, 0);
+
 	//allocate memory used for analysis
 	PANIC_ON_FAIL(ast_parser->top_level_global_gc_stats = safe_malloc(ast_parser->safe_gc, ast_parser->global_count * sizeof(postproc_gc_status_t)), ast_parser, ERROR_MEMORY);
 	PANIC_ON_FAIL(ast_parser->global_gc_stats = safe_malloc(ast_parser->safe_gc, ast_parser->global_count * sizeof(postproc_gc_status_t)), ast_parser, ERROR_MEMORY);
@@ -0,0 +1,147 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include "reclaim.h"
+
+#ifdef CISH_PARALLEL_GC
+#include <pthread.h>
+
+typedef struct reclaim_batch {
+	void* blocks[RECLAIM_BATCH];
+	uint32_t count;
+} reclaim_batch_t;
+
+typedef struct reclaimer {
+	pthread_mutex_t lock;
+	pthread_cond_t wake;
+	pthread_t thread;
+
+	reclaim_batch_t* filling; //only ever touched by the collector
+
+	reclaim_batch_t* queue[RECLAIM_QUEUE];
+	uint32_t queue_head, queued;
+
+	//one batch filling, RECLAIM_QUEUE queued and one being freed
+	reclaim_batch_t* empty[RECLAIM_QUEUE + 2];
+	uint32_t empty_count;
+
+	int stopping;
+	reclaim_batch_t batches[RECLAIM_QUEUE + 2];
+} reclaimer_t;
+
+static void free_batch(reclaim_batch_t* batch) {
+	for (uint_fast32_t i = 0; i < batch->count; i++)
+		free(batch->blocks[i]);
+	batch->count = 0;
+}
+
+static void* run_reclaimer(void* arg) {
+	reclaimer_t* reclaimer = arg;
+	pthread_mutex_lock(&reclaimer->lock);
+	for (;;) {
+		while (!reclaimer->queued && !reclaimer->stopping)
+			pthread_cond_wait(&reclaimer->wake, &reclaimer->lock);
+		if (!reclaimer->queued)
+			break;
+		reclaim_batch_t* batch = reclaimer->queue[reclaimer->queue_head];
+		reclaimer->queue_head = (reclaimer->queue_head + 1) % RECLAIM_QUEUE;
+		reclaimer->queued--;
+		pthread_mutex_unlock(&reclaimer->lock);
+
+		free_batch(batch);
+
+		pthread_mutex_lock(&reclaimer->lock);
+		reclaimer->empty[reclaimer->empty_count++] = batch;
+	}
+	pthread_mutex_unlock(&reclaimer->lock);
+	return NULL;
+}
+
+int init_reclaimer(machine_t* machine) {
+	reclaimer_t* reclaimer;
+	PANIC_ON_FAIL(reclaimer = malloc(sizeof(reclaimer_t)), machine, ERROR_MEMORY);
+	reclaimer->queue_head = 0;
+	reclaimer->queued = 0;
+	reclaimer->stopping = 0;
+	reclaimer->filling = &reclaimer->batches[0];
+	reclaimer->batches[0].count = 0;
+	reclaimer->empty_count = 0;
+	for (uint_fast8_t i = 1; i < RECLAIM_QUEUE + 2; i++) {
+		reclaimer->batches[i].count = 0;
+		reclaimer->empty[reclaimer->empty_count++] = &reclaimer->batches[i];
+	}
+
+	if (pthread_mutex_init(&reclaimer->lock, NULL)) {
+		free(reclaimer);
+		PANIC(machine, ERROR_INTERNAL);
+	}
+	if (pthread_cond_init(&reclaimer->wake, NULL)) {
+		pthread_mutex_destroy(&reclaimer->lock);
+		free(reclaimer);
+		PANIC(machine, ERROR_INTERNAL);
+	}
+	if (pthread_create(&reclaimer->thread, NULL, run_reclaimer, reclaimer)) {
+		pthread_cond_destroy(&reclaimer->wake);
+		pthread_mutex_destroy(&reclaimer->lock);
+		free(reclaimer);
+		PANIC(machine, ERROR_INTERNAL);
+	}
+	machine->reclaimer = reclaimer;
+	return 1;
+}
+
+void free_reclaimer(machine_t* machine) {
+	reclaimer_t* reclaimer = machine->reclaimer;
+	if (!reclaimer)
+		return;
+	pthread_mutex_lock(&reclaimer->lock);
+	reclaimer->stopping = 1;
+	pthread_cond_signal(&reclaimer->wake);
+	pthread_mutex_unlock(&reclaimer->lock);
+	pthread_join(reclaimer->thread, NULL);
+
+	free_batch(reclaimer->filling);
+	pthread_cond_destroy(&reclaimer->wake);
+	pthread_mutex_destroy(&reclaimer->lock);
+	free(reclaimer);
+	machine->reclaimer = NULL;
+}
+
+//queues the filling batch, or frees it right away when the reclaimer is too far behind
+static void hand_off(reclaimer_t* reclaimer) {
+	pthread_mutex_lock(&reclaimer->lock);
+	if (reclaimer->queued == RECLAIM_QUEUE || !reclaimer->empty_count) {
+		pthread_mutex_unlock(&reclaimer->lock);
+		free_batch(reclaimer->filling);
+		return;
+	}
+	reclaimer->queue[(reclaimer->queue_head + reclaimer->queued++) % RECLAIM_QUEUE] = reclaimer->filling;
+	reclaimer->filling = reclaimer->empty[--reclaimer->empty_count];
+	pthread_cond_signal(&reclaimer->wake);
+	pthread_mutex_unlock(&reclaimer->lock);
+}
+
+static void reclaim(reclaimer_t* reclaimer, void* block) {
+	reclaimer->filling->blocks[reclaimer->filling->count++] = block;
+	if (reclaimer->filling->count == RECLAIM_BATCH)
+		hand_off(reclaimer);
+}
+
+void reclaim_block(machine_t* machine, void* block) {
+	if (machine->reclaimer)
+		reclaim(machine->reclaimer, block);
+	else
+		free(block);
+}
+#else
+int init_reclaimer(machine_t* machine) {
+	PANIC(machine, ERROR_INTERNAL);
+}
+
+void free_reclaimer(machine_t* machine) {
+
+}
+
+void reclaim_block(machine_t* machine, void* block) {
+	free(block);
+}
+#endif // CISH_PARALLEL_GC
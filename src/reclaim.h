@@ -0,0 +1,20 @@
+#pragma once
+
+#ifndef RECLAIM_H
+#define RECLAIM_H
+
+#include "machine.h"
+#include "gcmark.h"
+
+#define RECLAIM_BATCH 1024 //blocks handed to the reclaimer at once
+#define RECLAIM_QUEUE 64 //batches waiting for the reclaimer, once full the collector frees its own
+
+//starts a helper thread that frees what dead heap objects owned outside of their blocks, and the interned signatures a sweep drops
+int init_reclaimer(machine_t* machine);
+//frees everything still waiting, and stops the reclaimer
+void free_reclaimer(machine_t* machine);
+
+//frees a block, on the reclaimer if there's one
+void reclaim_block(machine_t* machine, void* block);
+
+#endif // !RECLAIM_H
@@ -9,12 +9,70 @@
 #include "stdlibf.h"
 #include "debug.h"
 #include "error.h"
+#include "jit.h"
+#include "aot.h"
+#include "gcmark.h"
+#include "reclaim.h"
 
 #define ABORT(MSG) {printf MSG ; exit(EXIT_FAILURE);}
 
 #define READ_ARG argv[current_arg++]
 #define EXPECT_FLAG(FLAG) if(current_arg == argc || strcmp(READ_ARG, FLAG)) { ABORT(("Unexpected flag, expected: %s\n", FLAG)); }
 
+static int execute(machine_t* machine, machine_ins_t* instructions, uint16_t instruction_count, int use_jit) {
+	if (!use_jit)
+		return machine_execute(machine, instructions, instructions, 1);
+
+	jit_t jit;
+	if (!init_jit(&jit, instructions, instruction_count, machine->gc_slice != 0))
+		ABORT(("JIT compilation failiure(%s).\n", get_err_msg(jit.last_err)));
+	int result = jit_execute(&jit, machine);
+	free_jit(&jit);
+	return result;
+}
+
+static void print_gc_pauses(machine_t* machine) {
+	fprintf(stderr, "GC pauses (max %" PRIu64 "us):\n", machine->max_gc_pause);
+	for (uint_fast8_t i = 0; i < MACHINE_GC_PAUSE_BUCKETS; i++)
+		if (machine->gc_pauses[i]) {
+			if (i)
+				fprintf(stderr, "  < %" PRIu64 "us: %" PRIu64 "\n", UINT64_C(1) << i, machine->gc_pauses[i]);
+			else
+				fprintf(stderr, "  < 1us: %" PRIu64 "\n", machine->gc_pauses[i]);
+		}
+}
+
+//prints the statistics as a table, then as a single line of JSON
+static void print_gc_stats(machine_gc_stats_t* stats) {
+	fprintf(stderr, "GC statistics:\n  allocations by register count:\n");
+	for (uint_fast8_t i = 0; i < GC_STATS_SIZE_BUCKETS; i++)
+		if (stats->allocs_by_size[i]) {
+			if (i < 2)
+				fprintf(stderr, "    %u: %" PRIu64 "\n", (unsigned)i, stats->allocs_by_size[i]);
+			else if (i == GC_STATS_SIZE_BUCKETS - 1)
+				fprintf(stderr, "    >= %" PRIu64 ": %" PRIu64 "\n", UINT64_C(1) << (i - 1), stats->allocs_by_size[i]);
+			else
+				fprintf(stderr, "    %" PRIu64 "-%" PRIu64 ": %" PRIu64 "\n", UINT64_C(1) << (i - 1), (UINT64_C(1) << i) - 1, stats->allocs_by_size[i]);
+		}
+	fprintf(stderr, "  blocks: %" PRIu64 " recycled, %" PRIu64 " fresh\n", stats->recycled_blocks, stats->fresh_blocks);
+	fprintf(stderr, "  cleans by frame depth:\n");
+	for (uint_fast8_t i = 0; i < GC_STATS_DEPTH_BUCKETS; i++)
+		if (stats->cleans_by_depth[i])
+			fprintf(stderr, "    %s%u: %" PRIu64 "\n", i == GC_STATS_DEPTH_BUCKETS - 1 ? ">= " : "", (unsigned)i + 1, stats->cleans_by_depth[i]);
+	fprintf(stderr, "  objects: %" PRIu64 " traced, %" PRIu64 " swept, %" PRIu64 " freed, %" PRIu64 " survived\n", stats->traced, stats->swept, stats->freed, stats->survived);
+	fprintf(stderr, "  reset stack high-water: %" PRIu32 "\n", stats->reset_high_water);
+	fprintf(stderr, "  collections: %" PRIu64 ", %" PRIu64 "us total, %" PRIu64 "us max\n", stats->collections, stats->total_collection_ns / 1000, stats->max_collection_ns / 1000);
+
+	fprintf(stderr, "{\"allocs_by_size\":[");
+	for (uint_fast8_t i = 0; i < GC_STATS_SIZE_BUCKETS; i++)
+		fprintf(stderr, i ? ",%" PRIu64 : "%" PRIu64, stats->allocs_by_size[i]);
+	fprintf(stderr, "],\"recycled_blocks\":%" PRIu64 ",\"fresh_blocks\":%" PRIu64 ",\"cleans_by_depth\":[", stats->recycled_blocks, stats->fresh_blocks);
+	for (uint_fast8_t i = 0; i < GC_STATS_DEPTH_BUCKETS; i++)
+		fprintf(stderr, i ? ",%" PRIu64 : "%" PRIu64, stats->cleans_by_depth[i]);
+	fprintf(stderr, "],\"traced\":%" PRIu64 ",\"swept\":%" PRIu64 ",\"freed\":%" PRIu64 ",\"survived\":%" PRIu64 ",\"reset_high_water\":%" PRIu32 ",\"collections\":%" PRIu64 ",\"total_collection_ns\":%" PRIu64 ",\"max_collection_ns\":%" PRIu64 "}\n",
+		stats->traced, stats->swept, stats->freed, stats->survived, stats->reset_high_water, stats->collections, stats->total_collection_ns, stats->max_collection_ns);
+}
+
 int main(int argc, char* argv[]) {
 	int current_arg = 0;
 
@@ -24,7 +82,74 @@ int main(int argc, char* argv[]) {
 		ABORT(("Expected an operation flag/argument.\n"));
 	const char* op_flag = READ_ARG;
 
-	if (!strcmp(op_flag, "-cr") || !strcmp(op_flag, "-c") || !strcmp(op_flag, "-cd")) {
+	//options may follow the operation flag in any position, and are removed before the rest are read
+	int inline_procs = 1;
+	uint32_t max_stack_size = MACHINE_DEFAULT_STACK_SIZE;
+	uint32_t max_frame_limit = MACHINE_DEFAULT_FRAME_LIMIT;
+	uint32_t gc_slice = 0;
+	uint16_t gc_threads = 1;
+	int record_pauses = 0;
+	int background_free = 0;
+	int gc_stats = 0;
+	for (int i = current_arg; i < argc; i++) {
+		int option_args = 1;
+		if (!strcmp(argv[i], "-noinline"))
+			inline_procs = 0;
+		else if (!strcmp(argv[i], "-stack") || !strcmp(argv[i], "-depth")) {
+			char* end;
+			unsigned long limit;
+			if (i + 1 == argc || !(limit = strtoul(argv[i + 1], &end, 10)) || *end || limit > UINT32_MAX)
+				ABORT(("Expected a positive limit after %s.\n", argv[i]));
+			if (argv[i][1] == 's')
+				max_stack_size = limit;
+			else
+				max_frame_limit = limit;
+			option_args = 2;
+		}
+		else if (!strcmp(argv[i], "-gcslice")) {
+			char* end;
+			unsigned long slice;
+			if (i + 1 == argc || !(slice = strtoul(argv[i + 1], &end, 10)) || *end || slice > UINT32_MAX)
+				ABORT(("Expected a positive object count after %s.\n", argv[i]));
+			gc_slice = slice;
+			option_args = 2;
+		}
+		else if (!strcmp(argv[i], "-gcthreads")) {
+			char* end;
+			unsigned long threads;
+			if (i + 1 == argc || !(threads = strtoul(argv[i + 1], &end, 10)) || *end || threads > UINT16_MAX)
+				ABORT(("Expected a positive thread count after %s.\n", argv[i]));
+#ifndef CISH_PARALLEL_GC
+			if (threads > 1)
+				ABORT(("Parallel marking isn't supported on this platform.\n"));
+#endif // !CISH_PARALLEL_GC
+			gc_threads = threads;
+			option_args = 2;
+		}
+		else if (!strcmp(argv[i], "-gcpauses"))
+			record_pauses = 1;
+		else if (!strcmp(argv[i], "-gcstats"))
+			gc_stats = 1;
+		else if (!strcmp(argv[i], "-gcreclaim")) {
+#ifndef CISH_PARALLEL_GC
+			ABORT(("Background reclaiming isn't supported on this platform.\n"));
+#endif // !CISH_PARALLEL_GC
+			background_free = 1;
+		}
+		else
+			continue;
+		memmove(&argv[i], &argv[i + option_args], (argc - i - option_args) * sizeof(char*));
+		argc -= option_args;
+		i--;
+	}
+
+	int use_jit = !strcmp(op_flag, "-crj") || !strcmp(op_flag, "-rj");
+#ifndef CISH_JIT_SUPPORTED
+	if (use_jit)
+		ABORT(("JIT compilation isn't supported on this platform.\n"));
+#endif // !CISH_JIT_SUPPORTED
+
+	if (!strcmp(op_flag, "-cr") || !strcmp(op_flag, "-crj") || !strcmp(op_flag, "-c") || !strcmp(op_flag, "-cc") || !strcmp(op_flag, "-cd")) {
 		safe_gc_t safe_gc;
 		dbg_table_t dbg_table;
 		if (!init_safe_gc(&safe_gc) || !init_debug_table(&dbg_table, &safe_gc))
@@ -46,7 +171,7 @@ int main(int argc, char* argv[]) {
 
 		machine_t machine;
 		compiler_t compiler;
-		if (!compile(&compiler, &safe_gc, &machine, &ast)) {
+		if (!compile(&compiler, &safe_gc, &machine, &ast, inline_procs, max_stack_size, max_frame_limit)) {
 			free_safe_gc(&safe_gc, 1);
 			ABORT(("Compilation failiure(%s).\n", get_err_msg(compiler.last_err)));
 		}
@@ -60,49 +185,85 @@ int main(int argc, char* argv[]) {
 		compiler_ins_to_machine_ins(compiler.ins_builder.instructions, machine_ins, compiler.ins_builder.instruction_count);
 		free_safe_gc(&safe_gc, 0);
 
-		if (!strcmp(op_flag, "-cr")) {
+		if (!strcmp(op_flag, "-cr") || use_jit) {
 			if (!install_stdlib(&machine))
 				ABORT(("Failed to install Cish standard native libraries.\n"));
-			if (!machine_execute(&machine, machine_ins, machine_ins, 1)) {
+			machine.gc_slice = gc_slice;
+			machine.gc_threads = gc_threads;
+			machine.record_pauses = record_pauses;
+			if (background_free && !init_reclaimer(&machine))
+				ABORT(("Failed to start the background reclaimer(%s).\n", get_err_msg(machine.last_err)));
+			if (gc_stats && !(machine.gc_stats = calloc(1, sizeof(machine_gc_stats_t))))
+				ABORT(("Failed to allocate gc statistics.\n"));
+			if (!execute(&machine, machine_ins, compiler.ins_builder.instruction_count, use_jit)) {
 				print_back_trace(&machine, &dbg_table, machine_ins);
 				printf("Last IP: %" PRIu64 "\n", machine.last_err_ip);
 				free_debug_table(&dbg_table);
 				free(machine_ins);
  				ABORT(("Runtime error(%s).\n", get_err_msg(machine.last_err)));
 			}
+#ifdef CISH_COUNT_DISPATCHES
+			fprintf(stderr, "Dispatches: %" PRIu64 "\n", machine.dispatch_count);
+#endif // CISH_COUNT_DISPATCHES
+			if (record_pauses)
+				print_gc_pauses(&machine);
+			if (gc_stats)
+				print_gc_stats(machine.gc_stats);
 		}
 		else if (!strcmp(op_flag, "-c")) {
 			EXPECT_FLAG("-o");
 			if (!file_save_compiled(READ_ARG, &ast, &machine, machine_ins, compiler.ins_builder.instruction_count))
 				ABORT(("Error saving compiled binaries.\n"));
 		}
-		else
+		else if (!strcmp(op_flag, "-cc")) {
+			EXPECT_FLAG("-o");
+			if (!aot_save_c(READ_ARG, &ast, &machine, &dbg_table, machine_ins, compiler.ins_builder.instruction_count))
+				ABORT(("Error saving C translation.\n"));
+		}
+		else {
 			print_instructions(machine_ins, compiler.ins_builder.instruction_count);
+			printf("Peephole: %" PRIu16 " -> %" PRIu16 " instruction(s).\n", compiler.unoptimized_ins_count, compiler.ins_builder.instruction_count);
+			printf("Folded %" PRIu32 " constant value(s), pruned %" PRIu32 " dead branch(es).\n", ast.folded_values, ast.pruned_branches);
+			printf("Eliminated %" PRIu32 " of %" PRIu32 " array bounds check(s).\n", compiler.eliminated_bounds_checks, compiler.bounds_checks);
+			printf("Eliminated %" PRIu32 " of %" PRIu32 " record allocation(s).\n", compiler.eliminated_record_allocs, compiler.record_allocs);
+			printf("Defined %" PRIu16 " type signature(s).\n", machine.defined_sig_count);
+		}
 
 		free_debug_table(&dbg_table);
 		free_machine(&machine);
 		free(machine_ins);
 	}
-	else if (!strcmp(op_flag, "-r") || !strcmp(op_flag, "-rd")) {
+	else if (!strcmp(op_flag, "-r") || !strcmp(op_flag, "-rj") || !strcmp(op_flag, "-rd")) {
 		machine_t machine;
 		uint16_t instruction_count;
 		EXPECT_FLAG("-s");
 		safe_gc_t safe_gc;
 		if (!init_safe_gc(&safe_gc))
 			ABORT(("Unable to initialize safe gc."));
-		machine_ins_t* instructions = file_load_ins(READ_ARG, &safe_gc, &machine, &instruction_count, NULL, NULL);
+		machine_ins_t* instructions = file_load_ins(READ_ARG, &safe_gc, &machine, max_stack_size, max_frame_limit, &instruction_count, NULL, NULL);
 		if (!instructions) {
 			free_safe_gc(&safe_gc, 1);
 			ABORT(("Unable to load binaries from file.\n"));
 		}
 		free_safe_gc(&safe_gc, 0);
-		if (!strcmp(op_flag, "-r")) {
+		if (!strcmp(op_flag, "-r") || use_jit) {
 			if (!install_stdlib(&machine))
 				ABORT(("Failed to install Cish standard native libraries.\n"));
-			if (!machine_execute(&machine, instructions, instructions, 1)) {
+			machine.gc_slice = gc_slice;
+			machine.gc_threads = gc_threads;
+			machine.record_pauses = record_pauses;
+			if (background_free && !init_reclaimer(&machine))
+				ABORT(("Failed to start the background reclaimer(%s).\n", get_err_msg(machine.last_err)));
+			if (gc_stats && !(machine.gc_stats = calloc(1, sizeof(machine_gc_stats_t))))
+				ABORT(("Failed to allocate gc statistics.\n"));
+			if (!execute(&machine, instructions, instruction_count, use_jit)) {
 				printf("Last IP: %" PRIu64 "\n", machine.last_err_ip);
 				ABORT(("Runtime error(%s).\n", get_err_msg(machine.last_err)))
 			}
+			if (record_pauses)
+				print_gc_pauses(&machine);
+			if (gc_stats)
+				print_gc_stats(machine.gc_stats);
 		}
 		else
 			print_instructions(instructions, instruction_count);
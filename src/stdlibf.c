@@ -22,7 +22,7 @@
 static char* read_str_from_heap_alloc(heap_alloc_t* heap_alloc) {
 	char* buffer = malloc(heap_alloc->limit + 1);
 	ESCAPE_ON_FAIL(buffer);
-	for (int i = 0; i < heap_alloc->limit; i++)
+	for (uint_fast32_t i = 0; i < heap_alloc->limit; i++)
 		buffer[i] = heap_alloc->registers[i].char_int;
 	buffer[heap_alloc->limit] = 0;
 	return buffer;
@@ -57,7 +57,7 @@ static int std_ftos(machine_t* machine, machine_reg_t* in, machine_reg_t* out) {
 
 	for (uint_fast8_t i = 0; i < len; i++) {
 		out->heap_alloc->registers[i].char_int = output[i];
-		out->heap_alloc->init_stat[i] = 1;
+		HEAP_SET_BIT(out->heap_alloc->init_stat, i);
 	}
 	return 1;
 }
@@ -84,7 +84,7 @@ static int std_itos(machine_t* machine, machine_reg_t* in, machine_reg_t* out) {
 
 	for (uint_fast8_t i = 0; i < len; i++) {
 		out->heap_alloc->registers[i].char_int = output[i];
-		out->heap_alloc->init_stat[i] = 1;
+		HEAP_SET_BIT(out->heap_alloc->init_stat, i);
 	}
 	return 1;
 }
@@ -165,10 +165,34 @@ static int std_realloc(machine_t* machine, machine_reg_t* in, machine_reg_t* out
 	if (alloc->trace_mode == GC_TRACE_MODE_SOME)
 		PANIC(machine, ERROR_INTERNAL); //cannot realloc non array object
 
-	PANIC_ON_FAIL(alloc->registers = realloc(alloc->registers, (alloc->limit + in->long_int) * sizeof(machine_reg_t)), machine, ERROR_MEMORY);
-	PANIC_ON_FAIL(alloc->init_stat = realloc(alloc->init_stat, (alloc->limit + in->long_int) * sizeof(int)), machine, ERROR_MEMORY);
-	memset(&alloc->init_stat[alloc->limit], 0, in->long_int * sizeof(int));
-	alloc->limit += in->long_int;
+	if (in->long_int < 0 || in->long_int > UINT32_MAX - alloc->limit)
+		PANIC(machine, ERROR_MEMORY);
+
+	uint32_t new_limit = alloc->limit + in->long_int;
+	if (new_limit > alloc->capacity) {
+		//the header can't move, so the registers leave the block for one of their own, with the init bits still right after them
+		size_t new_size = (size_t)new_limit * sizeof(machine_reg_t) + HEAP_BIT_WORDS(new_limit) * sizeof(uint64_t);
+		machine_reg_t* registers;
+		if (alloc->flags & HEAP_ALLOC_RESIZED) {
+			PANIC_ON_FAIL(registers = realloc(alloc->registers, new_size), machine, ERROR_MEMORY);
+			memmove(registers + new_limit, registers + alloc->capacity, HEAP_BIT_WORDS(alloc->limit) * sizeof(uint64_t));
+		}
+		else {
+			PANIC_ON_FAIL(registers = malloc(new_size), machine, ERROR_MEMORY);
+			memcpy(registers, alloc->registers, alloc->limit * sizeof(machine_reg_t));
+			memcpy(registers + new_limit, alloc->init_stat, HEAP_BIT_WORDS(alloc->limit) * sizeof(uint64_t));
+			alloc->flags |= HEAP_ALLOC_RESIZED;
+		}
+		alloc->registers = registers;
+		alloc->init_stat = (uint64_t*)(registers + new_limit);
+		alloc->capacity = new_limit;
+	}
+
+	//bits past the old limit may be left over from whatever used the block before
+	if (alloc->limit % 64)
+		alloc->init_stat[alloc->limit / 64] &= (UINT64_C(1) << (alloc->limit % 64)) - 1;
+	memset(&alloc->init_stat[HEAP_BIT_WORDS(alloc->limit)], 0, (HEAP_BIT_WORDS(new_limit) - HEAP_BIT_WORDS(alloc->limit)) * sizeof(uint64_t));
+	alloc->limit = new_limit;
 
 	return 1;
 }
@@ -187,9 +211,9 @@ static int std_calloc(machine_t* machine, machine_reg_t* in, machine_reg_t* out)
 	ESCAPE_ON_FAIL(out->heap_alloc = machine_alloc(machine, in->long_int, GC_TRACE_MODE_NONE));
 	out->heap_alloc->type_sig = &machine->defined_signatures[TYPE_PRIMITIVE_LONG - TYPE_PRIMITIVE_BOOL];
 
-	for (uint_fast16_t i = 0; i < out->heap_alloc->limit; i++) {
+	for (uint_fast32_t i = 0; i < out->heap_alloc->limit; i++) {
 		out->heap_alloc->registers[i].long_int = 0;
-		out->heap_alloc->init_stat[i] = 1;
+		HEAP_SET_BIT(out->heap_alloc->init_stat, i);
 	}
 	return 1;
 }
@@ -0,0 +1,227 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include "type.h"
+#include "reclaim.h"
+#include "typesig.h"
+
+#define TYPESIG_INITIAL_CAPACITY 64 //slots of either table, always a power of two
+#define TYPESIG_SWEEP_MIN 4096 //entries interned before the first sweep, and at least as many between later ones
+
+//an interned array of sub types, a signature with nothing below it keeps NULL instead
+typedef struct typesig_entry {
+	uint64_t hash;
+	uint8_t count, marked;
+	machine_type_sig_t sub_types[];
+} typesig_entry_t;
+
+#define ENTRY_OF(SUB_TYPES) ((typesig_entry_t*)((char*)(SUB_TYPES) - offsetof(typesig_entry_t, sub_types)))
+
+//both tables are open addressed and grow once they're half full
+typedef struct typesig_table {
+	typesig_entry_t** entries;
+	uint32_t entry_count, capacity, sweep_at;
+
+	uint32_t* defined; //indices of defined signatures plus one, 0 where a slot is empty
+	uint32_t defined_count, defined_capacity;
+} typesig_table_t;
+
+static uint64_t hash_sig(uint64_t hash, machine_type_sig_t sig) {
+	hash = (hash ^ sig.super_signature) * UINT64_C(0x100000001b3);
+	hash = (hash ^ sig.sub_type_count) * UINT64_C(0x100000001b3);
+	return (hash ^ (uint64_t)(uintptr_t)sig.sub_types) * UINT64_C(0x100000001b3);
+}
+
+//slots are picked by the low bits, which the multiplications alone leave poorly mixed
+static uint64_t finish_hash(uint64_t hash) {
+	hash ^= hash >> 33;
+	hash *= UINT64_C(0xff51afd7ed558ccd);
+	return hash ^ (hash >> 33);
+}
+
+static uint64_t hash_sigs(const machine_type_sig_t* sigs, uint8_t count) {
+	uint64_t hash = UINT64_C(0xcbf29ce484222325) ^ count;
+	for (uint_fast8_t i = 0; i < count; i++)
+		hash = hash_sig(hash, sigs[i]);
+	return finish_hash(hash);
+}
+
+static int sigs_eq(const machine_type_sig_t* a, const machine_type_sig_t* b, uint8_t count) {
+	for (uint_fast8_t i = 0; i < count; i++)
+		if (!TYPESIG_EQ(a[i], b[i]))
+			return 0;
+	return 1;
+}
+
+int init_typesig_table(machine_t* machine) {
+	typesig_table_t* table = malloc(sizeof(typesig_table_t));
+	ESCAPE_ON_FAIL(table);
+	table->entry_count = table->defined_count = 0;
+	table->capacity = table->defined_capacity = TYPESIG_INITIAL_CAPACITY;
+	table->sweep_at = TYPESIG_SWEEP_MIN;
+	table->entries = calloc(table->capacity, sizeof(typesig_entry_t*));
+	table->defined = calloc(table->defined_capacity, sizeof(uint32_t));
+	if (!table->entries || !table->defined) {
+		free(table->entries);
+		free(table->defined);
+		free(table);
+		return 0;
+	}
+	machine->typesigs = table;
+	return 1;
+}
+
+void free_typesig_table(machine_t* machine) {
+	typesig_table_t* table = machine->typesigs;
+	if (!table)
+		return;
+	for (uint_fast32_t i = 0; i < table->capacity; i++)
+		free(table->entries[i]);
+	free(table->entries);
+	free(table->defined);
+	free(table);
+	machine->typesigs = NULL;
+}
+
+static int grow_entries(typesig_table_t* table) {
+	uint32_t capacity = table->capacity * 2;
+	typesig_entry_t** entries = calloc(capacity, sizeof(typesig_entry_t*));
+	ESCAPE_ON_FAIL(entries);
+	for (uint_fast32_t i = 0; i < table->capacity; i++) {
+		if (!table->entries[i])
+			continue;
+		uint32_t slot = table->entries[i]->hash & (capacity - 1);
+		while (entries[slot])
+			slot = (slot + 1) & (capacity - 1);
+		entries[slot] = table->entries[i];
+	}
+	free(table->entries);
+	table->entries = entries;
+	table->capacity = capacity;
+	return 1;
+}
+
+machine_type_sig_t* typesig_intern(machine_t* machine, const machine_type_sig_t* sub_types, uint8_t count) {
+	typesig_table_t* table = machine->typesigs;
+	uint64_t hash = hash_sigs(sub_types, count);
+	uint32_t slot = hash & (table->capacity - 1);
+	for (typesig_entry_t* entry; (entry = table->entries[slot]); slot = (slot + 1) & (table->capacity - 1))
+		if (entry->hash == hash && entry->count == count && sigs_eq(entry->sub_types, sub_types, count))
+			return entry->sub_types;
+
+	if ((table->entry_count + 1) * 2 > table->capacity) {
+		PANIC_ON_FAIL(grow_entries(table), machine, ERROR_MEMORY);
+		slot = hash & (table->capacity - 1);
+		while (table->entries[slot])
+			slot = (slot + 1) & (table->capacity - 1);
+	}
+	typesig_entry_t* entry = malloc(sizeof(typesig_entry_t) + count * sizeof(machine_type_sig_t));
+	PANIC_ON_FAIL(entry, machine, ERROR_MEMORY);
+	entry->hash = hash;
+	entry->count = count;
+	entry->marked = 0;
+	memcpy(entry->sub_types, sub_types, count * sizeof(machine_type_sig_t));
+	table->entries[slot] = entry;
+	table->entry_count++;
+	return entry->sub_types;
+}
+
+int typesig_intern_tree(machine_t* machine, const machine_type_sig_t* sig, machine_type_sig_t* output) {
+	output->super_signature = sig->super_signature;
+	output->sub_type_count = sig->sub_type_count;
+	output->sub_types = NULL;
+	if (sig->super_signature != TYPE_TYPEARG && sig->sub_type_count) {
+		PANIC_ON_FAIL(sig->sub_type_count <= TYPE_MAX_SUBTYPES, machine, ERROR_INTERNAL);
+		machine_type_sig_t sub_types[TYPE_MAX_SUBTYPES];
+		for (uint_fast8_t i = 0; i < sig->sub_type_count; i++)
+			ESCAPE_ON_FAIL(typesig_intern_tree(machine, &sig->sub_types[i], &sub_types[i]));
+		ESCAPE_ON_FAIL(output->sub_types = typesig_intern(machine, sub_types, sig->sub_type_count));
+	}
+	return 1;
+}
+
+void typesig_mark(machine_type_sig_t sig) {
+	if (sig.super_signature != TYPE_TYPEARG && sig.sub_types)
+		typesig_mark_array(sig.sub_types);
+}
+
+void typesig_mark_array(machine_type_sig_t* sub_types) {
+	typesig_entry_t* entry = ENTRY_OF(sub_types);
+	if (entry->marked)
+		return;
+	entry->marked = 1;
+	for (uint_fast8_t i = 0; i < entry->count; i++)
+		typesig_mark(entry->sub_types[i]);
+}
+
+int typesig_should_sweep(machine_t* machine) {
+	typesig_table_t* table = machine->typesigs;
+	return table->entry_count >= table->sweep_at;
+}
+
+int typesig_sweep(machine_t* machine, uint32_t heap_count) {
+	typesig_table_t* table = machine->typesigs;
+	typesig_entry_t** entries = calloc(table->capacity, sizeof(typesig_entry_t*));
+	PANIC_ON_FAIL(entries, machine, ERROR_MEMORY);
+	uint32_t live = 0;
+	for (uint_fast32_t i = 0; i < table->capacity; i++) {
+		typesig_entry_t* entry = table->entries[i];
+		if (!entry)
+			continue;
+		if (!entry->marked) {
+			reclaim_block(machine, entry);
+			continue;
+		}
+		entry->marked = 0;
+		uint32_t slot = entry->hash & (table->capacity - 1);
+		while (entries[slot])
+			slot = (slot + 1) & (table->capacity - 1);
+		entries[slot] = entry;
+		live++;
+	}
+	free(table->entries);
+	table->entries = entries;
+	table->entry_count = live;
+	//each sweep visits every object, so sweeps grow further apart along with the heap
+	table->sweep_at = live * 2 + heap_count / 8 + TYPESIG_SWEEP_MIN;
+	return 1;
+}
+
+static uint64_t hash_defined(machine_type_sig_t sig) {
+	return finish_hash(hash_sig(UINT64_C(0xcbf29ce484222325), sig));
+}
+
+machine_type_sig_t* typesig_find_defined(machine_t* machine, machine_type_sig_t sig) {
+	typesig_table_t* table = machine->typesigs;
+	for (uint32_t slot = hash_defined(sig) & (table->defined_capacity - 1); table->defined[slot]; slot = (slot + 1) & (table->defined_capacity - 1))
+		if (TYPESIG_EQ(machine->defined_signatures[table->defined[slot] - 1], sig))
+			return &machine->defined_signatures[table->defined[slot] - 1];
+	return NULL;
+}
+
+static void insert_defined(machine_t* machine, uint32_t* defined, uint32_t capacity, uint16_t index) {
+	uint32_t slot = hash_defined(machine->defined_signatures[index]) & (capacity - 1);
+	while (defined[slot])
+		slot = (slot + 1) & (capacity - 1);
+	defined[slot] = index + 1;
+}
+
+int typesig_add_defined(machine_t* machine, uint16_t index) {
+	typesig_table_t* table = machine->typesigs;
+	if (typesig_find_defined(machine, machine->defined_signatures[index]))
+		return 1; //lookups keep finding the earlier one
+	if ((table->defined_count + 1) * 2 > table->defined_capacity) {
+		uint32_t capacity = table->defined_capacity * 2;
+		uint32_t* defined = calloc(capacity, sizeof(uint32_t));
+		PANIC_ON_FAIL(defined, machine, ERROR_MEMORY);
+		for (uint_fast32_t i = 0; i < table->defined_capacity; i++)
+			if (table->defined[i])
+				insert_defined(machine, defined, capacity, table->defined[i] - 1);
+		free(table->defined);
+		table->defined = defined;
+		table->defined_capacity = capacity;
+	}
+	insert_defined(machine, table->defined, table->defined_capacity, index);
+	table->defined_count++;
+	return 1;
+}
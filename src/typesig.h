@@ -0,0 +1,32 @@
+#pragma once
+
+#ifndef TYPESIG_H
+#define TYPESIG_H
+
+#include <stdint.h>
+#include "machine.h"
+
+//interned signatures share their sub types with every equal signature, so two of them are equal exactly when their fields are
+#define TYPESIG_EQ(A, B) ((A).super_signature == (B).super_signature && (A).sub_type_count == (B).sub_type_count && (A).sub_types == (B).sub_types)
+
+int init_typesig_table(machine_t* machine);
+void free_typesig_table(machine_t* machine);
+
+//the one copy of an array of interned signatures, which lives until a sweep finds nothing marking it
+machine_type_sig_t* typesig_intern(machine_t* machine, const machine_type_sig_t* sub_types, uint8_t count);
+//interns a signature along with everything below it, the original is left to whoever owns it
+int typesig_intern_tree(machine_t* machine, const machine_type_sig_t* sig, machine_type_sig_t* output);
+
+//keeps what's below a signature, or an interned array along with what's below it, through the next sweep
+void typesig_mark(machine_type_sig_t sig);
+void typesig_mark_array(machine_type_sig_t* sub_types);
+int typesig_should_sweep(machine_t* machine);
+//reclaims every entry left unmarked, and clears the marks of the rest
+int typesig_sweep(machine_t* machine, uint32_t heap_count);
+
+//a defined signature equal to an interned one, or NULL if there's none
+machine_type_sig_t* typesig_find_defined(machine_t* machine, machine_type_sig_t sig);
+//lets typesig_find_defined return the signature defined at index
+int typesig_add_defined(machine_t* machine, uint16_t index);
+
+#endif // !TYPESIG_H